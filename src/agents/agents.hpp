@@ -1,10 +1,21 @@
 #ifndef RANDOM_AGENT_H
 #define RANDOM_AGENT_H
 
+#include <atomic>
+#include <memory>
 #include <random>
+#include <thread>
+#include <vector>
 
 #include "bboard.hpp"
+#include "jobs.hpp"
+#include "belief.hpp"
 #include "strategy.hpp"
+#include "mcts.hpp"
+#include "transposition.hpp"
+#include "time_manager.hpp"
+#include "opening_book.hpp"
+#include "memo.hpp"
 
 namespace agents
 {
@@ -49,14 +60,81 @@ struct LazyAgent : bboard::Agent
 
 
 /**
- * @brief Selects Idle for every action
+ * Agents whose moves depend on more than the observation (e.g.
+ * on a history) implement this, so their act results can be
+ * memoized (see MemoAgent).
+ *
+ * @brief Exposes the internal state of an agent to memoization
+ */
+struct MemoState
+{
+    virtual ~MemoState() {}
+
+    /**
+     * @brief MemoKey Returns a hash of the internal state that
+     * influences the result of act
+     */
+    virtual uint64_t MemoKey() const = 0;
+
+    /**
+     * @brief Replay Applies the side effects act would have had,
+     * if it had returned the given move for the state
+     */
+    virtual void Replay(const bboard::State* state, bboard::Move move) = 0;
+};
+
+// capacity of the position history of the SimpleAgent
+const int SIMPLE_MAX_HISTORY = 8;
+
+/**
+ * @brief The SimpleAgentParams struct holds the tunable
+ * thresholds of the SimpleAgent. As a vector every parameter
+ * is normalized to [0, 1] (see Bounds), so optimizers can
+ * work on all of them alike.
  */
-struct SimpleAgent : bboard::Agent
+struct SimpleAgentParams
+{
+    static const int COUNT = 5;
+
+    int bombEnemyDistance = 2; // bomb if an enemy is this close
+    int bombWoodDistance = 1; // bomb if wood is this close
+    int chaseRadius = 7; // move towards enemies in this radius
+    int moveChoices = 2; // pick randomly among the best n safe moves
+    int historyLength = 4; // recently visited positions to avoid
+
+    /**
+     * @brief Bounds Returns the valid range of a parameter
+     */
+    static void Bounds(int index, int& min, int& max);
+
+    /**
+     * @brief ToVector Writes the normalized parameters
+     */
+    void ToVector(float* v) const;
+
+    /**
+     * @brief FromVector Reads normalized parameters (rounded
+     * and clamped to their bounds)
+     */
+    void FromVector(const float* v);
+};
+
+/**
+ * @brief Simple rule-based agent: flees from bombs, bombs
+ * enemies and wood, chases enemies and wanders around
+ */
+struct SimpleAgent : bboard::Agent, MemoState
 {
     std::mt19937_64 rng;
     std::uniform_int_distribution<int> intDist;
 
     SimpleAgent();
+    SimpleAgent(uint64_t seed);
+
+    //////////////
+    // Settings //
+    //////////////
+    SimpleAgentParams params;
 
     //////////////
     // Specific //
@@ -64,12 +142,167 @@ struct SimpleAgent : bboard::Agent
     int danger = 0;
     bboard::strategy::RMap r;
     bboard::FixedQueue<bboard::Move, bboard::MOVE_COUNT> moveQueue;
-    bboard::FixedQueue<bboard::Position, 4> recentPositions;
+    bboard::FixedQueue<bboard::Cell, SIMPLE_MAX_HISTORY> recentPositions;
 
     bboard::Move act(const bboard::State* state) override;
 
+    uint64_t MemoKey() const override;
+    void Replay(const bboard::State* state, bboard::Move move) override;
+
     void PrintDetailedInfo();
 };
+
+/**
+ * Wraps an agent and caches its moves by observation (hash of
+ * the state, the agent id and the MemoKey if the agent has an
+ * internal state). On a hit the wrapped agent is not asked,
+ * stateful agents only replay the side effects of the move.
+ * Only wrap agents whose moves are a function of that key, a
+ * sampling agent is frozen to its first answer. The cache can
+ * be shared between wrappers of the same kind of agent.
+ *
+ * @brief Memoizes the moves of an agent
+ */
+struct MemoAgent : bboard::Agent
+{
+    /**
+     * @param agent The wrapped agent (not owned)
+     * @param cache A shared cache or nullptr for a private one
+     */
+    MemoAgent(bboard::Agent* agent, MemoCache* cache = nullptr);
+
+    bboard::Agent* agent;
+    MemoCache* cache;
+    std::unique_ptr<MemoCache> ownCache;
+
+    //////////////
+    // Specific //
+    //////////////
+    uint64_t epoch = 0;
+    uint64_t lookups = 0;
+    uint64_t hits = 0;
+
+    bboard::Move act(const bboard::State* state) override;
+
+    /**
+     * @brief Invalidate Drops all cached moves of this wrapper
+     * (e.g. after the wrapped agent was reconfigured)
+     */
+    void Invalidate();
+
+    /**
+     * @brief HitRate Returns the fraction of act calls that
+     * were answered from the cache
+     */
+    float HitRate() const;
+};
+
+/**
+ * Information-set MCTS for fogged games. Each iteration samples
+ * a determinization from the belief state and descends a tree
+ * whose nodes are the agent's information sets (keyed by the
+ * hash of the observation history), so statistics are shared
+ * between all determinizations. Runs root-parallel on the shared
+ * job system: every search job uses its own tree (in its own
+ * arena), root statistics are summed up at the end. The trees are kept between moves (the
+ * subtree of the new observation is reused) and never exceed
+ * the memory budget, least recently visited subtrees are
+ * recycled when an arena runs full. Positions found in the opening
+ * book are not searched at all. With pondering enabled, background
+ * threads (not pool jobs, they have no time bound) keep searching below the chosen move (over the possible
+ * next observations) until the next act call, which then keeps
+ * only the subtree of the real observation. If a transposition table is set, all
+ * searches publish their node statistics there and new nodes are
+ * warm-started from it.
+ *
+ * @brief Searches with ISMCTS under fog of war
+ */
+struct ISMCTSAgent : bboard::Agent
+{
+    std::mt19937_64 rng;
+
+    ISMCTSAgent();
+    ~ISMCTSAgent();
+
+    //////////////
+    // Settings //
+    //////////////
+    int threads = 1;
+    int maxIterations = 1 << 20;
+    int timeBudget = 80; // ms
+    size_t memoryBudget = 32 << 20; // bytes, for all search trees
+    int rolloutDepth = 8;
+    float exploration = 1.4f;
+    bool ponder = false; // search while waiting for the next step
+
+    // consulted before searching, optional
+    const OpeningBook* book = nullptr;
+
+    // overrides timeBudget and maxIterations, optional
+    TimeManager* timeManager = nullptr;
+
+    // shared between threads (and agents), optional
+    TranspositionTable* table = nullptr;
+    int tablePriorVisits = 4;
+
+    //////////////
+    // Specific //
+    //////////////
+    bboard::BeliefState belief;
+    uint64_t historyKey = 0;
+    bboard::Move lastMove = bboard::Move::IDLE;
+    std::vector<NodeArena> arenas;
+    int lastIterations = 0;
+    int lastVisits[ACTION_COUNT] = {};
+    float lastValues[ACTION_COUNT] = {};
+
+    std::vector<std::thread> ponderers;
+    bool pondering = false;
+    std::vector<int> ponderIterations;
+    std::atomic<bool> stopPondering{false};
+    int lastPonderIterations = 0;
+
+    bboard::Move act(const bboard::State* state) override;
+
+    /**
+     * @brief StartPondering Searches below the last move on
+     * background threads (one per arena)
+     */
+    void StartPondering();
+
+    /**
+     * @brief StopPondering Stops and joins the background search.
+     * Does nothing if the agent is not pondering.
+     */
+    void StopPondering();
+};
+
+// positions the PlaygroundAgent avoids revisiting
+const int PLAYGROUND_HISTORY = 6;
+
+/**
+ * Decides exactly like the playground's SimpleAgent (search,
+ * fleeing, bombing, chasing and wandering in the same order),
+ * only the random numbers come from a different generator.
+ *
+ * @brief Port of the playground's SimpleAgent
+ */
+struct PlaygroundAgent : bboard::Agent
+{
+    std::mt19937_64 rng;
+
+    PlaygroundAgent();
+    PlaygroundAgent(uint64_t seed);
+
+    //////////////
+    // Specific //
+    //////////////
+    bboard::Move prevDirection = bboard::Move::IDLE;
+    bboard::FixedQueue<bboard::Cell, PLAYGROUND_HISTORY> recentPositions;
+
+    bboard::Move act(const bboard::State* state) override;
+};
+
 // more agents to be included?
 
 }
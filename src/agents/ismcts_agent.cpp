@@ -0,0 +1,407 @@
+#include <chrono>
+#include <thread>
+
+#include "bboard.hpp"
+#include "agents.hpp"
+#include "belief.hpp"
+#include "hash.hpp"
+
+using namespace bboard;
+
+namespace agents
+{
+
+typedef std::chrono::steady_clock Clock;
+
+// maximum depth of a tree descent
+const int MAX_TREE_DEPTH = 32;
+
+ISMCTSAgent::ISMCTSAgent()
+{
+    std::random_device rd;  // non explicit seed
+    rng = std::mt19937_64(rd());
+}
+
+ISMCTSAgent::~ISMCTSAgent()
+{
+    StopPondering();
+}
+
+/**
+ * @brief The SearchLimits struct tells a search thread when to stop
+ */
+struct SearchLimits
+{
+    Clock::time_point deadline;
+    int iterations;
+    const std::atomic<bool>* stop = nullptr;
+
+    // fixed action at the root (pondering), -1 means free choice
+    int rootAction = -1;
+};
+
+/**
+ * @brief InfoSetKey Returns the key of the information set that
+ * follows after a move and an observation
+ */
+inline uint64_t InfoSetKey(uint64_t key, int move, const State& obs)
+{
+    return HashCombine(HashCombine(key, uint64_t(move)), HashState(obs));
+}
+
+/**
+ * @brief Evaluate Scores a state from the view of an agent in [-1, 1]
+ */
+inline float Evaluate(const State& s, int agentID)
+{
+    if(s.agents[agentID].dead)
+    {
+        return -1.0f;
+    }
+    int deadEnemies = 0;
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        if(i != agentID && s.agents[i].dead)
+        {
+            deadEnemies++;
+        }
+    }
+    return float(deadEnemies) / (AGENT_COUNT - 1);
+}
+
+/**
+ * @brief Rollout Plays random non-bombing moves for all agents
+ * and evaluates the outcome
+ */
+float Rollout(State& s, int agentID, int depth, std::mt19937_64& rng)
+{
+    std::uniform_int_distribution<int> harmless(0, 4);
+    Move moves[AGENT_COUNT];
+    for(int d = 0; d < depth && !s.agents[agentID].dead && s.aliveAgents > 1; d++)
+    {
+        for(int i = 0; i < AGENT_COUNT; i++)
+        {
+            moves[i] = s.agents[i].dead ? Move::IDLE : Move(harmless(rng));
+        }
+        Step(&s, moves);
+        s.timeStep++;
+    }
+    return Evaluate(s, agentID);
+}
+
+/**
+ * @brief WarmStart Initializes a fresh node with the statistics
+ * another thread published in the transposition table
+ */
+inline void WarmStart(const ISMCTSAgent& me, Node& node)
+{
+    TTData d;
+    if(me.table && me.table->Probe(node.key, d) && d.visits > 0)
+    {
+        const int n = std::min(d.visits, me.tablePriorVisits);
+        node.n[d.move] += n;
+        node.w[d.move] += d.value * n;
+        node.visits += n;
+    }
+}
+
+/**
+ * @brief Publish Stores the statistics of a node in the
+ * transposition table (unless a better one is stored)
+ */
+inline void Publish(const ISMCTSAgent& me, const Node& node)
+{
+    TTData d;
+    if(me.table->Probe(node.key, d) && d.visits > node.visits)
+    {
+        return;
+    }
+    int best = 0;
+    float w = 0;
+    for(int a = 0; a < ACTION_COUNT; a++)
+    {
+        w += node.w[a];
+        if(node.n[a] > node.n[best]) best = a;
+    }
+    d.visits = node.visits;
+    d.value = node.visits > 0 ? w / node.visits : 0;
+    d.move = best;
+    me.table->Store(node.key, d);
+}
+
+/**
+ * @brief Search Runs ISMCTS iterations on a single tree until
+ * one of the limits is reached
+ * @return The amount of iterations done
+ */
+int Search(const ISMCTSAgent& me, NodeArena& arena, uint64_t seed,
+           const SearchLimits& limits)
+{
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> anyMove(0, ACTION_COUNT - 1);
+
+    State s, obs;
+    Move moves[AGENT_COUNT];
+    int path[MAX_TREE_DEPTH];
+    int actions[MAX_TREE_DEPTH];
+
+    const int root = arena.root;
+
+    int it = 0;
+    for(; it < limits.iterations; it++)
+    {
+        if((it & 15) == 0 && (Clock::now() >= limits.deadline
+                              || (limits.stop && limits.stop->load(std::memory_order_relaxed))))
+        {
+            break;
+        }
+
+        me.belief.Sample(s, rng);
+        arena.generation++;
+
+        // selection & expansion
+        int node = root;
+        int depth = 0;
+        bool terminal = false;
+        while(true)
+        {
+            const int a = node == root && limits.rootAction != -1
+                          ? limits.rootAction : SelectUCB(arena[node], me.exploration);
+            path[depth] = node;
+            actions[depth] = a;
+            depth++;
+            arena[node].lastVisit = arena.generation;
+
+            for(int i = 0; i < AGENT_COUNT; i++)
+            {
+                if(s.agents[i].dead)
+                    moves[i] = Move::IDLE;
+                else
+                    moves[i] = i == me.id ? Move(a) : Move(anyMove(rng));
+            }
+            Step(&s, moves);
+            s.timeStep++;
+
+            if(s.agents[me.id].dead || s.aliveAgents <= 1)
+            {
+                terminal = true;
+                break;
+            }
+            if(depth >= MAX_TREE_DEPTH)
+            {
+                break;
+            }
+
+            FogState(s, obs, me.id);
+            const uint64_t key = InfoSetKey(arena[node].key, a, obs);
+            const int child = FindChild(arena, node, a, key);
+            if(child == -1)
+            {
+                int c = AddChild(arena, node, a, key);
+                if(c == -1 && arena.Collect() > 0)
+                {
+                    // the path was just visited, so it survives
+                    c = AddChild(arena, node, a, key);
+                }
+                if(c != -1)
+                {
+                    WarmStart(me, arena[c]);
+                }
+                break;
+            }
+            node = child;
+        }
+
+        // simulation
+        const float value = terminal ? Evaluate(s, me.id)
+                            : Rollout(s, me.id, me.rolloutDepth, rng);
+
+        // backpropagation
+        for(int d = 0; d < depth; d++)
+        {
+            Node& n = arena[path[d]];
+            n.visits++;
+            n.n[actions[d]]++;
+            n.w[actions[d]] += value;
+
+            if(me.table)
+            {
+                Publish(me, n);
+            }
+        }
+    }
+    return it;
+}
+
+Move ISMCTSAgent::act(const State* state)
+{
+    const Clock::time_point start = Clock::now();
+
+    // the tree now contains the pondered subtrees
+    StopPondering();
+
+    if(state->timeStep == 0 || belief.agentID != id)
+    {
+        belief.Reset(id);
+        historyKey = 0;
+        lastMove = Move::IDLE;
+        for(NodeArena& a : arenas)
+        {
+            a.Clear();
+        }
+    }
+
+    State obs;
+    FogState(*state, obs, id);
+    belief.Update(obs);
+    historyKey = InfoSetKey(historyKey, int(lastMove), obs);
+
+    // plan on the observation, hidden agents and bombs must not
+    // change the budget
+    SearchBudget budget = {timeBudget, maxIterations};
+    if(timeManager)
+    {
+        budget = timeManager->Plan(obs, id);
+    }
+    SearchLimits limits;
+    limits.deadline = start + std::chrono::milliseconds(budget.milliseconds);
+    limits.iterations = budget.iterations;
+
+    const BookEntry* entry = book ? book->Find(BookKey(obs, id)) : nullptr;
+    if(entry)
+    {
+        for(int a = 0; a < ACTION_COUNT; a++)
+        {
+            lastVisits[a] = entry->visits[a];
+            lastValues[a] = 0;
+        }
+        lastValues[entry->move] = entry->value / 32767.0f;
+        lastIterations = 0;
+        for(NodeArena& a : arenas)
+        {
+            a.Clear();
+        }
+        lastMove = Move(entry->move);
+        return lastMove;
+    }
+
+    if(int(arenas.size()) != threads)
+    {
+        arenas.resize(threads);
+        for(NodeArena& a : arenas)
+        {
+            a.Init(NodeArena::CapacityFor(memoryBudget / threads));
+        }
+    }
+
+    // reuse the subtree of the current information set
+    for(NodeArena& a : arenas)
+    {
+        const int next = a.root == -1 ? -1 : FindChild(a, a.root, int(lastMove), historyKey);
+        if(next != -1)
+        {
+            a.Reroot(next);
+        }
+        else
+        {
+            a.Clear();
+            a.root = a.Allocate(historyKey, int(lastMove));
+            WarmStart(*this, a[a.root]);
+        }
+    }
+
+    if(table)
+    {
+        table->NewSearch();
+    }
+
+    // root parallelization
+    std::vector<int> iterations(threads, 0);
+    std::vector<uint64_t> seeds(threads);
+    for(uint64_t& seed : seeds)
+    {
+        seed = rng();
+    }
+    const Clock::time_point searchStart = Clock::now();
+    Jobs().ParallelFor(threads, threads, [&](int t)
+    {
+        iterations[t] = Search(*this, arenas[t], seeds[t], limits);
+    });
+    if(timeManager)
+    {
+        std::chrono::duration<double, std::milli> searchTime = Clock::now() - searchStart;
+        timeManager->Record(iterations[0], searchTime.count());
+    }
+
+    int n[ACTION_COUNT] = {};
+    float w[ACTION_COUNT] = {};
+    lastIterations = 0;
+    for(int t = 0; t < threads; t++)
+    {
+        const Node& root = arenas[t][arenas[t].root];
+        for(int a = 0; a < ACTION_COUNT; a++)
+        {
+            n[a] += root.n[a];
+            w[a] += root.w[a];
+        }
+        lastIterations += iterations[t];
+    }
+
+    int best = 0;
+    for(int a = 0; a < ACTION_COUNT; a++)
+    {
+        lastVisits[a] = n[a];
+        lastValues[a] = n[a] > 0 ? w[a] / n[a] : 0;
+        if(n[a] > n[best] || (n[a] == n[best] && n[a] > 0 && w[a] / n[a] > w[best] / n[best]))
+        {
+            best = a;
+        }
+    }
+    lastMove = Move(best);
+    if(ponder)
+    {
+        StartPondering();
+    }
+    return lastMove;
+}
+
+void ISMCTSAgent::StartPondering()
+{
+    StopPondering();
+    stopPondering.store(false, std::memory_order_relaxed);
+
+    SearchLimits limits;
+    limits.deadline = Clock::time_point::max();
+    limits.iterations = maxIterations;
+    limits.stop = &stopPondering;
+    limits.rootAction = int(lastMove);
+
+    ponderIterations.assign(arenas.size(), 0);
+    for(size_t t = 0; t < arenas.size(); t++)
+    {
+        ponderers.emplace_back([this, t, limits, seed = rng()]()
+        {
+            ponderIterations[t] = Search(*this, arenas[t], seed, limits);
+        });
+    }
+    pondering = true;
+}
+
+void ISMCTSAgent::StopPondering()
+{
+    if(!pondering)
+    {
+        return;
+    }
+    stopPondering.store(true, std::memory_order_relaxed);
+    lastPonderIterations = 0;
+    for(size_t t = 0; t < ponderers.size(); t++)
+    {
+        ponderers[t].join();
+        lastPonderIterations += ponderIterations[t];
+    }
+    ponderers.clear();
+    pondering = false;
+}
+
+}
@@ -0,0 +1,193 @@
+#include <vector>
+#include <algorithm>
+
+#include "bboard.hpp"
+#include "jobs.hpp"
+#include "hash.hpp"
+#include "league.hpp"
+
+using namespace bboard;
+
+namespace agents
+{
+
+//////////////////
+// OpponentPool //
+//////////////////
+
+int OpponentPool::Add(const std::string& name, const AgentFactory& make)
+{
+    const int i = count.load(std::memory_order_relaxed);
+    if(i >= MAX_POOL_SIZE)
+    {
+        return -1;
+    }
+    entries[i].name = name;
+    entries[i].make = make;
+    entries[i].games.store(0, std::memory_order_relaxed);
+    entries[i].points.store(0, std::memory_order_relaxed);
+
+    // publishes the entry to sampling threads
+    count.store(i + 1, std::memory_order_release);
+    return i;
+}
+
+int OpponentPool::Size() const
+{
+    return count.load(std::memory_order_acquire);
+}
+
+const PoolEntry& OpponentPool::operator[] (int index) const
+{
+    return entries[index];
+}
+
+float OpponentPool::WinRate(int index) const
+{
+    const PoolEntry& e = entries[index];
+    const uint32_t games = e.games.load(std::memory_order_relaxed);
+    const uint32_t points = e.points.load(std::memory_order_relaxed);
+    // prior of one draw
+    return (float(points) / 2 + 0.5f) / (games + 1);
+}
+
+float OpponentPool::Weight(int index) const
+{
+    const float p = WinRate(index);
+    switch(weighting)
+    {
+        case PFSPWeighting::HARD:
+            return (1 - p) * (1 - p);
+        case PFSPWeighting::VARIANCE:
+            return p * (1 - p);
+        default:
+            return 1.0f;
+    }
+}
+
+int OpponentPool::Sample(std::mt19937_64& rng) const
+{
+    const int n = Size();
+    if(n == 0)
+    {
+        return -1;
+    }
+
+    float weights[MAX_POOL_SIZE];
+    float total = 0;
+    for(int i = 0; i < n; i++)
+    {
+        // a small floor keeps every opponent in the rotation
+        weights[i] = Weight(i) + 1e-3f;
+        total += weights[i];
+    }
+
+    float r = std::uniform_real_distribution<float>(0, total)(rng);
+    for(int i = 0; i < n; i++)
+    {
+        r -= weights[i];
+        if(r < 0)
+        {
+            return i;
+        }
+    }
+    return n - 1;
+}
+
+void OpponentPool::Report(int index, float result)
+{
+    PoolEntry& e = entries[index];
+    e.points.fetch_add(uint32_t(result * 2 + 0.5f), std::memory_order_relaxed);
+    e.games.fetch_add(1, std::memory_order_relaxed);
+}
+
+////////////
+// League //
+////////////
+
+/**
+ * @brief PlayLeagueGame Plays a single game and reports the
+ * results to the pool
+ * @return The score of the learner (1 win, 0 death, 0.5 otherwise)
+ */
+float PlayLeagueGame(const AgentFactory& learner, OpponentPool& pool,
+                     const LeagueSettings& settings, uint64_t seed)
+{
+    std::mt19937_64 rng(seed);
+    const int seat = int(rng() % AGENT_COUNT);
+
+    std::unique_ptr<Agent> agents[AGENT_COUNT];
+    int opponent[AGENT_COUNT];
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        opponent[i] = i == seat ? -1 : pool.Sample(rng);
+        agents[i] = i == seat ? learner(rng()) : pool[opponent[i]].make(rng());
+        agents[i]->id = i;
+    }
+
+    std::unique_ptr<State> s = std::make_unique<State>();
+    InitState(s.get(), 0, 1, 2, 3, int(seed & 0x7FFFFFFF));
+
+    // step of death (maxSteps + 1 = survived)
+    int died[AGENT_COUNT];
+    std::fill(died, died + AGENT_COUNT, settings.maxSteps + 1);
+
+    Move moves[AGENT_COUNT];
+    for(int t = 0; t < settings.maxSteps && s->aliveAgents > 1; t++)
+    {
+        for(int i = 0; i < AGENT_COUNT; i++)
+        {
+            moves[i] = s->agents[i].dead ? Move::IDLE : agents[i]->act(s.get());
+        }
+        Step(s.get(), moves);
+        s->timeStep++;
+
+        for(int i = 0; i < AGENT_COUNT; i++)
+        {
+            if(s->agents[i].dead && died[i] > t)
+            {
+                died[i] = t;
+            }
+        }
+    }
+
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        if(i != seat)
+        {
+            pool.Report(opponent[i], died[seat] > died[i] ? 1.0f
+                        : (died[seat] < died[i] ? 0.0f : 0.5f));
+        }
+    }
+
+    if(s->agents[seat].dead)
+    {
+        return 0.0f;
+    }
+    return s->aliveAgents == 1 ? 1.0f : 0.5f;
+}
+
+float RunLeague(const AgentFactory& learner, OpponentPool& pool,
+                const LeagueSettings& settings)
+{
+    if(pool.Size() == 0)
+    {
+        return 0.0f;
+    }
+
+    std::vector<float> scores(settings.games);
+    Jobs().ParallelFor(settings.games, settings.threads, [&](int g)
+    {
+        scores[g] = PlayLeagueGame(learner, pool, settings,
+                                   HashCombine(settings.seed, uint64_t(g)));
+    });
+
+    float total = 0;
+    for(float s : scores)
+    {
+        total += s;
+    }
+    return settings.games > 0 ? total / settings.games : 0.0f;
+}
+
+}
@@ -0,0 +1,128 @@
+#ifndef LEAGUE_H
+#define LEAGUE_H
+
+#include <atomic>
+#include <memory>
+#include <random>
+#include <string>
+#include <functional>
+
+#include "bboard.hpp"
+
+namespace agents
+{
+
+/**
+ * @brief AgentFactory Creates a fresh instance of an agent
+ * (e.g. a frozen snapshot) with the given seed
+ */
+typedef std::function<std::unique_ptr<bboard::Agent>(uint64_t seed)> AgentFactory;
+
+const int MAX_POOL_SIZE = 64;
+
+/**
+ * @brief How opponents are weighted by the win rate p of the
+ * learner against them (prioritized fictitious self-play)
+ */
+enum class PFSPWeighting
+{
+    UNIFORM,    // 1
+    HARD,       // (1 - p)^2, focus on opponents the learner loses to
+    VARIANCE    // p (1 - p), focus on even opponents
+};
+
+/**
+ * @brief The PoolEntry struct is a frozen opponent and the
+ * results of the learner against it
+ */
+struct PoolEntry
+{
+    std::string name;
+    AgentFactory make;
+
+    // points are counted in halves (win 2, draw 1, loss 0)
+    std::atomic<uint32_t> games{0};
+    std::atomic<uint32_t> points{0};
+};
+
+/**
+ * Pool of opponents for self-play. Opponents are sampled by PFSP
+ * weights that follow the win rates of the learner, which are
+ * updated as games finish. Statistics are relaxed atomics, so any
+ * number of game threads can sample and report without locks.
+ * Adding opponents is safe while other threads sample, but only
+ * one thread may add at a time.
+ *
+ * @brief Opponent pool with PFSP sampling
+ */
+class OpponentPool
+{
+
+private:
+
+    PoolEntry entries[MAX_POOL_SIZE];
+    std::atomic<int> count{0};
+
+public:
+
+    PFSPWeighting weighting = PFSPWeighting::HARD;
+
+    /**
+     * @brief Add Adds a frozen opponent
+     * @return Its index or -1 if the pool is full
+     */
+    int Add(const std::string& name, const AgentFactory& make);
+
+    int Size() const;
+    const PoolEntry& operator[] (int index) const;
+
+    /**
+     * @brief Sample Returns the index of an opponent drawn by
+     * the PFSP weights (-1 if the pool is empty)
+     */
+    int Sample(std::mt19937_64& rng) const;
+
+    /**
+     * @brief Weight Returns the (unnormalized) PFSP weight of
+     * an opponent
+     */
+    float Weight(int index) const;
+
+    /**
+     * @brief Report Records a game result of the learner against
+     * an opponent (1 = win, 0.5 = draw, 0 = loss)
+     */
+    void Report(int index, float result);
+
+    /**
+     * @brief WinRate Returns the smoothed win rate of the
+     * learner against an opponent
+     */
+    float WinRate(int index) const;
+};
+
+/**
+ * @brief The LeagueSettings struct configures RunLeague
+ */
+struct LeagueSettings
+{
+    int games = 64;
+    int threads = 4; // parallel games (shared job system)
+    int maxSteps = 800;
+    uint64_t seed = 0x1337;
+};
+
+/**
+ * @brief RunLeague Plays games of the learner against three
+ * opponents sampled from the pool, in parallel. The learner
+ * takes a random seat. After every game each opponent is scored
+ * by who survived longer (the learner beat it, lost to it or
+ * both died in the same step / both survived).
+ * @return The mean score of the learner
+ */
+float RunLeague(const AgentFactory& learner, OpponentPool& pool,
+                const LeagueSettings& settings);
+
+}
+
+#endif // LEAGUE_H
@@ -0,0 +1,89 @@
+#include <algorithm>
+
+#include "mcts.hpp"
+
+namespace agents
+{
+
+void NodeArena::Reroot(int newRoot)
+{
+    root = newRoot;
+    MarkAndSweep(0);
+}
+
+int NodeArena::Collect()
+{
+    if(root == -1)
+    {
+        return 0;
+    }
+
+    // find the least recent visit below the root
+    uint32_t oldest = generation;
+    stack.push_back(root);
+    while(!stack.empty())
+    {
+        const int i = stack.back();
+        stack.pop_back();
+        for(int c = nodes[i].firstChild; c != -1; c = nodes[c].sibling)
+        {
+            oldest = std::min(oldest, nodes[c].lastVisit);
+            stack.push_back(c);
+        }
+    }
+
+    const int before = freeCount;
+    MarkAndSweep(oldest + (generation - oldest + 1) / 2);
+    return freeCount - before;
+}
+
+int NodeArena::Live() const
+{
+    return used - freeCount;
+}
+
+int NodeArena::MarkAndSweep(uint32_t cutoff)
+{
+    markEpoch++;
+    if(root != -1)
+    {
+        nodes[root].mark = markEpoch;
+        stack.push_back(root);
+    }
+    while(!stack.empty())
+    {
+        const int i = stack.back();
+        stack.pop_back();
+
+        int* link = &nodes[i].firstChild;
+        while(*link != -1)
+        {
+            Node& c = nodes[*link];
+            if(c.lastVisit < cutoff)
+            {
+                // unlink the whole subtree
+                *link = c.sibling;
+                continue;
+            }
+            c.mark = markEpoch;
+            stack.push_back(*link);
+            link = &c.sibling;
+        }
+    }
+
+    // sweep (ascending order, so low indices get reused first)
+    freeList = -1;
+    freeCount = 0;
+    for(int i = used - 1; i >= 0; i--)
+    {
+        if(nodes[i].mark != markEpoch)
+        {
+            nodes[i].sibling = freeList;
+            freeList = i;
+            freeCount++;
+        }
+    }
+    return freeCount;
+}
+
+}
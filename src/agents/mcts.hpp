@@ -0,0 +1,228 @@
+#ifndef MCTS_H
+#define MCTS_H
+
+#include <cmath>
+#include <vector>
+#include <limits>
+
+#include "bboard.hpp"
+#include "arena.hpp"
+
+namespace agents
+{
+
+// all moves, including BOMB
+const int ACTION_COUNT = 6;
+
+/**
+ * @brief The Node struct is a single information set of the
+ * searching agent. Statistics are kept per action (the agent's
+ * own move), children are the information sets that follow an
+ * action and are stored as a linked list inside the arena.
+ */
+struct Node
+{
+    uint64_t key = 0;
+
+    int firstChild = -1;
+    int sibling = -1; // next free node if the node is unused
+    int move = 0;
+
+    int visits = 0;
+    int n[ACTION_COUNT] = {};
+    float w[ACTION_COUNT] = {};
+
+    // generation of the last visit and of the last mark phase
+    uint32_t lastVisit = 0;
+    uint32_t mark = 0;
+};
+
+/**
+ * Fixed-capacity pool of nodes. The memory is reserved once
+ * (see Init) and never grows beyond it. Nodes are never freed one by one,
+ * unreachable nodes are reclaimed in bulk by a mark-sweep pass
+ * into a free list:
+ *
+ * - Reroot keeps only the subtree below the new root (e.g.
+ *   after a move was played)
+ * - Collect additionally cuts off all subtrees that were not
+ *   visited for the older half of the generations
+ *
+ * Every search thread owns its own arena, so allocations need
+ * no synchronization.
+ *
+ * @brief Memory-bounded node pool with node recycling
+ */
+struct NodeArena
+{
+    // page-backed (huge pages for large trees)
+    std::vector<Node, bboard::PageAllocator<Node>> nodes;
+    std::vector<int, bboard::PageAllocator<int>> stack;
+    int capacity = 0;
+    int used = 0;
+    int freeList = -1;
+    int freeCount = 0;
+    int root = -1;
+
+    // advanced by the search once per iteration
+    uint32_t generation = 1;
+    uint32_t markEpoch = 0;
+
+    /**
+     * @brief CapacityFor Returns the amount of nodes that fit
+     * into a memory budget (in bytes)
+     */
+    static int CapacityFor(size_t bytes)
+    {
+        return int(bytes / (sizeof(Node) + sizeof(int)));
+    }
+
+    /**
+     * @brief Init Reserves memory for the given amount of nodes
+     */
+    void Init(int capacity)
+    {
+        // reserve only, pages are touched when the tree grows,
+        // i.e. they end up on the node of the searching worker
+        this->capacity = capacity;
+        nodes.clear();
+        nodes.reserve(capacity);
+        stack.reserve(capacity);
+        Clear();
+    }
+
+    /**
+     * @brief Allocate Returns the index of a fresh node or -1
+     * if the arena is full
+     */
+    int Allocate(uint64_t key, int move)
+    {
+        int index;
+        if(freeList != -1)
+        {
+            index = freeList;
+            freeList = nodes[index].sibling;
+            freeCount--;
+        }
+        else if(used < capacity)
+        {
+            if(used == int(nodes.size()))
+            {
+                nodes.emplace_back();
+            }
+            index = used++;
+        }
+        else
+        {
+            return -1;
+        }
+        Node& n = nodes[index];
+        n = Node();
+        n.key = key;
+        n.move = move;
+        n.lastVisit = generation;
+        return index;
+    }
+
+    void Clear()
+    {
+        used = 0;
+        freeList = -1;
+        freeCount = 0;
+        root = -1;
+    }
+
+    /**
+     * @brief Reroot Makes the given node the root and recycles
+     * every node outside of its subtree
+     */
+    void Reroot(int newRoot);
+
+    /**
+     * @brief Collect Cuts off the least recently visited subtrees
+     * (below the root) and recycles them
+     * @return The amount of recycled nodes
+     */
+    int Collect();
+
+    /**
+     * @brief Live Returns the amount of nodes in use
+     */
+    int Live() const;
+
+    Node& operator[] (int index)
+    {
+        return nodes[index];
+    }
+
+private:
+
+    /**
+     * @brief MarkAndSweep Marks the subtree of the root, children
+     * that were last visited before the cutoff are unlinked. All
+     * unmarked nodes are put into the free list.
+     * @return The amount of free nodes
+     */
+    int MarkAndSweep(uint32_t cutoff);
+};
+
+/**
+ * @brief FindChild Returns the index of the child reached with the
+ * given move and information set key (or -1)
+ */
+inline int FindChild(NodeArena& arena, int node, int move, uint64_t key)
+{
+    for(int c = arena[node].firstChild; c != -1; c = arena[c].sibling)
+    {
+        if(arena[c].move == move && arena[c].key == key)
+        {
+            return c;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief AddChild Allocates a child and links it to its parent.
+ * Returns -1 if the arena is full.
+ */
+inline int AddChild(NodeArena& arena, int node, int move, uint64_t key)
+{
+    int c = arena.Allocate(key, move);
+    if(c != -1)
+    {
+        arena[c].sibling = arena[node].firstChild;
+        arena[node].firstChild = c;
+    }
+    return c;
+}
+
+/**
+ * @brief SelectUCB Selects an action with UCB1. Untried actions
+ * are taken first.
+ */
+inline int SelectUCB(const Node& node, float exploration)
+{
+    int best = 0;
+    float bestScore = -std::numeric_limits<float>::max();
+    const float logN = std::log(float(node.visits + 1));
+    for(int a = 0; a < ACTION_COUNT; a++)
+    {
+        if(node.n[a] == 0)
+        {
+            return a;
+        }
+        float score = node.w[a] / node.n[a]
+                      + exploration * std::sqrt(logN / node.n[a]);
+        if(score > bestScore)
+        {
+            bestScore = score;
+            best = a;
+        }
+    }
+    return best;
+}
+
+}
+
+#endif // MCTS_H
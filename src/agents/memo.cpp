@@ -0,0 +1,75 @@
+#include <cmath>
+#include <algorithm>
+
+#include "memo.hpp"
+
+namespace agents
+{
+
+const uint64_t MEMO_VALID = 1ULL << 63;
+
+MemoCache::MemoCache(size_t bytes)
+{
+    size_t count = 1;
+    while(count * 2 * sizeof(MemoEntry) <= bytes)
+    {
+        count *= 2;
+    }
+    entries = std::vector<MemoEntry>(count);
+    mask = count - 1;
+    Clear();
+}
+
+bool MemoCache::Probe(uint64_t key, bboard::Move& move, float* policy) const
+{
+    const MemoEntry& e = entries[key & mask];
+    const uint64_t d = e.data.load(std::memory_order_relaxed);
+    const uint64_t check = e.check.load(std::memory_order_relaxed);
+    if(!(d & MEMO_VALID) || (check ^ d) != key)
+    {
+        return false;
+    }
+
+    move = bboard::Move((d >> 48) & 0xF);
+    if(policy)
+    {
+        for(int a = 0; a < ACTION_COUNT; a++)
+        {
+            policy[a] = float((d >> (8 * a)) & 0xFF) / 255.0f;
+        }
+    }
+    return true;
+}
+
+void MemoCache::Store(uint64_t key, bboard::Move move, const float* policy)
+{
+    uint64_t d = MEMO_VALID | uint64_t(int(move) & 0xF) << 48;
+    if(policy)
+    {
+        for(int a = 0; a < ACTION_COUNT; a++)
+        {
+            const float p = std::max(0.0f, std::min(1.0f, policy[a]));
+            d |= uint64_t(std::lround(p * 255.0f)) << (8 * a);
+        }
+    }
+
+    MemoEntry& e = entries[key & mask];
+    e.data.store(d, std::memory_order_relaxed);
+    e.check.store(key ^ d, std::memory_order_relaxed);
+}
+
+void MemoCache::Clear()
+{
+    for(MemoEntry& e : entries)
+    {
+        e.check.store(0, std::memory_order_relaxed);
+        e.data.store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t MemoCache::Capacity() const
+{
+    return entries.size();
+}
+
+}
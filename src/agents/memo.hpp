@@ -0,0 +1,73 @@
+#ifndef MEMO_H
+#define MEMO_H
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+
+#include "bboard.hpp"
+#include "mcts.hpp"
+
+namespace agents
+{
+
+/**
+ * @brief The MemoEntry struct holds a packed move and (optional)
+ * policy. As in the transposition table the key is stored as
+ * key XOR data, torn writes read as misses.
+ *
+ *   Bit     Semantics
+ * [ 0, 48]  policy, one byte per action (probability * 255)
+ * [48, 52]  move
+ * [63, 64]  valid flag
+ */
+struct MemoEntry
+{
+    std::atomic<uint64_t> check;
+    std::atomic<uint64_t> data;
+};
+
+/**
+ * Fixed-size, lock-free, direct-mapped cache from observation
+ * keys to moves (or policy vectors). Collisions simply overwrite
+ * the slot. Can be shared by any number of threads.
+ *
+ * @brief Lock-free cache for act results
+ */
+class MemoCache
+{
+
+private:
+
+    std::vector<MemoEntry> entries;
+    uint64_t mask = 0;
+
+public:
+
+    /**
+     * @param bytes Memory budget, the cache uses the largest
+     * power-of-two amount of entries that fits into the budget
+     */
+    MemoCache(size_t bytes = 1 << 20);
+
+    /**
+     * @brief Probe Looks up a key
+     * @param policy If not null, receives ACTION_COUNT probabilities
+     * @return True on a hit
+     */
+    bool Probe(uint64_t key, bboard::Move& move, float* policy = nullptr) const;
+
+    /**
+     * @brief Store Stores a move (and optionally a policy with
+     * ACTION_COUNT probabilities) for a key
+     */
+    void Store(uint64_t key, bboard::Move move, const float* policy = nullptr);
+
+    void Clear();
+
+    size_t Capacity() const;
+};
+
+}
+
+#endif // MEMO_H
@@ -0,0 +1,61 @@
+#include "bboard.hpp"
+#include "agents.hpp"
+#include "hash.hpp"
+
+using namespace bboard;
+
+namespace agents
+{
+
+MemoAgent::MemoAgent(Agent* agent, MemoCache* cache)
+{
+    this->agent = agent;
+    this->cache = cache;
+    if(!cache)
+    {
+        ownCache = std::make_unique<MemoCache>();
+        this->cache = ownCache.get();
+    }
+}
+
+Move MemoAgent::act(const State* state)
+{
+    agent->id = id;
+    MemoState* memo = dynamic_cast<MemoState*>(agent);
+
+    uint64_t key = HashCombine(HashState(*state), uint64_t(id));
+    key = HashCombine(key, epoch);
+    if(memo)
+    {
+        key = HashCombine(key, memo->MemoKey());
+    }
+
+    lookups++;
+    Move m;
+    if(cache->Probe(key, m))
+    {
+        hits++;
+        if(memo)
+        {
+            memo->Replay(state, m);
+        }
+        return m;
+    }
+
+    m = agent->act(state);
+    cache->Store(key, m);
+    return m;
+}
+
+void MemoAgent::Invalidate()
+{
+    // entries of older epochs can never match again
+    epoch++;
+}
+
+float MemoAgent::HitRate() const
+{
+    return lookups == 0 ? 0.0f : float(hits) / lookups;
+}
+
+}
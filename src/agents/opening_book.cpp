@@ -0,0 +1,224 @@
+#include <mutex>
+#include <vector>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "bboard.hpp"
+#include "jobs.hpp"
+#include "agents.hpp"
+#include "hash.hpp"
+#include "opening_book.hpp"
+
+using namespace bboard;
+
+namespace agents
+{
+
+const char BOOK_MAGIC[4] = {'B', 'B', 'O', 'B'};
+const uint32_t BOOK_VERSION = 1;
+const size_t BOOK_HEADER_SIZE = 16;
+
+uint64_t BookKey(const State& state, int agentID)
+{
+    State obs;
+    FogState(state, obs, agentID);
+    return HashCombine(HashState(obs), uint64_t(agentID));
+}
+
+/////////////////
+// OpeningBook //
+/////////////////
+
+OpeningBook::~OpeningBook()
+{
+    Close();
+}
+
+bool OpeningBook::Open(const std::string& path)
+{
+    Close();
+
+    const int fd = open(path.c_str(), O_RDONLY);
+    if(fd == -1)
+    {
+        return false;
+    }
+    struct stat st;
+    if(fstat(fd, &st) != 0 || size_t(st.st_size) < BOOK_HEADER_SIZE)
+    {
+        close(fd);
+        return false;
+    }
+    void* m = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(m == MAP_FAILED)
+    {
+        return false;
+    }
+
+    const uint8_t* p = static_cast<const uint8_t*>(m);
+    uint32_t version;
+    uint64_t n;
+    std::memcpy(&version, p + 4, 4);
+    std::memcpy(&n, p + 8, 8);
+    if(std::memcmp(p, BOOK_MAGIC, 4) != 0 || version != BOOK_VERSION
+            || BOOK_HEADER_SIZE + n * sizeof(BookEntry) != size_t(st.st_size))
+    {
+        munmap(m, size_t(st.st_size));
+        return false;
+    }
+
+    mapping = m;
+    mappingSize = size_t(st.st_size);
+    entries = reinterpret_cast<const BookEntry*>(p + BOOK_HEADER_SIZE);
+    count = size_t(n);
+    return true;
+}
+
+void OpeningBook::Close()
+{
+    if(mapping)
+    {
+        munmap(mapping, mappingSize);
+    }
+    mapping = nullptr;
+    mappingSize = 0;
+    entries = nullptr;
+    count = 0;
+}
+
+const BookEntry* OpeningBook::Find(uint64_t key) const
+{
+    const BookEntry* end = entries + count;
+    const BookEntry* e = std::lower_bound(entries, end, key,
+                                          [](const BookEntry& b, uint64_t k)
+    {
+        return b.key < k;
+    });
+    return e != end && e->key == key ? e : nullptr;
+}
+
+size_t OpeningBook::Size() const
+{
+    return count;
+}
+
+////////////////////////
+// OpeningBookBuilder //
+////////////////////////
+
+inline int TotalVisits(const BookEntry& e)
+{
+    int n = 0;
+    for(int a = 0; a < ACTION_COUNT; a++)
+    {
+        n += e.visits[a];
+    }
+    return n;
+}
+
+void OpeningBookBuilder::Add(const BookEntry& entry)
+{
+    auto it = entries.find(entry.key);
+    if(it == entries.end() || TotalVisits(it->second) < TotalVisits(entry))
+    {
+        entries[entry.key] = entry;
+    }
+}
+
+bool OpeningBookBuilder::Save(const std::string& path) const
+{
+    std::vector<BookEntry> sorted;
+    sorted.reserve(entries.size());
+    for(const auto& kv : entries)
+    {
+        sorted.push_back(kv.second);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const BookEntry& a, const BookEntry& b)
+    {
+        return a.key < b.key;
+    });
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    const uint64_t n = sorted.size();
+    out.write(BOOK_MAGIC, 4);
+    out.write(reinterpret_cast<const char*>(&BOOK_VERSION), 4);
+    out.write(reinterpret_cast<const char*>(&n), 8);
+    out.write(reinterpret_cast<const char*>(sorted.data()), std::streamsize(n * sizeof(BookEntry)));
+    return bool(out);
+}
+
+////////////////
+// Generation //
+////////////////
+
+/**
+ * @brief PlayBookGame Plays a single self-play game and records
+ * the searches of all agents
+ */
+void PlayBookGame(const State& start, const BookSettings& settings, uint64_t seed,
+                  std::vector<BookEntry>& out)
+{
+    ISMCTSAgent agents[AGENT_COUNT];
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        agents[i].id = i;
+        agents[i].timeBudget = settings.searchTime;
+        agents[i].rng.seed(seed + uint64_t(i));
+    }
+
+    State s = start;
+    s.timeStep = 0;
+    Move moves[AGENT_COUNT];
+    for(int ply = 0; ply < settings.plies && s.aliveAgents > 1; ply++)
+    {
+        for(int i = 0; i < AGENT_COUNT; i++)
+        {
+            moves[i] = Move::IDLE;
+            if(s.agents[i].dead)
+            {
+                continue;
+            }
+            ISMCTSAgent& a = agents[i];
+            moves[i] = a.act(&s);
+
+            BookEntry e = {};
+            e.key = BookKey(s, i);
+            for(int m = 0; m < ACTION_COUNT; m++)
+            {
+                e.visits[m] = uint16_t(std::min(a.lastVisits[m], 0xFFFF));
+            }
+            e.move = uint8_t(moves[i]);
+            e.timeStep = uint8_t(std::min(s.timeStep, 0xFF));
+            e.value = int16_t(a.lastValues[int(moves[i])] * 32767.0f);
+            out.push_back(e);
+        }
+        Step(&s, moves);
+        s.timeStep++;
+    }
+}
+
+void GenerateOpeningBook(const State& start, const BookSettings& settings,
+                         OpeningBookBuilder& builder)
+{
+    std::mutex mutex;
+    Jobs().ParallelFor(settings.games, settings.threads, [&](int g)
+    {
+        std::vector<BookEntry> entries;
+        PlayBookGame(start, settings, HashCombine(settings.seed, uint64_t(g)), entries);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for(const BookEntry& e : entries)
+        {
+            builder.Add(e);
+        }
+    });
+}
+
+}
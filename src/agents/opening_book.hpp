@@ -0,0 +1,121 @@
+#ifndef OPENING_BOOK_H
+#define OPENING_BOOK_H
+
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+
+#include "bboard.hpp"
+#include "mcts.hpp"
+
+namespace agents
+{
+
+/**
+ * @brief The BookEntry struct holds the root statistics of a
+ * search done offline
+ */
+struct BookEntry
+{
+    uint64_t key;
+    uint16_t visits[ACTION_COUNT];
+    uint8_t move;
+    uint8_t timeStep;
+    int16_t value; // mean value of move in [-1, 1], scaled by 32767
+};
+
+static_assert (sizeof(BookEntry) == 24, "Book entries are stored bytewise");
+
+/**
+ * @brief BookKey Returns the key of a position from the view of
+ * an agent (its observation and its id)
+ */
+uint64_t BookKey(const bboard::State& state, int agentID);
+
+/**
+ * Read-only opening book backed by a memory-mapped file, so any
+ * number of agents (and processes) share the same pages. File
+ * layout (little endian):
+ *
+ *   4 bytes   magic "BBOB"
+ *   4 bytes   version
+ *   8 bytes   entry count
+ *   24 bytes  per entry, sorted by key
+ *
+ * @brief Precomputed search results for the first moves
+ */
+class OpeningBook
+{
+
+private:
+
+    void* mapping = nullptr;
+    size_t mappingSize = 0;
+    const BookEntry* entries = nullptr;
+    size_t count = 0;
+
+public:
+
+    OpeningBook() = default;
+    OpeningBook(const OpeningBook&) = delete;
+    OpeningBook& operator=(const OpeningBook&) = delete;
+    ~OpeningBook();
+
+    /**
+     * @brief Open Maps a book file into memory
+     * @return False if the file is missing or not a valid book
+     */
+    bool Open(const std::string& path);
+    void Close();
+
+    /**
+     * @brief Find Looks up a key with binary search
+     * @return The entry or nullptr
+     */
+    const BookEntry* Find(uint64_t key) const;
+
+    size_t Size() const;
+};
+
+/**
+ * @brief The OpeningBookBuilder struct collects entries and
+ * writes book files. Of duplicate keys the entry with more
+ * visits is kept.
+ */
+struct OpeningBookBuilder
+{
+    std::unordered_map<uint64_t, BookEntry> entries;
+
+    void Add(const BookEntry& entry);
+
+    /**
+     * @brief Save Writes all entries (sorted) to a book file
+     * @return False if the file could not be written
+     */
+    bool Save(const std::string& path) const;
+};
+
+/**
+ * @brief The BookSettings struct controls the offline generation
+ */
+struct BookSettings
+{
+    int games = 64;
+    int plies = 16; // recorded steps per game
+    int searchTime = 250; // ms per move
+    int threads = 4;
+    uint64_t seed = 0x1337;
+};
+
+/**
+ * @brief GenerateOpeningBook Plays self-play games with expensive
+ * ISMCTS searches from the given start and records the root
+ * statistics of every agent at every step. At most settings.threads
+ * games are played in parallel on the shared job system.
+ */
+void GenerateOpeningBook(const bboard::State& start, const BookSettings& settings,
+                         OpeningBookBuilder& builder);
+
+}
+
+#endif // OPENING_BOOK_H
@@ -0,0 +1,635 @@
+#include <algorithm>
+
+#include "bboard.hpp"
+#include "agents.hpp"
+
+using namespace bboard;
+
+namespace agents
+{
+
+PlaygroundAgent::PlaygroundAgent()
+{
+    std::random_device rd;  // non explicit seed
+    rng = std::mt19937_64(rd());
+}
+
+PlaygroundAgent::PlaygroundAgent(uint64_t seed)
+{
+    rng = std::mt19937_64(seed);
+}
+
+/////////////////////
+// Auxiliary state //
+/////////////////////
+
+namespace
+{
+
+// search depth of the playground agent
+const int PLAYGROUND_DEPTH = 10;
+
+// distance of cells that were not reached (yet)
+const int UNREACHABLE = 0xFF;
+
+// largest radius the agent looks for enemies, powerups and wood
+const int NEAR_RADIUS = 3;
+
+/**
+ * The playground's blast strength counts the cell of the bomb
+ * (a default bomb has strength 2 there), ours does not.
+ */
+inline int PlaygroundStrength(int strength)
+{
+    return strength + 1;
+}
+
+/**
+ * The search is the playground's _djikstra, but it only expands
+ * as far as a decision needs (usually a few steps, see Expand).
+ * The cells in range that were not reached are UNREACHABLE,
+ * just like the ones the playground can't reach.
+ *
+ * @brief Everything the playground agent derives from an
+ * observation before it decides
+ */
+struct Observation
+{
+    const State* state;
+    int id;
+    Cell position;
+    int ammo;
+    int blastStrength;
+
+    // bombs in row-major order (like the bomb strength map)
+    int bombCount = 0;
+    Cell bombCells[MAX_BOMBS];
+    int bombStrengths[MAX_BOMBS];
+
+    // search state, the queue holds all cells reached so far
+    uint8_t dist[CELL_COUNT];
+    Cell prev[CELL_COUNT];
+    Cell queue[CELL_COUNT];
+    int head = 0;
+    int tail = 0;
+
+    // random bits for the ties of the search
+    uint64_t coins = 0;
+    int coinCount = 0;
+
+    // reached cells within NEAR_RADIUS (without our own)
+    int nearCount = 0;
+    Cell near[CELL_COUNT];
+};
+
+inline int ItemAt(const Observation& o, Cell c)
+{
+    return (*o.state)[c];
+}
+
+inline bool IsEnemy(const Observation& o, int item)
+{
+    return item >= Item::AGENT0 && item != Item::AGENT0 + o.id;
+}
+
+/**
+ * @brief IsPassable utility.position_is_passable: agents, powerups
+ * and passages, but no enemies
+ */
+inline bool IsPassable(const Observation& o, int item)
+{
+    return item == Item::PASSAGE || IS_POWERUP(item) || item == Item::AGENT0 + o.id;
+}
+
+/**
+ * @brief InRange Is the cell part of the playground's dist? The
+ * range is a diamond of PLAYGROUND_DEPTH without fog, walls and
+ * flames (the upper bounds of its loops are exclusive).
+ */
+inline bool InRange(const Observation& o, Cell c)
+{
+    const int dx = CellX(c) - CellX(o.position);
+    const int dy = CellY(c) - CellY(o.position);
+    if(std::abs(dx) + std::abs(dy) > PLAYGROUND_DEPTH || dx >= PLAYGROUND_DEPTH || dy >= PLAYGROUND_DEPTH)
+    {
+        return false;
+    }
+    const int item = ItemAt(o, c);
+    return item != Item::FOG && item != Item::RIGID && !IS_FLAME(item);
+}
+
+/**
+ * @brief NextCell utility.get_next_position (NO_CELL if it leaves
+ * the board)
+ */
+inline Cell NextCell(Cell c, Move m)
+{
+    return Neighbor(c, m);
+}
+
+// the neighbor order of the playground: (-1, 0), (1, 0), (0, -1), (0, 1)
+const Move NEIGHBOR_ORDER[4] = {Move::UP, Move::DOWN, Move::LEFT, Move::RIGHT};
+
+void FillBombs(Observation& o)
+{
+    const State& s = *o.state;
+
+    // insertion sort by cell gives the row-major order
+    for(int i = 0; i < s.bombs.count; i++)
+    {
+        const Cell c = BMB_CELL(s.bombs[i]);
+        const int strength = PlaygroundStrength(BMB_STRENGTH(s.bombs[i]));
+
+        int j = o.bombCount++;
+        for(; j > 0 && o.bombCells[j - 1] > c; j--)
+        {
+            o.bombCells[j] = o.bombCells[j - 1];
+            o.bombStrengths[j] = o.bombStrengths[j - 1];
+        }
+        o.bombCells[j] = c;
+        o.bombStrengths[j] = strength;
+    }
+}
+
+void StartSearch(Observation& o)
+{
+    std::fill(o.dist, o.dist + CELL_COUNT, uint8_t(UNREACHABLE));
+    o.dist[o.position] = 0;
+    o.prev[o.position] = NO_CELL;
+    o.queue[o.tail++] = o.position;
+}
+
+/**
+ * @brief Expand Continues the search until all cells up to the
+ * given distance are reached (with their final predecessors).
+ * Equally short paths get a random predecessor like in the
+ * playground's BFS.
+ */
+void Expand(Observation& o, int distance, std::mt19937_64& rng)
+{
+    while(o.head < o.tail && o.dist[o.queue[o.head]] < distance)
+    {
+        const Cell p = o.queue[o.head++];
+        if(!IsPassable(o, ItemAt(o, p)))
+        {
+            continue;
+        }
+
+        const int val = o.dist[p] + 1;
+        for(Move m : NEIGHBOR_ORDER)
+        {
+            const Cell n = NextCell(p, m);
+            if(n == NO_CELL)
+            {
+                continue;
+            }
+            if(o.dist[n] == UNREACHABLE)
+            {
+                if(!InRange(o, n))
+                {
+                    continue;
+                }
+                o.dist[n] = uint8_t(val);
+                o.prev[n] = p;
+                o.queue[o.tail++] = n;
+                if(val <= NEAR_RADIUS)
+                {
+                    o.near[o.nearCount++] = n;
+                }
+            }
+            else if(val == o.dist[n])
+            {
+                if(o.coinCount == 0)
+                {
+                    o.coins = rng();
+                    o.coinCount = 64;
+                }
+                if(o.coins & 1)
+                {
+                    o.prev[n] = p;
+                }
+                o.coins >>= 1;
+                o.coinCount--;
+            }
+        }
+    }
+}
+
+/**
+ * @brief The UnsafeDirections struct is the playground's
+ * defaultdict of directions in range of a bomb (keeps the
+ * insertion order)
+ */
+struct UnsafeDirections
+{
+    int count = 0;
+    Move order[4];
+    int range[6] = {};
+
+    void Put(Move m, int strength)
+    {
+        if(range[int(m)] == 0)
+        {
+            order[count++] = m;
+        }
+        range[int(m)] = std::max(range[int(m)], strength);
+    }
+
+    bool Contains(Move m) const
+    {
+        return range[int(m)] != 0;
+    }
+};
+
+UnsafeDirections DirectionsInRangeOfBomb(const Observation& o)
+{
+    UnsafeDirections ret;
+    const int x = CellX(o.position), y = CellY(o.position);
+    for(int i = 0; i < o.bombCount; i++)
+    {
+        const Cell b = o.bombCells[i];
+        const int distance = o.dist[b];
+        const int strength = o.bombStrengths[i];
+        if(distance > strength)
+        {
+            continue;
+        }
+
+        if(b == o.position)
+        {
+            // we are on a bomb, all directions are in range
+            ret.Put(Move::RIGHT, strength);
+            ret.Put(Move::LEFT, strength);
+            ret.Put(Move::UP, strength);
+            ret.Put(Move::DOWN, strength);
+        }
+        else if(y == CellY(b))
+        {
+            ret.Put(x < CellX(b) ? Move::RIGHT : Move::LEFT, strength);
+        }
+        else if(x == CellX(b))
+        {
+            ret.Put(y < CellY(b) ? Move::DOWN : Move::UP, strength);
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief IsStuckDirection Returns true if every cell reachable from
+ * next (over passable cells, not through our position) is on the
+ * same row or column and within the bomb range
+ */
+bool IsStuckDirection(const Observation& o, Cell next, int bombRange)
+{
+    const int nx = CellX(next), ny = CellY(next);
+
+    bool seen[CELL_COUNT] = {};
+    FixedQueue<Cell, CELL_COUNT> queue;
+    queue.AddElem(next);
+    seen[next] = true;
+
+    while(queue.count > 0)
+    {
+        const Cell p = queue.PopElem();
+        const int px = CellX(p), py = CellY(p);
+        if((nx != px && ny != py) || std::abs(px - nx) + std::abs(py - ny) > bombRange)
+        {
+            return false;
+        }
+
+        for(Move m : NEIGHBOR_ORDER)
+        {
+            const Cell n = NextCell(p, m);
+            // our position holds the bomb we are about to lay
+            if(n == NO_CELL || seen[n] || n == o.position || !IsPassable(o, ItemAt(o, n)))
+            {
+                continue;
+            }
+            seen[n] = true;
+            queue.AddElem(n);
+        }
+    }
+    return true;
+}
+
+void FindSafeDirections(const Observation& o, const UnsafeDirections& unsafe,
+                        FixedQueue<Move, MOVE_COUNT + 1>& safe)
+{
+    if(unsafe.count == 4)
+    {
+        // all directions are unsafe, find one that won't leave us locked
+        for(int i = 0; i < unsafe.count; i++)
+        {
+            const Move m = unsafe.order[i];
+            const Cell next = NextCell(o.position, m);
+            if(next == NO_CELL || !IsPassable(o, ItemAt(o, next)))
+            {
+                continue;
+            }
+            if(!IsStuckDirection(o, next, unsafe.range[int(m)]))
+            {
+                safe.AddElem(m);
+                return;
+            }
+        }
+        safe.AddElem(Move::IDLE);
+        return;
+    }
+
+    bool disallowed[6] = {};
+    for(Move m : NEIGHBOR_ORDER)
+    {
+        const Cell next = NextCell(o.position, m);
+        if(next == NO_CELL)
+        {
+            disallowed[int(m)] = true;
+            continue;
+        }
+        if(unsafe.Contains(m))
+        {
+            continue;
+        }
+        const int item = ItemAt(o, next);
+        if(IsPassable(o, item) || item == Item::FOG)
+        {
+            safe.AddElem(m);
+        }
+    }
+
+    if(safe.count == 0)
+    {
+        // something that is allowed at least
+        for(int i = 0; i < unsafe.count; i++)
+        {
+            if(!disallowed[int(unsafe.order[i])])
+            {
+                safe.AddElem(unsafe.order[i]);
+            }
+        }
+    }
+
+    if(safe.count == 0)
+    {
+        safe.AddElem(Move::IDLE);
+    }
+}
+
+/**
+ * @brief MaybeBomb Can we bomb without getting stuck?
+ */
+bool MaybeBomb(Observation& o, std::mt19937_64& rng)
+{
+    if(o.ammo < 1)
+    {
+        return false;
+    }
+
+    // a reachable passage outside of the bomb's strength or scope,
+    // usually one of the cells reached so far
+    const int x = CellX(o.position), y = CellY(o.position);
+    for(int i = 0;; i++)
+    {
+        if(i == o.tail)
+        {
+            Expand(o, UNREACHABLE, rng);
+            if(i == o.tail)
+            {
+                return false;
+            }
+        }
+
+        const Cell c = o.queue[i];
+        if(ItemAt(o, c) == Item::PASSAGE && (o.dist[c] > o.blastStrength || (CellX(c) != x && CellY(c) != y)))
+        {
+            return true;
+        }
+    }
+}
+
+
+/**
+ * The playground scans the cells of every object in turn and keeps
+ * the last of the closest ones, that is the closest cell with the
+ * largest (object, row-major index) key.
+ *
+ * @brief The Nearest struct is the playground's _nearest_position
+ * for a group of objects
+ */
+struct Nearest
+{
+    Cell cell = NO_CELL;
+    int dist = UNREACHABLE;
+    int key = -1;
+
+    void Offer(Cell c, int d, int object)
+    {
+        const int k = object * CELL_COUNT + c;
+        if(d < dist || (d == dist && k > key))
+        {
+            cell = c;
+            dist = d;
+            key = k;
+        }
+    }
+
+    /**
+     * @brief Within Returns the nearest cell if it is within the
+     * radius (at most NEAR_RADIUS), NO_CELL otherwise
+     */
+    Cell Within(int radius) const
+    {
+        return dist <= radius ? cell : NO_CELL;
+    }
+};
+
+/**
+ * @brief FindNearest Finds the nearest enemy (in id order), good
+ * powerup (extra bomb, range, kick) and wood in one pass
+ */
+void FindNearest(const Observation& o, Nearest& enemy, Nearest& powerup, Nearest& wood)
+{
+    for(int i = 0; i < o.nearCount; i++)
+    {
+        const Cell c = o.near[i];
+        const int item = ItemAt(o, c);
+        if(IsEnemy(o, item))
+        {
+            enemy.Offer(c, o.dist[c], item - Item::AGENT0);
+        }
+        else if(IS_POWERUP(item))
+        {
+            powerup.Offer(c, o.dist[c], item - Item::EXTRABOMB);
+        }
+        else if(IS_WOOD(item))
+        {
+            wood.Offer(c, o.dist[c], 0);
+        }
+    }
+}
+
+inline Move DirectionTo(Cell from, Cell to)
+{
+    if(CellX(to) < CellX(from)) return Move::LEFT;
+    if(CellX(to) > CellX(from)) return Move::RIGHT;
+    if(CellY(to) < CellY(from)) return Move::UP;
+    if(CellY(to) > CellY(from)) return Move::DOWN;
+    return Move::IDLE;
+}
+
+/**
+ * @brief DirectionTowards The first move on the path to the cell
+ * (false if there is no cell)
+ */
+bool DirectionTowards(const Observation& o, Cell position, Move& direction)
+{
+    if(position == NO_CELL)
+    {
+        return false;
+    }
+    Cell next = position;
+    while(o.prev[next] != o.position)
+    {
+        next = o.prev[next];
+    }
+    direction = DirectionTo(o.position, next);
+    return true;
+}
+
+/**
+ * @brief IsSafe Returns false if the cell behind the move lies in
+ * the cross of any bomb (no matter what blocks the flames)
+ */
+bool IsSafe(const Observation& o, Move m)
+{
+    const Cell next = NextCell(o.position, m);
+    const int x = CellX(next), y = CellY(next);
+    for(int i = 0; i < o.bombCount; i++)
+    {
+        const int bx = CellX(o.bombCells[i]), by = CellY(o.bombCells[i]);
+        const int strength = o.bombStrengths[i];
+        if((y == by && std::abs(bx - x) <= strength) || (x == bx && std::abs(by - y) <= strength))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+Move PlaygroundAgent::act(const State* state)
+{
+    const AgentInfo& a = state->agents[id];
+
+    Observation o;
+    o.state = state;
+    o.id = id;
+    o.position = ToCell(a.x, a.y);
+    o.ammo = a.maxBombCount - a.bombCount;
+    o.blastStrength = PlaygroundStrength(a.bombStrength);
+    FillBombs(o);
+
+    // far enough for the bombs and everything near
+    int depth = NEAR_RADIUS;
+    for(int i = 0; i < o.bombCount; i++)
+    {
+        depth = std::max(depth, o.bombStrengths[i]);
+    }
+    StartSearch(o);
+    Expand(o, depth, rng);
+
+    Nearest enemy, powerup, wood;
+    FindNearest(o, enemy, powerup, wood);
+
+    // move if we are in an unsafe place
+    const UnsafeDirections unsafe = DirectionsInRangeOfBomb(o);
+    if(unsafe.count > 0)
+    {
+        FixedQueue<Move, MOVE_COUNT + 1> safe;
+        FindSafeDirections(o, unsafe, safe);
+        return safe[int(rng() % uint64_t(safe.count))];
+    }
+
+    // lay a bomb if we are adjacent to an enemy
+    if(enemy.dist == 1 && MaybeBomb(o, rng))
+    {
+        return Move::BOMB;
+    }
+
+    // move towards an enemy if there is one within three steps
+    Move direction;
+    if(DirectionTowards(o, enemy.Within(3), direction) && (prevDirection != direction || (rng() >> 63)))
+    {
+        prevDirection = direction;
+        return direction;
+    }
+
+    // move towards a good powerup within two steps
+    if(DirectionTowards(o, powerup.Within(2), direction))
+    {
+        return direction;
+    }
+
+    // maybe lay a bomb if we are next to wood
+    if(wood.Within(1) != NO_CELL)
+    {
+        return MaybeBomb(o, rng) ? Move::BOMB : Move::IDLE;
+    }
+
+    // move towards wood within two steps
+    if(DirectionTowards(o, wood.Within(2), direction) && IsSafe(o, direction))
+    {
+        return direction;
+    }
+
+    // choose a random but valid direction
+    const Move moves[] = {Move::IDLE, Move::LEFT, Move::RIGHT, Move::UP, Move::DOWN};
+    FixedQueue<Move, MOVE_COUNT + 1> valid;
+    for(Move m : moves)
+    {
+        const Cell next = NextCell(o.position, m);
+        if(next != NO_CELL && IsPassable(o, ItemAt(o, next)) && IsSafe(o, m))
+        {
+            valid.AddElem(m);
+        }
+    }
+
+    FixedQueue<Move, MOVE_COUNT + 1> directions;
+    for(int i = 0; i < valid.count; i++)
+    {
+        bool visited = false;
+        for(int j = 0; j < recentPositions.count; j++)
+        {
+            visited = visited || recentPositions[j] == NextCell(o.position, valid[i]);
+        }
+        if(!visited)
+        {
+            directions.AddElem(valid[i]);
+        }
+    }
+    if(directions.count == 0)
+    {
+        directions = valid;
+    }
+
+    if(directions.count > 1 && directions[0] == Move::IDLE)
+    {
+        directions.PopElem();
+    }
+    if(directions.count == 0)
+    {
+        directions.AddElem(Move::IDLE);
+    }
+
+    // remember this position so we don't return immediately
+    if(recentPositions.RemainingCapacity() == 0)
+    {
+        recentPositions.PopElem();
+    }
+    recentPositions.AddElem(o.position);
+
+    return directions[int(rng() % uint64_t(directions.count))];
+}
+
+}
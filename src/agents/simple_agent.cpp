@@ -2,6 +2,7 @@
 #include "agents.hpp"
 #include "strategy.hpp"
 #include "step_utility.hpp"
+#include "hash.hpp"
 
 using namespace bboard;
 using namespace bboard::strategy;
@@ -11,7 +12,8 @@ namespace agents
 
 bool _CheckPos(const State& state, int x, int y)
 {
-    return !util::IsOutOfBounds(x, y) && IS_WALKABLE(state.board[y][x]);
+    // at most one cell off the board (the RIGID border)
+    return IS_WALKABLE(state.board[y][x]);
 }
 
 SimpleAgent::SimpleAgent()
@@ -21,6 +23,55 @@ SimpleAgent::SimpleAgent()
     intDist = std::uniform_int_distribution<int>(0, 4); // no bombs
 }
 
+SimpleAgent::SimpleAgent(uint64_t seed)
+{
+    rng = std::mt19937_64(seed);
+    intDist = std::uniform_int_distribution<int>(0, 4); // no bombs
+}
+
+///////////////////////
+// SimpleAgentParams //
+///////////////////////
+
+void SimpleAgentParams::Bounds(int index, int& min, int& max)
+{
+    const int bounds[COUNT][2] =
+    {
+        {0, 5},                     // bombEnemyDistance
+        {0, 3},                     // bombWoodDistance
+        {0, 2 * BOARD_SIZE},        // chaseRadius
+        {1, MOVE_COUNT},            // moveChoices
+        {0, SIMPLE_MAX_HISTORY}     // historyLength
+    };
+    min = bounds[index][0];
+    max = bounds[index][1];
+}
+
+void SimpleAgentParams::ToVector(float* v) const
+{
+    const int values[COUNT] = {bombEnemyDistance, bombWoodDistance, chaseRadius,
+                               moveChoices, historyLength};
+    for(int i = 0; i < COUNT; i++)
+    {
+        int min, max;
+        Bounds(i, min, max);
+        v[i] = float(values[i] - min) / (max - min);
+    }
+}
+
+void SimpleAgentParams::FromVector(const float* v)
+{
+    int* values[COUNT] = {&bombEnemyDistance, &bombWoodDistance, &chaseRadius,
+                          &moveChoices, &historyLength};
+    for(int i = 0; i < COUNT; i++)
+    {
+        int min, max;
+        Bounds(i, min, max);
+        const int x = int(std::lround(min + v[i] * (max - min)));
+        *values[i] = std::max(min, std::min(max, x));
+    }
+}
+
 
 Move _Decide(SimpleAgent& me, const State* state)
 {
@@ -36,15 +87,15 @@ Move _Decide(SimpleAgent& me, const State* state)
 
     if(a.bombCount < a.maxBombCount)
     {
-        if(IsAdjacentEnemy(*state, me.id, 2)
-                || IsAdjacentItem(*state, me.id, 1, Item::WOOD))
+        if(IsAdjacentEnemy(*state, me.id, me.params.bombEnemyDistance)
+                || IsAdjacentItem(*state, me.id, me.params.bombWoodDistance, Item::WOOD))
         {
             return Move::BOMB;
         }
 
-        if(IsAdjacentEnemy(*state, me.id, 7))
+        if(IsAdjacentEnemy(*state, me.id, me.params.chaseRadius))
         {
-            return MoveTowardsEnemy(*state, me.r, 7);
+            return MoveTowardsEnemy(*state, me.r, me.params.chaseRadius);
         }
     }
     me.moveQueue.count = 0;
@@ -57,29 +108,56 @@ Move _Decide(SimpleAgent& me, const State* state)
     }
     else
     {
-        return me.moveQueue[me.intDist(me.rng) % 2];
+        const int choices = std::min(me.moveQueue.count, me.params.moveChoices);
+        return me.moveQueue[me.intDist(me.rng) % choices];
     }
 }
 Move SimpleAgent::act(const State* state)
 {
-    const AgentInfo& a = state->agents[id];
     Move m = _Decide(*this, state);
-    Position p = util::DesiredPosition(a.x, a.y, m);
+    Replay(state, m);
+    return m;
+}
 
-    if(recentPositions.RemainingCapacity() == 0)
+uint64_t SimpleAgent::MemoKey() const
+{
+    uint64_t h = HashCombine(0, uint64_t(recentPositions.count));
+    for(int i = 0; i < recentPositions.count; i++)
     {
-        recentPositions.PopElem();
+        h = HashCombine(h, uint64_t(recentPositions[i]));
     }
-    recentPositions.AddElem(p);
+    return h;
+}
 
-    return m;
+void SimpleAgent::Replay(const State* state, Move move)
+{
+    const AgentInfo& a = state->agents[id];
+    const Cell c = util::AgentCell(a);
+    const Cell p = c == NO_CELL ? NO_CELL : Neighbor(c, move);
+
+    while(recentPositions.count > 0 && recentPositions.count >= params.historyLength)
+    {
+        recentPositions.PopElem();
+    }
+    if(params.historyLength > 0)
+    {
+        recentPositions.AddElem(p);
+    }
 }
 
 void SimpleAgent::PrintDetailedInfo()
 {
     for(int i = 0; i < recentPositions.count; i++)
     {
-        std::cout << recentPositions[i] << std::endl;
+        const Cell c = recentPositions[i];
+        if(c == NO_CELL)
+        {
+            std::cout << "(out of bounds)" << std::endl;
+        }
+        else
+        {
+            std::cout << ToPosition(c) << std::endl;
+        }
     }
 }
 
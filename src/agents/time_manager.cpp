@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <cstdlib>
+
+#include "bboard.hpp"
+#include "strategy.hpp"
+#include "time_manager.hpp"
+
+using namespace bboard;
+
+namespace agents
+{
+
+float TimeManager::Criticality(const State& state, int agentID)
+{
+    const AgentInfo& me = state.agents[agentID];
+    if(me.dead)
+    {
+        return 0.0f;
+    }
+
+    // a bomb that explodes soon is more critical
+    float danger = 0.0f;
+    const int timeLeft = strategy::IsInDanger(state, agentID);
+    if(timeLeft > 0)
+    {
+        danger = 1.0f - float(timeLeft - 1) / BOMB_LIFETIME;
+    }
+
+    // the same goes for close (visible) enemies
+    int closest = 2 * VIEW_RADIUS;
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        const AgentInfo& other = state.agents[i];
+        if(i == agentID || other.dead || other.x < 0)
+        {
+            continue;
+        }
+        closest = std::min(closest, std::abs(other.x - me.x) + std::abs(other.y - me.y));
+    }
+    const float proximity = 1.0f - float(closest) / (2 * VIEW_RADIUS);
+
+    return std::max(danger, proximity);
+}
+
+SearchBudget TimeManager::Plan(const State& state, int agentID) const
+{
+    const float usable = std::max(1.0f, stepDeadline - safetyMargin);
+    const float c = Criticality(state, agentID);
+    const float ms = usable * (quietFraction + (1.0f - quietFraction) * c);
+
+    SearchBudget b;
+    b.milliseconds = std::max(1, int(ms));
+    b.iterations = maxIterations;
+    if(costPerIteration > 0)
+    {
+        b.iterations = int(std::min<double>(maxIterations, ms / costPerIteration));
+        b.iterations = std::max(1, b.iterations);
+    }
+    return b;
+}
+
+void TimeManager::Record(int iterations, double milliseconds)
+{
+    if(iterations <= 0)
+    {
+        return;
+    }
+    const double cost = milliseconds / iterations;
+    costPerIteration = samples == 0 ? cost
+                       : (1.0 - smoothing) * costPerIteration + smoothing * cost;
+    samples++;
+}
+
+}
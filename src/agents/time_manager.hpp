@@ -0,0 +1,68 @@
+#ifndef TIME_MANAGER_H
+#define TIME_MANAGER_H
+
+#include "bboard.hpp"
+
+namespace agents
+{
+
+/**
+ * @brief The SearchBudget struct is the amount of search a
+ * single step may use
+ */
+struct SearchBudget
+{
+    int milliseconds;
+    int iterations;
+};
+
+/**
+ * Splits the step deadline of the competition into a search
+ * budget. The cost of a single simulation is measured online
+ * (exponential moving average), because it depends heavily on
+ * the board (lots of wood early, lots of bombs late). A fixed
+ * margin is kept for parsing the observation and replying.
+ * Critical positions (bombs nearby, enemies close) get the full
+ * remaining time, quiet ones only a fraction.
+ *
+ * @brief Online calibrated time management for search agents
+ */
+struct TimeManager
+{
+    //////////////
+    // Settings //
+    //////////////
+    float stepDeadline = 100; // ms per step
+    float safetyMargin = 15; // ms for everything except searching
+    float quietFraction = 0.5f; // share of the search time in quiet positions
+    float smoothing = 0.2f; // weight of a new measurement
+    int maxIterations = 1 << 20;
+
+    //////////////
+    // Specific //
+    //////////////
+    double costPerIteration = 0; // ms, 0 means not calibrated yet
+    int samples = 0;
+
+    /**
+     * @brief Criticality Rates a position of an agent from
+     * quiet (0) to critical (1)
+     */
+    static float Criticality(const bboard::State& state, int agentID);
+
+    /**
+     * @brief Plan Returns the budget for the next search
+     */
+    SearchBudget Plan(const bboard::State& state, int agentID) const;
+
+    /**
+     * @brief Record Updates the cost estimate with a finished search
+     * @param iterations Amount of iterations (of a single thread)
+     * @param milliseconds Time the search took
+     */
+    void Record(int iterations, double milliseconds);
+};
+
+}
+
+#endif // TIME_MANAGER_H
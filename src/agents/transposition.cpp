@@ -0,0 +1,140 @@
+#include <cmath>
+#include <algorithm>
+
+#include "transposition.hpp"
+
+namespace agents
+{
+
+const uint64_t TT_VISITS_MAX = (1 << 24) - 1;
+const uint32_t TT_AGE_MASK = (1 << 12) - 1;
+const float TT_VALUE_SCALE = 32767.0f;
+
+inline uint64_t Pack(const TTData& d, uint32_t age)
+{
+    const uint64_t visits = std::min<uint64_t>(uint64_t(std::max(d.visits, 0)), TT_VISITS_MAX);
+    const float v = std::max(-1.0f, std::min(1.0f, d.value));
+    const uint64_t value = uint16_t(int16_t(std::lround(v * TT_VALUE_SCALE)));
+
+    return visits
+           | value << 24
+           | uint64_t(d.move & 0xF) << 40
+           | uint64_t(d.depth & 0xFF) << 44
+           | uint64_t(age & TT_AGE_MASK) << 52;
+}
+
+inline TTData Unpack(uint64_t data)
+{
+    TTData d;
+    d.visits = int(data & TT_VISITS_MAX);
+    d.value = int16_t(uint16_t(data >> 24)) / TT_VALUE_SCALE;
+    d.move = int((data >> 40) & 0xF);
+    d.depth = int((data >> 44) & 0xFF);
+    return d;
+}
+
+inline uint32_t AgeOf(uint64_t data)
+{
+    return uint32_t(data >> 52) & TT_AGE_MASK;
+}
+
+TranspositionTable::TranspositionTable(size_t bytes)
+{
+    size_t count = 1;
+    while(count * 2 * sizeof(TTCluster) <= bytes)
+    {
+        count *= 2;
+    }
+    clusters = std::vector<TTCluster>(count);
+    mask = count - 1;
+    Clear();
+}
+
+bool TranspositionTable::Probe(uint64_t key, TTData& data) const
+{
+    const TTCluster& c = clusters[key & mask];
+    for(const TTEntry& e : c.entries)
+    {
+        const uint64_t d = e.data.load(std::memory_order_relaxed);
+        const uint64_t check = e.check.load(std::memory_order_relaxed);
+        if(d != 0 && (check ^ d) == key)
+        {
+            data = Unpack(d);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::Store(uint64_t key, const TTData& data)
+{
+    const uint32_t currentAge = age.load(std::memory_order_relaxed);
+    TTCluster& c = clusters[key & mask];
+
+    // same key or empty entry, otherwise the least valuable one
+    TTEntry* target = nullptr;
+    int64_t worst = INT64_MAX;
+    for(TTEntry& e : c.entries)
+    {
+        const uint64_t d = e.data.load(std::memory_order_relaxed);
+        if(d == 0 || (e.check.load(std::memory_order_relaxed) ^ d) == key)
+        {
+            target = &e;
+            break;
+        }
+        const uint32_t ageDiff = (currentAge - AgeOf(d)) & TT_AGE_MASK;
+        const int64_t score = int64_t(d & TT_VISITS_MAX) - (int64_t(ageDiff) << 24);
+        if(score < worst)
+        {
+            worst = score;
+            target = &e;
+        }
+    }
+
+    const uint64_t d = Pack(data, currentAge);
+    target->data.store(d, std::memory_order_relaxed);
+    target->check.store(key ^ d, std::memory_order_relaxed);
+}
+
+void TranspositionTable::NewSearch()
+{
+    uint32_t a = (age.load(std::memory_order_relaxed) + 1) & TT_AGE_MASK;
+    // age 0 is reserved, so packed data is never 0 (= empty)
+    age.store(a == 0 ? 1 : a, std::memory_order_relaxed);
+}
+
+void TranspositionTable::Clear()
+{
+    for(TTCluster& c : clusters)
+    {
+        for(TTEntry& e : c.entries)
+        {
+            e.check.store(0, std::memory_order_relaxed);
+            e.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    age.store(1, std::memory_order_relaxed);
+}
+
+size_t TranspositionTable::Capacity() const
+{
+    return clusters.size() * TT_CLUSTER_SIZE;
+}
+
+float TranspositionTable::Usage() const
+{
+    const uint32_t currentAge = age.load(std::memory_order_relaxed);
+    const size_t sample = std::min<size_t>(clusters.size(), 1000);
+    int used = 0;
+    for(size_t i = 0; i < sample; i++)
+    {
+        for(const TTEntry& e : clusters[i].entries)
+        {
+            const uint64_t d = e.data.load(std::memory_order_relaxed);
+            used += d != 0 && AgeOf(d) == currentAge;
+        }
+    }
+    return float(used) / (sample * TT_CLUSTER_SIZE);
+}
+
+}
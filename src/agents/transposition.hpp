@@ -0,0 +1,116 @@
+#ifndef TRANSPOSITION_H
+#define TRANSPOSITION_H
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+
+namespace agents
+{
+
+/**
+ * @brief The TTData struct is the (unpacked) content of a
+ * transposition table entry
+ */
+struct TTData
+{
+    int visits = 0;
+    float value = 0;
+    int move = 0;
+    int depth = 0;
+};
+
+/**
+ * @brief The TTEntry struct holds a packed TTData. The key is
+ * stored as key XOR data, so torn writes from concurrent threads
+ * are detected on probing and treated as a miss.
+ *
+ *   Bit     Semantics
+ * [ 0, 24]  visits (saturated)
+ * [24, 40]  value (fixed point in [-1, 1])
+ * [40, 44]  best move
+ * [44, 52]  depth
+ * [52, 64]  age (search generation)
+ */
+struct TTEntry
+{
+    std::atomic<uint64_t> check;
+    std::atomic<uint64_t> data;
+};
+
+const int TT_CLUSTER_SIZE = 4;
+
+/**
+ * @brief The TTCluster struct groups entries that share a
+ * cache line. A key can only be stored in its own cluster.
+ */
+struct alignas(64) TTCluster
+{
+    TTEntry entries[TT_CLUSTER_SIZE];
+};
+
+static_assert (sizeof(TTCluster) == 64, "A cluster has to fill exactly one cache line");
+
+/**
+ * Fixed-size, lock-free hash table for search results. It can be
+ * shared by any number of threads (and agents). Entries of older
+ * searches (see NewSearch) and entries with few visits are
+ * replaced first.
+ *
+ * @brief Shared transposition table keyed by 64-bit hashes
+ */
+class TranspositionTable
+{
+
+private:
+
+    std::vector<TTCluster> clusters;
+    uint64_t mask = 0;
+    std::atomic<uint32_t> age;
+
+public:
+
+    /**
+     * @param bytes Memory budget. The table uses the largest
+     * power-of-two amount of clusters that fits into the budget.
+     */
+    TranspositionTable(size_t bytes);
+
+    /**
+     * @brief Probe Looks up a key
+     * @return True if a (consistent) entry was found
+     */
+    bool Probe(uint64_t key, TTData& data) const;
+
+    /**
+     * @brief Store Stores data for a key. Replaces the entry
+     * with the same key, an empty entry or the least valuable one.
+     */
+    void Store(uint64_t key, const TTData& data);
+
+    /**
+     * @brief NewSearch Starts a new generation. Entries of older
+     * generations are replaced first.
+     */
+    void NewSearch();
+
+    /**
+     * @brief Clear Removes all entries
+     */
+    void Clear();
+
+    /**
+     * @brief Capacity Returns the amount of entries
+     */
+    size_t Capacity() const;
+
+    /**
+     * @brief Usage Returns the fraction of entries (sampled) that
+     * belong to the current generation
+     */
+    float Usage() const;
+};
+
+}
+
+#endif // TRANSPOSITION_H
@@ -0,0 +1,195 @@
+#include <cmath>
+#include <random>
+#include <limits>
+#include <numeric>
+#include <fstream>
+#include <algorithm>
+
+#include "bboard.hpp"
+#include "jobs.hpp"
+#include "agents.hpp"
+#include "hash.hpp"
+#include "tuner.hpp"
+
+using namespace bboard;
+
+namespace agents
+{
+
+ESTuner::ESTuner(const std::vector<float>& mean, const TunerSettings& settings,
+                 const GameFitness& fitness)
+{
+    this->mean = mean;
+    this->settings = settings;
+    this->settings.population = std::max(2, settings.population & ~1);
+    this->fitness = fitness;
+    best = mean;
+    bestFitness = -std::numeric_limits<float>::max();
+}
+
+float ESTuner::Step()
+{
+    const int dims = int(mean.size());
+    const int pairs = settings.population / 2;
+    const uint64_t genSeed = HashCombine(settings.seed, uint64_t(generation));
+
+    // antithetic perturbations
+    std::mt19937_64 rng(genSeed);
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+    std::vector<std::vector<float>> eps(pairs, std::vector<float>(dims));
+    std::vector<std::vector<float>> candidates(settings.population, std::vector<float>(dims));
+    for(int k = 0; k < pairs; k++)
+    {
+        for(int d = 0; d < dims; d++)
+        {
+            eps[k][d] = normal(rng);
+            const float e = settings.sigma * eps[k][d];
+            candidates[2 * k][d] = std::max(0.0f, std::min(1.0f, mean[d] + e));
+            candidates[2 * k + 1][d] = std::max(0.0f, std::min(1.0f, mean[d] - e));
+        }
+    }
+
+    // the same boards for all candidates
+    std::vector<int> boards(settings.games);
+    for(int g = 0; g < settings.games; g++)
+    {
+        boards[g] = int(HashCombine(genSeed, uint64_t(g)) & 0x7FFFFFFF);
+    }
+
+    // evaluate all (candidate, game) pairs in parallel
+    const int jobs = settings.population * settings.games;
+    std::vector<float> scores(jobs);
+    Jobs().ParallelFor(jobs, settings.threads, [&](int j)
+    {
+        scores[j] = fitness(candidates[j / settings.games], boards[j % settings.games]);
+    });
+
+    std::vector<float> f(settings.population);
+    float genBest = -std::numeric_limits<float>::max();
+    for(int c = 0; c < settings.population; c++)
+    {
+        f[c] = std::accumulate(scores.begin() + c * settings.games,
+                               scores.begin() + (c + 1) * settings.games, 0.0f) / settings.games;
+        genBest = std::max(genBest, f[c]);
+        if(f[c] > bestFitness)
+        {
+            bestFitness = f[c];
+            best = candidates[c];
+        }
+    }
+
+    // centered ranks are robust against the scale of the scores
+    std::vector<int> order(settings.population);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&f](int a, int b)
+    {
+        return f[a] < f[b];
+    });
+    std::vector<float> utility(settings.population);
+    for(int r = 0; r < settings.population; r++)
+    {
+        utility[order[r]] = float(r) / (settings.population - 1) - 0.5f;
+    }
+
+    for(int d = 0; d < dims; d++)
+    {
+        float g = 0;
+        for(int k = 0; k < pairs; k++)
+        {
+            g += (utility[2 * k] - utility[2 * k + 1]) * eps[k][d];
+        }
+        mean[d] += settings.learningRate * settings.sigma * g / pairs;
+        mean[d] = std::max(0.0f, std::min(1.0f, mean[d]));
+    }
+
+    generation++;
+    if(!settings.checkpoint.empty())
+    {
+        Save(settings.checkpoint);
+    }
+    return genBest;
+}
+
+bool ESTuner::Save(const std::string& path) const
+{
+    std::ofstream out(path, std::ios::trunc);
+    out << "es-tuner 1" << std::endl
+        << "generation " << generation << std::endl
+        << "dims " << mean.size() << std::endl
+        << "mean";
+    for(float v : mean)
+    {
+        out << " " << v;
+    }
+    out << std::endl << "best " << bestFitness;
+    for(float v : best)
+    {
+        out << " " << v;
+    }
+    out << std::endl;
+    return bool(out);
+}
+
+bool ESTuner::Load(const std::string& path)
+{
+    std::ifstream in(path);
+    std::string tag;
+    int version, gen;
+    size_t dims;
+    if(!(in >> tag >> version) || tag != "es-tuner" || version != 1
+            || !(in >> tag >> gen) || !(in >> tag >> dims) || dims != mean.size())
+    {
+        return false;
+    }
+
+    std::vector<float> m(dims), b(dims);
+    float bf;
+    in >> tag;
+    for(float& v : m) in >> v;
+    in >> tag >> bf;
+    for(float& v : b) in >> v;
+    if(!in)
+    {
+        return false;
+    }
+
+    generation = gen;
+    mean = m;
+    best = b;
+    bestFitness = bf;
+    return true;
+}
+
+float PlaySimpleAgentGame(const SimpleAgentParams& params, int boardSeed, int maxSteps)
+{
+    std::unique_ptr<State> s = std::make_unique<State>();
+    InitState(s.get(), 0, 1, 2, 3, boardSeed);
+
+    const int seat = boardSeed & 3;
+    SimpleAgent agents[AGENT_COUNT];
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        agents[i].id = i;
+        agents[i].rng.seed(HashCombine(uint64_t(boardSeed), uint64_t(i)));
+    }
+    agents[seat].params = params;
+
+    Move moves[AGENT_COUNT];
+    for(int t = 0; t < maxSteps && s->aliveAgents > 1 && !s->agents[seat].dead; t++)
+    {
+        for(int i = 0; i < AGENT_COUNT; i++)
+        {
+            moves[i] = s->agents[i].dead ? Move::IDLE : agents[i].act(s.get());
+        }
+        Step(s.get(), moves);
+        s->timeStep++;
+    }
+
+    if(s->agents[seat].dead)
+    {
+        return -1.0f;
+    }
+    return s->aliveAgents == 1 ? 1.0f : 0.0f;
+}
+
+}
@@ -0,0 +1,92 @@
+#ifndef TUNER_H
+#define TUNER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+#include "agents.hpp"
+
+namespace agents
+{
+
+/**
+ * @brief The TunerSettings struct configures the ESTuner
+ */
+struct TunerSettings
+{
+    int population = 16; // candidates per generation (antithetic pairs)
+    int games = 32; // games per candidate
+    float sigma = 0.1f; // std. deviation of the perturbations
+    float learningRate = 0.5f;
+    int threads = 4; // parallel games (shared job system)
+    uint64_t seed = 0x1337;
+    std::string checkpoint; // written after every generation (if set)
+};
+
+/**
+ * @brief GameFitness Plays a single game with the given (normalized)
+ * parameters on the given board seed and returns its score
+ */
+typedef std::function<float(const std::vector<float>& params, int boardSeed)> GameFitness;
+
+/**
+ * Natural evolution strategies with antithetic sampling and rank
+ * based fitness shaping. The parameters are normalized to [0, 1].
+ * Every generation draws one set of board seeds that is used for
+ * all candidates (common random numbers), so candidates are
+ * compared on the same games. All games of a generation are
+ * played in parallel.
+ *
+ * @brief Parallel black-box optimizer for agent parameters
+ */
+class ESTuner
+{
+
+private:
+
+    TunerSettings settings;
+    GameFitness fitness;
+
+public:
+
+    std::vector<float> mean;
+    std::vector<float> best;
+    float bestFitness;
+    int generation = 0;
+
+    ESTuner(const std::vector<float>& mean, const TunerSettings& settings,
+            const GameFitness& fitness);
+
+    /**
+     * @brief Step Runs one generation and moves the mean
+     * @return The best candidate fitness of the generation
+     */
+    float Step();
+
+    /**
+     * @brief Save Writes mean, best candidate and generation
+     * @return False if the file could not be written
+     */
+    bool Save(const std::string& path) const;
+
+    /**
+     * @brief Load Continues from a checkpoint
+     * @return False if the file is missing or does not match
+     */
+    bool Load(const std::string& path);
+};
+
+/**
+ * @brief PlaySimpleAgentGame Plays a SimpleAgent with the given
+ * parameters against three default SimpleAgents. The board, the
+ * seat of the candidate and all agent seeds are derived from the
+ * board seed.
+ * @return 1 if the candidate won, -1 if it died, 0 otherwise
+ */
+float PlaySimpleAgentGame(const SimpleAgentParams& params, int boardSeed, int maxSteps = 800);
+
+}
+
+#endif // TUNER_H
@@ -0,0 +1,360 @@
+#include <cmath>
+#include <random>
+#include <numeric>
+#include <algorithm>
+
+#include "bboard.hpp"
+#include "jobs.hpp"
+#include "agents.hpp"
+#include "strategy.hpp"
+#include "hash.hpp"
+#include "value_learner.hpp"
+
+using namespace bboard;
+using namespace bboard::strategy;
+
+namespace agents
+{
+
+const int MAX_HIDDEN = 64;
+
+//////////////
+// Features //
+//////////////
+
+enum FeatureKind
+{
+    BIAS = 1,
+    DEAD,
+    OWN_PATCH,
+    OTHER_PATCH,
+    OTHER_POSITION,
+    DANGER,
+    REACHABLE,
+    REACHABLE_SAFE,
+    STRENGTH,
+    BOMBS_LEFT,
+    CAN_KICK,
+    ALIVE
+};
+
+inline uint64_t Feature(int kind, int a, int b = 0, int c = 0)
+{
+    return HashCombine(HashCombine(HashCombine(uint64_t(kind), uint64_t(a + 64)),
+                                   uint64_t(b + 64)), uint64_t(c + 64));
+}
+
+/**
+ * @brief CellCode Returns a small code for an item, agents are
+ * either "self" (9) or "other" (10)
+ */
+inline int CellCode(const State& s, int x, int y, int agentID)
+{
+    if(util::IsOutOfBounds(x, y))
+    {
+        return Item::RIGID;
+    }
+    const int item = s.board[y][x];
+    if(item >= Item::AGENT0)
+    {
+        return item - Item::AGENT0 == agentID ? 9 : 10;
+    }
+    if(IS_WOOD(item))
+    {
+        return 2;
+    }
+    if(IS_FLAME(item))
+    {
+        return 4;
+    }
+    return item;
+}
+
+/**
+ * @brief Bucket Maps a count to a logarithmic bucket
+ */
+inline int Bucket(int n)
+{
+    int b = 0;
+    while(n > 0)
+    {
+        n >>= 1;
+        b++;
+    }
+    return b;
+}
+
+void ExtractFeatures(const State& s, int agentID, FeatureVector& f)
+{
+    f.count = 0;
+    f.Add(Feature(BIAS, 0));
+
+    const AgentInfo& me = s.agents[agentID];
+    if(me.dead)
+    {
+        f.Add(Feature(DEAD, 0));
+        return;
+    }
+
+    for(int dy = -2; dy <= 2; dy++)
+    {
+        for(int dx = -2; dx <= 2; dx++)
+        {
+            f.Add(Feature(OWN_PATCH, dx, dy, CellCode(s, me.x + dx, me.y + dy, agentID)));
+        }
+    }
+
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        const AgentInfo& other = s.agents[i];
+        if(i == agentID || other.dead || other.x < 0)
+        {
+            continue;
+        }
+        const int rx = std::max(-4, std::min(4, other.x - me.x));
+        const int ry = std::max(-4, std::min(4, other.y - me.y));
+        f.Add(Feature(OTHER_POSITION, rx, ry));
+
+        for(int dy = -1; dy <= 1; dy++)
+        {
+            for(int dx = -1; dx <= 1; dx++)
+            {
+                f.Add(Feature(OTHER_PATCH, dx, dy, CellCode(s, other.x + dx, other.y + dy, agentID)));
+            }
+        }
+    }
+
+    f.Add(Feature(DANGER, IsInDanger(s, agentID)));
+
+    RMap r;
+    FillRMap(s, r, agentID);
+    int reachable = 0, safe = 0;
+    for(int y = 0; y < BOARD_SIZE; y++)
+    {
+        for(int x = 0; x < BOARD_SIZE; x++)
+        {
+            if(IsReachable(r, x, y))
+            {
+                reachable++;
+                safe += IsInDanger(s, x, y) == 0;
+            }
+        }
+    }
+    f.Add(Feature(REACHABLE, Bucket(reachable)));
+    f.Add(Feature(REACHABLE_SAFE, Bucket(safe)));
+
+    f.Add(Feature(STRENGTH, std::min(me.bombStrength, 8)));
+    f.Add(Feature(BOMBS_LEFT, std::min(me.maxBombCount - me.bombCount, 8)));
+    f.Add(Feature(CAN_KICK, int(me.canKick)));
+    f.Add(Feature(ALIVE, s.aliveAgents));
+}
+
+//////////////////
+// ValueLearner //
+//////////////////
+
+ValueLearner::ValueLearner(int bits, int hidden, float learningRate)
+{
+    this->hidden = std::min(hidden, MAX_HIDDEN);
+    this->learningRate = learningRate;
+    mask = (1u << bits) - 1;
+
+    const size_t rows = size_t(1) << bits;
+    const size_t width = size_t(std::max(1, this->hidden));
+    weights.reset(new std::atomic<float>[rows * width]);
+    output.reset(new std::atomic<float>[width + 1]);
+
+    // small random first layer, otherwise all hidden units are equal
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> init(-0.01f, 0.01f);
+    for(size_t i = 0; i < rows * width; i++)
+    {
+        weights[i].store(this->hidden > 0 ? init(rng) : 0.0f, std::memory_order_relaxed);
+    }
+    for(size_t j = 0; j <= width; j++)
+    {
+        output[j].store(this->hidden > 0 ? init(rng) : 0.0f, std::memory_order_relaxed);
+    }
+}
+
+float ValueLearner::Forward(const FeatureVector& f, float* h) const
+{
+    if(hidden == 0)
+    {
+        float z = 0;
+        for(int i = 0; i < f.count; i++)
+        {
+            z += weights[f.index[i] & mask].load(std::memory_order_relaxed);
+        }
+        return z;
+    }
+
+    std::fill(h, h + hidden, 0.0f);
+    for(int i = 0; i < f.count; i++)
+    {
+        const std::atomic<float>* row = &weights[size_t(f.index[i] & mask) * hidden];
+        for(int j = 0; j < hidden; j++)
+        {
+            h[j] += row[j].load(std::memory_order_relaxed);
+        }
+    }
+    float z = output[hidden].load(std::memory_order_relaxed);
+    for(int j = 0; j < hidden; j++)
+    {
+        h[j] = std::max(0.0f, h[j]);
+        z += h[j] * output[j].load(std::memory_order_relaxed);
+    }
+    return z;
+}
+
+float ValueLearner::Predict(const FeatureVector& f) const
+{
+    float h[MAX_HIDDEN];
+    return std::tanh(Forward(f, h));
+}
+
+float ValueLearner::Evaluate(const State& state, int agentID) const
+{
+    FeatureVector f;
+    ExtractFeatures(state, agentID, f);
+    return Predict(f);
+}
+
+inline void AddRelaxed(std::atomic<float>& w, float delta)
+{
+    // racy on purpose (Hogwild), lost updates are tolerated
+    w.store(w.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+float ValueLearner::Update(const FeatureVector& f, float target)
+{
+    float h[MAX_HIDDEN], g[MAX_HIDDEN];
+    const float v = std::tanh(Forward(f, h));
+    const float error = target - v;
+    const float delta = learningRate * error * (1.0f - v * v);
+
+    // the sparse layer step is normalized by the amount of
+    // active features, otherwise it grows with the vector length
+    const float sparse = 1.0f / std::max(1, f.count);
+    if(hidden == 0)
+    {
+        for(int i = 0; i < f.count; i++)
+        {
+            AddRelaxed(weights[f.index[i] & mask], delta * sparse);
+        }
+        return error * error;
+    }
+
+    for(int j = 0; j < hidden; j++)
+    {
+        g[j] = h[j] > 0 ? delta * sparse * output[j].load(std::memory_order_relaxed) : 0.0f;
+        AddRelaxed(output[j], delta * h[j]);
+    }
+    AddRelaxed(output[hidden], delta);
+
+    for(int i = 0; i < f.count; i++)
+    {
+        std::atomic<float>* row = &weights[size_t(f.index[i] & mask) * hidden];
+        for(int j = 0; j < hidden; j++)
+        {
+            if(g[j] != 0.0f)
+            {
+                AddRelaxed(row[j], g[j]);
+            }
+        }
+    }
+    return error * error;
+}
+
+float ValueLearner::Train(const std::vector<ValueSample>& samples, int epochs,
+                          int threads, uint64_t seed)
+{
+    std::vector<int> order(samples.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::mt19937_64 rng(seed);
+
+    threads = std::max(1, threads);
+    std::vector<double> loss(threads);
+    double total = 0;
+    for(int e = 0; e < epochs; e++)
+    {
+        std::shuffle(order.begin(), order.end(), rng);
+
+        auto work = [&](int t)
+        {
+            const size_t begin = order.size() * t / threads;
+            const size_t end = order.size() * (t + 1) / threads;
+            loss[t] = 0;
+            for(size_t i = begin; i < end; i++)
+            {
+                const ValueSample& s = samples[order[i]];
+                loss[t] += Update(s.features, s.target);
+            }
+        };
+
+        Jobs().ParallelFor(threads, threads, work);
+        total = std::accumulate(loss.begin(), loss.end(), 0.0);
+    }
+    return samples.empty() ? 0.0f : float(total / samples.size());
+}
+
+/////////////
+// Samples //
+/////////////
+
+void LabelTrajectory(const std::vector<State>& states, std::vector<ValueSample>& samples)
+{
+    if(states.empty())
+    {
+        return;
+    }
+    const State& last = states.back();
+    for(const State& s : states)
+    {
+        for(int i = 0; i < AGENT_COUNT; i++)
+        {
+            if(s.agents[i].dead)
+            {
+                continue;
+            }
+            ValueSample sample;
+            ExtractFeatures(s, i, sample.features);
+            sample.target = last.agents[i].dead ? -1.0f : (last.aliveAgents == 1 ? 1.0f : 0.0f);
+            samples.push_back(sample);
+        }
+    }
+}
+
+void GenerateValueSamples(int games, std::vector<ValueSample>& samples, int maxSteps, uint64_t seed)
+{
+    std::vector<State> states;
+    for(int g = 0; g < games; g++)
+    {
+        // every game gets its own board and agents
+        const uint64_t gameSeed = HashCombine(seed, uint64_t(g));
+        SimpleAgent agents[AGENT_COUNT] = {
+            SimpleAgent(HashCombine(gameSeed, 1)), SimpleAgent(HashCombine(gameSeed, 2)),
+            SimpleAgent(HashCombine(gameSeed, 3)), SimpleAgent(HashCombine(gameSeed, 4))
+        };
+        states.clear();
+        states.emplace_back();
+        InitState(&states.back(), 0, 1, 2, 3, int(gameSeed));
+
+        Move moves[AGENT_COUNT];
+        for(int t = 0; t < maxSteps && states.back().aliveAgents > 1; t++)
+        {
+            State s = states.back();
+            for(int i = 0; i < AGENT_COUNT; i++)
+            {
+                agents[i].id = i;
+                moves[i] = s.agents[i].dead ? Move::IDLE : agents[i].act(&s);
+            }
+            Step(&s, moves);
+            s.timeStep++;
+            states.push_back(s);
+        }
+        LabelTrajectory(states, samples);
+    }
+}
+
+}
@@ -0,0 +1,137 @@
+#ifndef VALUE_LEARNER_H
+#define VALUE_LEARNER_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#include "bboard.hpp"
+
+namespace agents
+{
+
+const int MAX_FEATURES = 128;
+
+/**
+ * @brief The FeatureVector struct is a sparse binary feature
+ * vector, every active feature is a 32-bit hash
+ */
+struct FeatureVector
+{
+    int count = 0;
+    uint32_t index[MAX_FEATURES];
+
+    void Add(uint64_t hash)
+    {
+        if(count < MAX_FEATURES)
+        {
+            index[count++] = uint32_t(hash);
+        }
+    }
+};
+
+/**
+ * Extracts hashed features of a state from the view of an agent:
+ *
+ * - 5x5 patch around the agent, 3x3 patches around other agents
+ * - positions of the other agents relative to the agent
+ * - danger time (time until a bomb reaches the agent)
+ * - amount of reachable and of reachable safe cells (bucketed)
+ * - power-ups and amount of alive agents
+ *
+ * @brief ExtractFeatures Fills a sparse feature vector
+ */
+void ExtractFeatures(const bboard::State& state, int agentID, FeatureVector& features);
+
+/**
+ * @brief The ValueSample struct is a training example
+ */
+struct ValueSample
+{
+    FeatureVector features;
+    float target; // in [-1, 1]
+};
+
+/**
+ * Value function v = tanh(z) over hashed binary features. Either
+ * linear (z = sum of the active weights) or a small MLP with one
+ * ReLU hidden layer (the first layer is a sparse-dense product:
+ * one dense row per active feature). Trained with SGD on the
+ * squared error.
+ *
+ * All weights are relaxed atomics and are updated without locks
+ * (Hogwild), so any number of threads can train and evaluate
+ * the same model at once.
+ *
+ * @brief Lock-free value function learner
+ */
+class ValueLearner
+{
+
+private:
+
+    int hidden;
+    uint32_t mask;
+    std::unique_ptr<std::atomic<float>[]> weights; // (1 << bits) * max(1, hidden)
+    std::unique_ptr<std::atomic<float>[]> output; // hidden + 1 (bias)
+
+    float Forward(const FeatureVector& f, float* h) const;
+
+public:
+
+    float learningRate;
+
+    /**
+     * @param bits Size of the feature hash table (2^bits)
+     * @param hidden Size of the hidden layer, 0 means linear
+     */
+    ValueLearner(int bits = 20, int hidden = 0, float learningRate = 0.01f);
+
+    /**
+     * @brief Predict Returns the value of a feature vector in [-1, 1]
+     */
+    float Predict(const FeatureVector& features) const;
+
+    /**
+     * @brief Evaluate Extracts the features of a state and
+     * predicts its value for the agent
+     */
+    float Evaluate(const bboard::State& state, int agentID) const;
+
+    /**
+     * @brief Update Does a single SGD step
+     * @return The squared error before the step
+     */
+    float Update(const FeatureVector& features, float target);
+
+    /**
+     * @brief Train Runs epochs of Hogwild SGD over the samples.
+     * Every job (threads in total, run on the shared job system)
+     * works on its own part of a shuffled order.
+     * @return Mean squared error of the last epoch
+     */
+    float Train(const std::vector<ValueSample>& samples, int epochs,
+                int threads, uint64_t seed = 0x1337);
+};
+
+/**
+ * @brief LabelTrajectory Creates one sample per step and alive
+ * agent, labeled with the outcome of the trajectory for that
+ * agent (1 = won, -1 = died, 0 = otherwise). Works with self-play
+ * games as well as with decoded trajectories.
+ */
+void LabelTrajectory(const std::vector<bboard::State>& states,
+                     std::vector<ValueSample>& samples);
+
+/**
+ * @brief GenerateValueSamples Plays games with SimpleAgents and
+ * labels all visited states. The board and agent seeds of every
+ * game are derived from seed (reproducible).
+ */
+void GenerateValueSamples(int games, std::vector<ValueSample>& samples,
+                          int maxSteps = 800, uint64_t seed = 0x1337);
+
+}
+
+#endif // VALUE_LEARNER_H
@@ -0,0 +1,292 @@
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <dirent.h>
+#endif
+
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "arena.hpp"
+
+namespace bboard
+{
+
+// every allocation is preceded by a header (one cache line)
+struct PageHeader
+{
+    void* base;  // start of the mapping
+    size_t size; // size of the mapping
+    size_t bytes;
+    int node;
+    bool huge;
+};
+
+const size_t HEADER_SIZE = 64;
+static_assert(sizeof(PageHeader) <= HEADER_SIZE, "page header too large");
+
+static std::atomic<size_t> nodeBytes[MAX_NUMA_NODES];
+static std::atomic<size_t> hugeBytes(0);
+static std::atomic<size_t> allocations(0);
+
+int NodeCount()
+{
+    static const int count = []()
+    {
+        int nodes = 0;
+#ifdef __linux__
+        if(DIR* dir = opendir("/sys/devices/system/node"))
+        {
+            while(dirent* e = readdir(dir))
+            {
+                if(std::strncmp(e->d_name, "node", 4) == 0 && e->d_name[4] >= '0' && e->d_name[4] <= '9')
+                {
+                    nodes++;
+                }
+            }
+            closedir(dir);
+        }
+#endif
+        return std::max(1, std::min(nodes, MAX_NUMA_NODES));
+    }();
+    return count;
+}
+
+int CurrentNode()
+{
+#if defined(__linux__) && defined(SYS_getcpu)
+    unsigned cpu = 0, node = 0;
+    if(syscall(SYS_getcpu, &cpu, &node, nullptr) == 0 && int(node) < MAX_NUMA_NODES)
+    {
+        return int(node);
+    }
+#endif
+    return 0;
+}
+
+#ifdef __linux__
+
+inline size_t RoundUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+void* MapPages(size_t bytes, HugePages hugePages, void*& base, size_t& size, bool& huge)
+{
+    const size_t pageSize = size_t(sysconf(_SC_PAGESIZE));
+    const int prot = PROT_READ | PROT_WRITE;
+    const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    huge = false;
+
+    if(bytes < HUGE_PAGE_SIZE || hugePages == HugePages::NONE)
+    {
+        size = RoundUp(bytes, pageSize);
+        base = mmap(nullptr, size, prot, flags, -1, 0);
+        return base == MAP_FAILED ? nullptr : base;
+    }
+
+#ifdef MAP_HUGETLB
+    if(hugePages == HugePages::EXPLICIT)
+    {
+        // needs reserved pages (vm.nr_hugepages), otherwise fall through
+        size = RoundUp(bytes, HUGE_PAGE_SIZE);
+        base = mmap(nullptr, size, prot, flags | MAP_HUGETLB, -1, 0);
+        if(base != MAP_FAILED)
+        {
+            huge = true;
+            return base;
+        }
+    }
+#endif
+
+    // over-allocate and trim to get a 2MB aligned region that the
+    // kernel can back with transparent huge pages
+    const size_t length = RoundUp(bytes, HUGE_PAGE_SIZE);
+    uint8_t* raw = static_cast<uint8_t*>(mmap(nullptr, length + HUGE_PAGE_SIZE, prot, flags, -1, 0));
+    if(raw == MAP_FAILED)
+    {
+        return nullptr;
+    }
+    uint8_t* aligned = reinterpret_cast<uint8_t*>(RoundUp(reinterpret_cast<uintptr_t>(raw), HUGE_PAGE_SIZE));
+    if(aligned > raw)
+    {
+        munmap(raw, size_t(aligned - raw));
+    }
+    const size_t tail = size_t(raw + length + HUGE_PAGE_SIZE - (aligned + length));
+    if(tail > 0)
+    {
+        munmap(aligned + length, tail);
+    }
+#ifdef MADV_HUGEPAGE
+    huge = madvise(aligned, length, MADV_HUGEPAGE) == 0;
+#endif
+    base = aligned;
+    size = length;
+    return base;
+}
+
+#endif
+
+void* AllocatePages(size_t bytes, HugePages hugePages, bool prefault)
+{
+    void* base;
+    size_t size;
+    bool huge = false;
+#ifdef __linux__
+    if(!MapPages(bytes + HEADER_SIZE, hugePages, base, size, huge))
+    {
+        return nullptr;
+    }
+#else
+    (void)hugePages;
+    size = bytes + HEADER_SIZE;
+    base = std::aligned_alloc(HEADER_SIZE, (size + HEADER_SIZE - 1) / HEADER_SIZE * HEADER_SIZE);
+    if(!base)
+    {
+        return nullptr;
+    }
+#endif
+
+    uint8_t* data = static_cast<uint8_t*>(base);
+    if(prefault)
+    {
+        // first touch decides the node of every page
+        for(size_t i = 0; i < size; i += 4096)
+        {
+            data[i] = 0;
+        }
+    }
+
+    PageHeader* header = reinterpret_cast<PageHeader*>(data);
+    header->base = base;
+    header->size = size;
+    header->bytes = bytes;
+    header->node = CurrentNode();
+    header->huge = huge;
+
+    nodeBytes[header->node] += bytes;
+    hugeBytes += huge ? bytes : 0;
+    allocations++;
+
+    return data + HEADER_SIZE;
+}
+
+void FreePages(void* memory)
+{
+    if(!memory)
+    {
+        return;
+    }
+    PageHeader* header = reinterpret_cast<PageHeader*>(static_cast<uint8_t*>(memory) - HEADER_SIZE);
+    nodeBytes[header->node] -= header->bytes;
+    hugeBytes -= header->huge ? header->bytes : 0;
+    allocations--;
+
+#ifdef __linux__
+    munmap(header->base, header->size);
+#else
+    std::free(header->base);
+#endif
+}
+
+MemoryStats GetMemoryStats()
+{
+    MemoryStats stats;
+    for(int i = 0; i < MAX_NUMA_NODES; i++)
+    {
+        stats.bytes[i] = nodeBytes[i].load();
+    }
+    stats.hugeBytes = hugeBytes.load();
+    stats.allocations = allocations.load();
+    return stats;
+}
+
+void PrintMemoryStats(std::ostream& out)
+{
+    const MemoryStats stats = GetMemoryStats();
+    out << "Page allocations: " << stats.allocations
+        << ", huge pages: " << stats.hugeBytes / 1024 << " KiB" << std::endl;
+    for(int i = 0; i < NodeCount(); i++)
+    {
+        out << "  node " << i << ": " << stats.bytes[i] / 1024 << " KiB" << std::endl;
+    }
+}
+
+MemoryArena::MemoryArena(size_t chunkSize, HugePages hugePages)
+{
+    this->chunkSize = chunkSize;
+    this->hugePages = hugePages;
+}
+
+MemoryArena::~MemoryArena()
+{
+    for(Chunk& c : chunks)
+    {
+        FreePages(c.data);
+    }
+}
+
+void* MemoryArena::Allocate(size_t bytes, size_t alignment)
+{
+    while(current < chunks.size())
+    {
+        Chunk& c = chunks[current];
+        const size_t start = (offset + alignment - 1) / alignment * alignment;
+        if(start + bytes <= c.size)
+        {
+            offset = start + bytes;
+            return c.data + start;
+        }
+        current++;
+        offset = 0;
+    }
+
+    // chunk data is 64-byte aligned, the header shares the first page
+    const size_t size = std::max(chunkSize - HEADER_SIZE, bytes);
+    uint8_t* data = static_cast<uint8_t*>(AllocatePages(size, hugePages, true));
+    if(!data)
+    {
+        throw std::bad_alloc();
+    }
+    chunks.push_back({data, size});
+    current = chunks.size() - 1;
+    offset = bytes;
+    return data;
+}
+
+void MemoryArena::Reset()
+{
+    current = 0;
+    offset = 0;
+}
+
+size_t MemoryArena::Used() const
+{
+    size_t used = offset;
+    for(size_t i = 0; i < current && i < chunks.size(); i++)
+    {
+        used += chunks[i].size;
+    }
+    return used;
+}
+
+size_t MemoryArena::Reserved() const
+{
+    size_t reserved = 0;
+    for(const Chunk& c : chunks)
+    {
+        reserved += c.size;
+    }
+    return reserved;
+}
+
+MemoryArena& LocalArena()
+{
+    thread_local MemoryArena arena;
+    return arena;
+}
+
+}
@@ -0,0 +1,202 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <new>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace bboard
+{
+
+const int MAX_NUMA_NODES = 8;
+const size_t HUGE_PAGE_SIZE = 2 << 20;
+
+/**
+ * @brief The HugePages enum selects the page backing of large
+ * allocations
+ */
+enum class HugePages
+{
+    NONE = 0,
+    TRANSPARENT, // 2MB aligned + madvise(MADV_HUGEPAGE)
+    EXPLICIT     // MAP_HUGETLB, falls back to TRANSPARENT
+};
+
+/**
+ * @brief The MemoryStats struct counts the live page allocations
+ * per NUMA node (the node of the allocating thread)
+ */
+struct MemoryStats
+{
+    size_t bytes[MAX_NUMA_NODES] = {};
+    size_t hugeBytes = 0; // backed by (transparent or explicit) huge pages
+    size_t allocations = 0;
+};
+
+/**
+ * @brief NodeCount Returns the amount of NUMA nodes (1 if unknown)
+ */
+int NodeCount();
+
+/**
+ * @brief CurrentNode Returns the NUMA node of the calling thread
+ */
+int CurrentNode();
+
+/**
+ * Allocates whole pages directly from the OS. Linux places a
+ * page on the node of the thread that touches it first, so
+ * memory should be touched (prefault) or at least initialized by
+ * the thread that works on it.
+ *
+ * @brief AllocatePages Allocates page-backed memory
+ * @param bytes Usable size
+ * @param hugePages Page backing for allocations of at least
+ * HUGE_PAGE_SIZE bytes
+ * @param prefault Touch every page from the calling thread
+ * @return 64-byte aligned memory (nullptr if the OS refuses)
+ */
+void* AllocatePages(size_t bytes, HugePages hugePages = HugePages::TRANSPARENT,
+                    bool prefault = false);
+
+/**
+ * @brief FreePages Frees memory returned by AllocatePages
+ */
+void FreePages(void* memory);
+
+/**
+ * @brief GetMemoryStats Returns the statistics of all live
+ * page allocations
+ */
+MemoryStats GetMemoryStats();
+
+/**
+ * @brief PrintMemoryStats Prints the per-node statistics
+ */
+void PrintMemoryStats(std::ostream& out);
+
+/**
+ * Chunks are allocated with AllocatePages and prefaulted by the
+ * allocating thread, so every thread that uses its own arena
+ * (see LocalArena) gets memory on its own node. Memory is only
+ * released in bulk (Reset, destructor).
+ *
+ * @brief Bump allocator over page-backed chunks
+ */
+class MemoryArena
+{
+
+private:
+
+    struct Chunk
+    {
+        uint8_t* data;
+        size_t size;
+    };
+
+    std::vector<Chunk> chunks;
+    size_t current = 0; // chunk index
+    size_t offset = 0;  // in the current chunk
+    size_t chunkSize;
+    HugePages hugePages;
+
+public:
+
+    MemoryArena(size_t chunkSize = HUGE_PAGE_SIZE, HugePages hugePages = HugePages::TRANSPARENT);
+    ~MemoryArena();
+
+    MemoryArena(const MemoryArena&) = delete;
+    MemoryArena& operator=(const MemoryArena&) = delete;
+
+    /**
+     * @brief Allocate Returns memory with the given alignment
+     * (at most 64 bytes)
+     */
+    void* Allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * @brief Create Allocates and constructs an array of objects
+     */
+    template<typename T>
+    T* Create(size_t count)
+    {
+        T* p = static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+        for(size_t i = 0; i < count; i++)
+        {
+            new (p + i) T();
+        }
+        return p;
+    }
+
+    /**
+     * @brief Reset Frees all allocations at once (keeps the chunks,
+     * destructors are not called)
+     */
+    void Reset();
+
+    /**
+     * @brief Used Returns the amount of allocated bytes
+     */
+    size_t Used() const;
+
+    /**
+     * @brief Reserved Returns the size of all chunks
+     */
+    size_t Reserved() const;
+};
+
+/**
+ * @brief LocalArena Returns the arena of the calling thread
+ */
+MemoryArena& LocalArena();
+
+/**
+ * Allocates every container buffer with AllocatePages, large
+ * buffers are backed by transparent huge pages. Pages are not
+ * prefaulted, they land on the node of the thread that first
+ * writes to them.
+ *
+ * @brief STL allocator for large, long-living buffers
+ */
+template<typename T>
+struct PageAllocator
+{
+    typedef T value_type;
+
+    PageAllocator() = default;
+    template<typename U>
+    PageAllocator(const PageAllocator<U>&) {}
+
+    T* allocate(size_t n)
+    {
+        void* p = AllocatePages(n * sizeof(T));
+        if(!p)
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t)
+    {
+        FreePages(p);
+    }
+};
+
+template<typename T, typename U>
+inline bool operator==(const PageAllocator<T>&, const PageAllocator<U>&)
+{
+    return true;
+}
+
+template<typename T, typename U>
+inline bool operator!=(const PageAllocator<T>&, const PageAllocator<U>&)
+{
+    return false;
+}
+
+}
+
+#endif // ARENA_H
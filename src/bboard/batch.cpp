@@ -0,0 +1,180 @@
+#include <new>
+#include <algorithm>
+
+#include "batch.hpp"
+#include "jobs.hpp"
+
+namespace bboard
+{
+
+inline int GameSeed(uint64_t seed, int index, uint32_t resets)
+{
+    // splitmix64 finalizer
+    uint64_t z = seed + 0x9E3779B97F4A7C15ULL * (uint64_t(index) << 32 | resets) + 1;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return int((z ^ (z >> 31)) & 0x7FFFFFFF);
+}
+
+BatchEnvironment::BatchEnvironment(const BatchSettings& settings)
+{
+    this->settings = settings;
+    this->settings.shardSize = std::max(1, settings.shardSize);
+
+    const int size = std::max(0, settings.size);
+    const int shardSize = this->settings.shardSize;
+    shards.assign(size_t((size + shardSize - 1) / shardSize), nullptr);
+    done.assign(size_t(size), 0);
+    resets.assign(size_t(size), 0);
+
+    Jobs().ParallelFor(int(shards.size()), [this](int s)
+    {
+        InitShard(s);
+    });
+    for(State* shard : shards)
+    {
+        if(!shard)
+        {
+            Free();
+            throw std::bad_alloc();
+        }
+    }
+}
+
+BatchEnvironment::~BatchEnvironment()
+{
+    Free();
+}
+
+void BatchEnvironment::Free()
+{
+    for(size_t s = 0; s < shards.size(); s++)
+    {
+        if(!shards[s])
+        {
+            continue;
+        }
+        const int count = std::min(settings.shardSize, Size() - int(s) * settings.shardSize);
+        for(int i = 0; i < count; i++)
+        {
+            shards[s][i].~State();
+        }
+        FreePages(shards[s]);
+        shards[s] = nullptr;
+    }
+}
+
+void BatchEnvironment::InitShard(int shard)
+{
+    const int first = shard * settings.shardSize;
+    const int count = std::min(settings.shardSize, Size() - first);
+
+    // prefaulted by the calling worker
+    State* states = static_cast<State*>(AllocatePages(sizeof(State) * size_t(count), settings.hugePages, true));
+    if(!states)
+    {
+        return;
+    }
+    for(int i = 0; i < count; i++)
+    {
+        new (states + i) State();
+    }
+    shards[size_t(shard)] = states;
+
+    for(int i = first; i < first + count; i++)
+    {
+        Reset(i);
+    }
+}
+
+int BatchEnvironment::Size() const
+{
+    return int(done.size());
+}
+
+State& BatchEnvironment::operator[](int index)
+{
+    return shards[size_t(index / settings.shardSize)][index % settings.shardSize];
+}
+
+const State& BatchEnvironment::operator[](int index) const
+{
+    return shards[size_t(index / settings.shardSize)][index % settings.shardSize];
+}
+
+void BatchEnvironment::Reset(int index)
+{
+    State& s = (*this)[index];
+    s = State();
+    const int seed = GameSeed(settings.seed, index, resets[size_t(index)]++);
+    if(settings.generateBoards)
+    {
+        GenerateBoard(s, settings.board, uint64_t(seed), settings.rules);
+    }
+    else
+    {
+        InitState(&s, 0, 1, 2, 3, seed, settings.rules);
+    }
+}
+
+void BatchEnvironment::ResetAll()
+{
+    Jobs().ParallelFor(int(shards.size()), [this](int s)
+    {
+        const int first = s * settings.shardSize;
+        const int last = std::min(first + settings.shardSize, Size());
+        for(int i = first; i < last; i++)
+        {
+            Reset(i);
+            done[size_t(i)] = 0;
+        }
+    });
+}
+
+void BatchEnvironment::Step(const Move* moves)
+{
+    DispatchRules(settings.rules.preset, [this, moves](auto r)
+    {
+        StepShards<decltype(r)>(moves);
+    });
+}
+
+template<class R>
+void BatchEnvironment::StepShards(const Move* moves)
+{
+    Jobs().ParallelFor(int(shards.size()), [this, moves](int s)
+    {
+        const int first = s * settings.shardSize;
+        const int last = std::min(first + settings.shardSize, Size());
+        for(int i = first; i < last; i++)
+        {
+            State& state = shards[size_t(s)][i - first];
+            Move m[AGENT_COUNT];
+            for(int a = 0; a < AGENT_COUNT; a++)
+            {
+                m[a] = moves[i * AGENT_COUNT + a];
+            }
+            bboard::Step<R>(&state, m);
+            state.timeStep++;
+
+            done[size_t(i)] = state.aliveAgents <= 1 || state.timeStep >= settings.maxSteps;
+            if(done[size_t(i)] && settings.autoReset)
+            {
+                Reset(i);
+            }
+        }
+    });
+}
+
+bool BatchEnvironment::Done(int index) const
+{
+    return done[size_t(index)] != 0;
+}
+
+void BatchEnvironment::SetBoardParams(const BoardParams& params)
+{
+    settings.generateBoards = true;
+    settings.board = params;
+}
+
+}
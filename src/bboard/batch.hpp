@@ -0,0 +1,122 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <vector>
+#include <cstdint>
+
+#include "bboard.hpp"
+#include "arena.hpp"
+#include "generator.hpp"
+
+namespace bboard
+{
+
+/**
+ * @brief The BatchSettings struct configures a BatchEnvironment
+ */
+struct BatchSettings
+{
+    // amount of parallel games
+    int size = 256;
+
+    // games per shard (one allocation, one job)
+    int shardSize = 32;
+
+    HugePages hugePages = HugePages::TRANSPARENT;
+
+    // games are initialized with seeds derived from this seed,
+    // the game index and the amount of previous resets
+    uint64_t seed = 0;
+
+    // restart finished games during Step
+    bool autoReset = true;
+
+    // a game is finished after this many steps
+    int maxSteps = 800;
+
+    Rules rules;
+
+    // initialize games with GenerateBoard instead of InitState
+    bool generateBoards = false;
+    BoardParams board;
+};
+
+/**
+ * Every shard of games is allocated, initialized and stepped by a
+ * job of the shared job system, so its pages are first touched (and
+ * placed) on the node of a worker. With work stealing a shard is not
+ * guaranteed to stay on that worker, locality is best-effort unless
+ * the workers are pinned and the load is even.
+ *
+ * @brief Steps a batch of independent games in parallel
+ */
+class BatchEnvironment
+{
+
+private:
+
+    BatchSettings settings;
+    std::vector<State*> shards;
+    std::vector<uint8_t> done;
+    std::vector<uint32_t> resets;
+
+    void InitShard(int shard);
+    void Free();
+
+    template<class R>
+    void StepShards(const Move* moves);
+
+public:
+
+    BatchEnvironment(const BatchSettings& settings = BatchSettings());
+    ~BatchEnvironment();
+
+    BatchEnvironment(const BatchEnvironment&) = delete;
+    BatchEnvironment& operator=(const BatchEnvironment&) = delete;
+
+    /**
+     * @brief Size Returns the amount of games
+     */
+    int Size() const;
+
+    State& operator[](int index);
+    const State& operator[](int index) const;
+
+    /**
+     * @brief Reset Restarts the given game with a fresh board
+     */
+    void Reset(int index);
+
+    /**
+     * @brief ResetAll Restarts every game (in parallel)
+     */
+    void ResetAll();
+
+    /**
+     * Steps every game and advances its time step. Finished games
+     * are restarted if autoReset is enabled.
+     *
+     * @brief Step Steps all games in parallel
+     * @param moves The moves of agent a in game i at moves[i * 4 + a]
+     */
+    void Step(const Move* moves);
+
+    /**
+     * @brief Done Returns true if the last step finished the
+     * given game
+     */
+    bool Done(int index) const;
+
+    /**
+     * Curricula can change the distribution between any two
+     * steps, games that are (auto-)reset afterwards use it.
+     *
+     * @brief SetBoardParams Generates the boards of the following
+     * resets with the given parameters (not thread-safe with Step)
+     */
+    void SetBoardParams(const BoardParams& params);
+};
+
+}
+
+#endif // BATCH_H
@@ -1,9 +1,11 @@
 #include <random>
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include <iostream>
 
 #include "bboard.hpp"
+#include "bitboard.hpp"
 #include "colors.hpp"
 
 namespace bboard
@@ -16,24 +18,26 @@ namespace bboard
 /**
  * @brief SpawnFlameItem Spawns a single flame item on the board
  * @param s The state on which the flames should be spawned
- * @param x The x position of the fire
- * @param y The y position of the fire
+ * @param p The padded index of the fire
  * @param signature An auxiliary integer less than 255
- * @return Could the flame be spawned?
+ * @return Could the flame be spawned? (false for the border)
  */
-inline bool SpawnFlameItem(State& s, int x, int y, uint16_t signature = 0)
+template<class R>
+inline bool SpawnFlameItem(State& s, int p, uint16_t signature = 0)
 {
-    if(s.board[y][x] >= Item::AGENT0)
+    int& item = s.board.cells[p];
+    if(item >= Item::AGENT0)
     {
-        s.Kill(s.board[y][x] - Item::AGENT0);
+        s.Kill(item - Item::AGENT0);
     }
-    if(s.board[y][x] == Item::BOMB || s.board[y][x] >= Item::AGENT0)
+    if(item == Item::BOMB || item >= Item::AGENT0)
     {
+        const Cell c = UnpaddedCell(p);
         for(int i = 0; i < s.bombs.count; i++)
         {
-            if(BMB_POS(s.bombs[i]) == (x + (y << 4)))
+            if(BMB_CELL(s.bombs[i]) == c)
             {
-                s.SpawnFlame(x, y, s.agents[BMB_ID(s.bombs[i])].bombStrength);
+                s.SpawnFlame<R>(CellX(c), CellY(c), s.agents[BMB_ID(s.bombs[i])].bombStrength);
                 s.agents[BMB_ID(s.bombs[i])].bombCount--;
                 s.bombs.RemoveAt(i);
                 break;
@@ -41,14 +45,14 @@ inline bool SpawnFlameItem(State& s, int x, int y, uint16_t signature = 0)
         }
     }
 
-    if(s.board[y][x] != Item::RIGID)
+    if(item != Item::RIGID)
     {
-        int old = s.board[y][x];
+        int old = item;
         bool wasWood = IS_WOOD(old);
-        s.board[y][x] = Item::FLAMES + signature;
+        item = Item::FLAMES + signature;
         if(wasWood)
         {
-            s.board[y][x]+= WOOD_POWFLAG(old); // set the powerup flag
+            item += WOOD_POWFLAG(old); // set the powerup flag
         }
         return !wasWood; // if wood, then only destroy 1
     }
@@ -75,19 +79,6 @@ int ChooseItemOuter(int tmp)
     return Item::PASSAGE;
 }
 
-int ChooseItemInner(int tmp)
-{
-    if(tmp >= 2)
-    {
-        return Item::WOOD;
-    }
-    else if(tmp == 1)
-    {
-        return Item::RIGID;
-    }
-    return Item::PASSAGE;
-}
-
 /**
  * @brief PopBomb A proxy for FixedQueue::PopElem, but also
  * takes care of agent count
@@ -98,21 +89,26 @@ inline void PopBomb(State& state)
     state.bombs.PopElem();
 }
 
-/**
- * @brief IsOutOfBounds Checks wether a given position is out of bounds
- */
-inline bool IsOutOfBounds(const int& x, const int& y)
+///////////////////
+// Board Methods //
+///////////////////
+
+Board::Board()
 {
-    return x < 0 || y < 0 || x >= BOARD_SIZE || y >= BOARD_SIZE;
+    for(int p = 0; p < PADDED_CELL_COUNT; p++)
+    {
+        cells[p] = UnpaddedCell(p) == NO_CELL ? Item::RIGID : Item::PASSAGE;
+    }
 }
 
 ///////////////////
 // State Methods //
 ///////////////////
 
+template<class R>
 void State::PlantBomb(int x, int y, int id, bool setItem)
 {
-    if(agents[id].bombCount >= agents[id].maxBombCount)
+    if(agents[id].bombCount >= std::min(agents[id].maxBombCount, R::MAX_BOMBS))
     {
         return;
     }
@@ -122,7 +118,7 @@ void State::PlantBomb(int x, int y, int id, bool setItem)
     SetBombPosition(*b, x, y);
     SetBombStrength(*b, agents[id].bombStrength);
     // TODO: velocity
-    SetBombTime(*b, BOMB_LIFETIME);
+    SetBombTime(*b, R::BOMB_LIFETIME);
 
     if(setItem)
     {
@@ -136,29 +132,32 @@ void State::PopFlame()
 {
     Flame& f = flames[0];
     const int s = f.strength;
-    int x = f.position.x;
-    int y = f.position.y;
+    const int origin = PaddedIndex(f.cell);
+
+    uint16_t signature = f.cell;
 
-    uint16_t signature = uint16_t(x + BOARD_SIZE * y);
+    int& o = board.cells[origin];
+    if(IS_FLAME(o) && FLAME_ID(o) == signature)
+    {
+        o = FlagItem(FLAME_POWFLAG(o));
+    }
 
-    // iterate over both axis (from x-s to x+s // y-s to y+s)
-    for(int i = -s; i <= s; i++)
+    // the rays of a flame never pass a RIGID cell (including
+    // the border)
+    for(int m = int(Move::UP); m <= int(Move::RIGHT); m++)
     {
-        if(!IsOutOfBounds(x + i, y) && IS_FLAME(board[y][x + i]))
+        const int step = PADDED_STEP[m];
+        for(int i = 1, p = origin + step; i <= s; i++, p += step)
         {
-            // only remove if this is my own flame
-            int b = board[y][x + i];
-            if(FLAME_ID(b) == signature)
+            int& b = board.cells[p];
+            if(b == Item::RIGID)
             {
-                board[y][x + i] = FlagItem(FLAME_POWFLAG(b));
+                break;
             }
-        }
-        if(!IsOutOfBounds(x, y + i) && IS_FLAME(board[y + i][x]))
-        {
-            int b = board[y + i][x];
-            if(FLAME_ID(b) == signature)
+            // only remove if this is my own flame
+            if(IS_FLAME(b) && FLAME_ID(b) == signature)
             {
-                board[y + i][x] = FlagItem(FLAME_POWFLAG(b));
+                b = FlagItem(FLAME_POWFLAG(b));
             }
         }
     }
@@ -175,23 +174,24 @@ Item State::FlagItem(int pwp)
     else              return Item::PASSAGE;
 }
 
+template<class R>
 void State::ExplodeTopBomb()
 {
     Bomb& c = bombs[0];
-    SpawnFlame(BMB_POS_X(c), BMB_POS_Y(c), BMB_STRENGTH(c));
+    SpawnFlame<R>(BMB_POS_X(c), BMB_POS_Y(c), BMB_STRENGTH(c));
     PopBomb(*this);
 }
 
+template<class R>
 void State::SpawnFlame(int x, int y, int strength)
 {
     Flame& f = flames.NextPos();
-    f.position.x = x;
-    f.position.y = y;
+    f.cell = ToCell(x, y);
     f.strength = strength;
-    f.timeLeft = FLAME_LIFETIME;
+    f.timeLeft = R::FLAME_LIFETIME;
 
     // unique flame id
-    uint16_t signature = uint16_t((x + BOARD_SIZE * y) << 3);
+    uint16_t signature = uint16_t(f.cell << 3);
 
     flames.count++;
 
@@ -204,61 +204,52 @@ void State::SpawnFlame(int x, int y, int strength)
     // override origin
     board[y][x] = Item::FLAMES + signature;
 
-    // right
-    for(int i = 1; i <= strength; i++)
-    {
-        if(x + i >= BOARD_SIZE) break; // bounds
-
-        if(!SpawnFlameItem(*this, x + i, y, signature))
-        {
-            break;
-        }
-    }
-
-    // left
-    for(int i = 1; i <= strength; i++)
+    // right, left, down, up (rays end at the border)
+    const int origin = PaddedIndex(f.cell);
+    for(Move m : {Move::RIGHT, Move::LEFT, Move::DOWN, Move::UP})
     {
-        if(x - i < 0) break; // bounds
-
-        if(!SpawnFlameItem(*this, x - i, y, signature))
+        const int step = PADDED_STEP[int(m)];
+        for(int i = 1, p = origin + step; i <= strength; i++, p += step)
         {
-            break;
+            if(!SpawnFlameItem<R>(*this, p, signature))
+            {
+                break;
+            }
         }
     }
+}
 
-    // top
-    for(int i = 1; i <= strength; i++)
-    {
-        if(y + i >= BOARD_SIZE) break; // bounds
+#define INSTANTIATE_STATE_RULES(R) \
+    template void State::PlantBomb<R>(int, int, int, bool); \
+    template void State::ExplodeTopBomb<R>(); \
+    template void State::SpawnFlame<R>(int, int, int);
 
-        if(!SpawnFlameItem(*this, x, y + i, signature))
-        {
-            break;
-        }
-    }
+BBOARD_RULESETS(INSTANTIATE_STATE_RULES)
 
-    // bottom
-    for(int i = 1; i <= strength; i++)
+bool State::HasBomb(int x, int y)
+{
+    for(int i = 0; i < bombs.count; i++)
     {
-        if(y - i < 0) break; // bounds
-
-        if(!SpawnFlameItem(*this, x, y - i, signature))
+        if(BMB_POS_X(bombs[i]) == x && BMB_POS_Y(bombs[i]) == y)
         {
-            break;
+            return true;
         }
     }
+    return false;
 }
 
-bool State::HasBomb(int x, int y)
+void State::UpdateAlive()
 {
-    for(int i = 0; i < bombs.count; i++)
+    aliveAgents = 0;
+    aliveMask = 0;
+    for(int i = 0; i < AGENT_COUNT; i++)
     {
-        if(BMB_POS_X(bombs[i]) == x && BMB_POS_Y(bombs[i]) == y)
+        if(!agents[i].dead)
         {
-            return true;
+            aliveAgents++;
+            aliveMask |= 1 << i;
         }
     }
-    return false;
 }
 
 void State::PutAgent(int x, int y, int agentID)
@@ -287,13 +278,36 @@ void State::PutAgentsInCorners(int a0, int a1, int a2, int a3)
 // bboard namespace //
 //////////////////////
 
-void InitState(State* result, int a0, int a1, int a2, int a3)
+void InitState(State* result, int a0, int a1, int a2, int a3, int seed)
 {
     // Randomly put obstacles
-    InitBoardItems(*result);
+    InitBoardItems(*result, seed);
     result->PutAgentsInCorners(a0, a1, a2, a3);
 }
 
+void InitState(State* result, int a0, int a1, int a2, int a3, int seed, const Rules& rules)
+{
+    InitState(result, a0, a1, a2, a3, seed);
+    // the RuleSet decides, not the (informational) fields of rules
+    const int strength = DispatchRules(rules.preset, [](auto r)
+    {
+        return decltype(r)::BOMB_STRENGTH;
+    });
+    for(AgentInfo& a : result->agents)
+    {
+        a.bombStrength = strength;
+    }
+}
+
+Rules GetRules(RulePreset preset)
+{
+    return DispatchRules(preset, [preset](auto r)
+    {
+        typedef decltype(r) R;
+        return Rules{preset, R::BOMB_LIFETIME, R::FLAME_LIFETIME, R::BOMB_STRENGTH, R::MAX_BOMBS};
+    });
+}
+
 void InitBoardItems(State& result, int seed)
 {
     std::mt19937_64 rng(seed);
@@ -315,15 +329,15 @@ void InitBoardItems(State& result, int seed)
         }
     }
 
-    std::uniform_int_distribution<int> idxSample(0, q.count);
+    std::uniform_int_distribution<int> idxSample(0, q.count - 1);
     std::uniform_int_distribution<int> choosePwp(1, 4);
     int total = 0;
     while(true)
     {
-        int idx = q[idxSample(rng)];
-        if((result.board[0][idx] & 0xFF) == 0)
+        const Cell c = Cell(q[idxSample(rng)]);
+        if((result[c] & 0xFF) == 0)
         {
-            result.board[0][idx] += choosePwp(rng);
+            result[c] += choosePwp(rng);
             total++;
         }
 
@@ -332,6 +346,62 @@ void InitBoardItems(State& result, int seed)
     }
 }
 
+void FogState(const State& state, State& obs, int agentID, int radius)
+{
+    obs = state;
+
+    const AgentInfo& a = state.agents[agentID];
+    const BitBoard view = ViewMask(a.x, a.y, radius);
+
+    const int x0 = std::max(0, a.x - radius);
+    const int x1 = std::min(BOARD_SIZE - 1, a.x + radius);
+    const int y0 = std::max(0, a.y - radius);
+    const int y1 = std::min(BOARD_SIZE - 1, a.y + radius);
+    for(int y = 0; y < BOARD_SIZE; y++)
+    {
+        if(y < y0 || y > y1)
+        {
+            std::fill(obs.board[y], obs.board[y] + BOARD_SIZE, int(Item::FOG));
+            continue;
+        }
+        std::fill(obs.board[y], obs.board[y] + x0, int(Item::FOG));
+        std::fill(obs.board[y] + x1 + 1, obs.board[y] + BOARD_SIZE, int(Item::FOG));
+    }
+
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        const AgentInfo& other = state.agents[i];
+        if(other.dead || other.x < 0 || !HasCell(view, other.x, other.y))
+        {
+            obs.agents[i].x = -1;
+            obs.agents[i].y = -1;
+        }
+    }
+
+    // keep the queue order (bombs and flames are sorted by time)
+    obs.bombs.count = 0;
+    obs.bombs.index = 0;
+    for(int i = 0; i < state.bombs.count; i++)
+    {
+        const Bomb& b = state.bombs[i];
+        if(HasCell(view, BMB_POS_X(b), BMB_POS_Y(b)))
+        {
+            obs.bombs.AddElem(b);
+        }
+    }
+
+    obs.flames.count = 0;
+    obs.flames.index = 0;
+    for(int i = 0; i < state.flames.count; i++)
+    {
+        const Flame& f = state.flames[i];
+        if(HasCell(view, f.cell))
+        {
+            obs.flames.AddElem(f);
+        }
+    }
+}
+
 void StartGame(State* state, Agent* agents[AGENT_COUNT], int timeSteps)
 {
     Move moves[4];
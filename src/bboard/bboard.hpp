@@ -2,6 +2,7 @@
 #define BBOARD_H_
 
 #include <array>
+#include <cstdint>
 #include <string>
 #include <random>
 #include <memory>
@@ -23,9 +24,89 @@ const int BOMB_DEFAULT_STRENGTH = 1;
 
 const int FLAME_LIFETIME = 4;
 
+// State::aliveMask of a game without casualties
+const int ALL_ALIVE = (1 << AGENT_COUNT) - 1;
+
 const int MAX_BOMBS_PER_AGENT = 5;
 const int MAX_BOMBS = AGENT_COUNT * MAX_BOMBS_PER_AGENT;
 
+// agents see everything within this (chebyshev) distance
+const int VIEW_RADIUS = 4;
+
+/**
+ * The rule constants of a preset as a type. Kernels that are
+ * templated on a RuleSet see the constants at compile time, so
+ * the variants cost nothing compared to the standard rules.
+ *
+ * @brief Compile-time rule constants
+ */
+template<int TBombLifetime, int TFlameLifetime, int TBombStrength, int TMaxBombs>
+struct RuleSet
+{
+    static_assert (TBombLifetime > 0 && TBombLifetime < 16, "Bomb timers are stored in 4 bits");
+    static_assert (TFlameLifetime > 0, "Flames have to burn at least one step");
+    static_assert (TMaxBombs > 0 && TMaxBombs <= MAX_BOMBS_PER_AGENT, "The bomb queue is limited");
+
+    static constexpr int BOMB_LIFETIME = TBombLifetime;
+    static constexpr int FLAME_LIFETIME = TFlameLifetime;
+    static constexpr int BOMB_STRENGTH = TBombStrength; // initial strength
+    static constexpr int MAX_BOMBS = TMaxBombs;         // per agent at once
+};
+
+typedef RuleSet<BOMB_LIFETIME, FLAME_LIFETIME, BOMB_DEFAULT_STRENGTH, MAX_BOMBS_PER_AGENT> StandardRules;
+typedef RuleSet<BOMB_LIFETIME, 2, BOMB_DEFAULT_STRENGTH, MAX_BOMBS_PER_AGENT> ShortFlameRules;
+typedef RuleSet<5, 2, 2, 3> FastBombRules;
+
+// calls X(R) for every RuleSet (explicit instantiations)
+#define BBOARD_RULESETS(X) X(StandardRules) X(ShortFlameRules) X(FastBombRules)
+
+/**
+ * @brief The RulePreset enum lists the available rule sets
+ */
+enum class RulePreset
+{
+    STANDARD = 0, // StandardRules
+    SHORT_FLAMES, // ShortFlameRules: flames burn for 2 steps
+    FAST_BOMBS    // FastBombRules: quick games for curricula
+};
+
+/**
+ * The rules of a game, chosen at runtime. The values are taken from
+ * the RuleSet of the preset (use GetRules) and are informational,
+ * changing them has no effect.
+ *
+ * @brief Runtime selection of a RuleSet
+ */
+struct Rules
+{
+    RulePreset preset = RulePreset::STANDARD;
+
+    int bombLifetime = StandardRules::BOMB_LIFETIME;
+    int flameLifetime = StandardRules::FLAME_LIFETIME;
+    int bombStrength = StandardRules::BOMB_STRENGTH;
+    int maxBombs = StandardRules::MAX_BOMBS;
+};
+
+/**
+ * @brief GetRules Returns the rules of the given preset
+ */
+Rules GetRules(RulePreset preset);
+
+/**
+ * @brief DispatchRules Calls f with a (default constructed)
+ * instance of the RuleSet of the given preset
+ */
+template<typename F>
+inline auto DispatchRules(RulePreset preset, F&& f)
+{
+    switch(preset)
+    {
+        case RulePreset::SHORT_FLAMES: return f(ShortFlameRules());
+        case RulePreset::FAST_BOMBS:   return f(FastBombRules());
+        default:                       return f(StandardRules());
+    }
+}
+
 /**
  * Holds all moves an agent can make on a board. An array
  * of 4 moves are necessary to correctly calculate a full
@@ -179,6 +260,145 @@ inline std::ostream & operator<<(std::ostream & str, const Position& v)
     return str;
 }
 
+/**
+ * A board cell as a single index x + BOARD_SIZE * y. This is the
+ * same encoding as the flame signature, the predecessors of an
+ * RMap and the bits of a BitBoard.
+ *
+ * @brief Compact position on the board
+ */
+typedef uint8_t Cell;
+
+const int CELL_COUNT = BOARD_SIZE * BOARD_SIZE;
+
+// out of bounds
+const Cell NO_CELL = 0xFF;
+
+static_assert (CELL_COUNT < NO_CELL, "Cells must fit into 8-bit");
+
+/**
+ * Internally the board is surrounded by a ring of RIGID cells, so
+ * flame rays and searches stop at the border like at any other wall
+ * instead of checking the bounds. A padded index is
+ * (x + 1) + PADDED_SIZE * (y + 1).
+ */
+const int PADDED_SIZE = BOARD_SIZE + 2;
+const int PADDED_CELL_COUNT = PADDED_SIZE * PADDED_SIZE;
+
+// padded index offset of every Move (IDLE and BOMB stay)
+const int PADDED_STEP[6] = {0, -PADDED_SIZE, PADDED_SIZE, -1, 1, 0};
+
+/**
+ * @brief The CellTables struct holds the precomputed coordinates
+ * and neighbors of every cell
+ */
+struct CellTables
+{
+    uint8_t x[CELL_COUNT] = {};
+    uint8_t y[CELL_COUNT] = {};
+
+    // indexed by Move (IDLE and BOMB stay), NO_CELL if out of bounds
+    Cell neighbors[CELL_COUNT][6] = {};
+
+    // bomb position nibbles (x | y << 4) to cells
+    Cell bombCells[256] = {};
+
+    // cells to padded indices and back (NO_CELL on the border)
+    uint8_t padded[CELL_COUNT] = {};
+    Cell unpadded[PADDED_CELL_COUNT] = {};
+};
+
+constexpr CellTables MakeCellTables()
+{
+    CellTables t;
+    for(int i = 0; i < 256; i++)
+    {
+        const int x = i & 0xF, y = i >> 4;
+        t.bombCells[i] = x < BOARD_SIZE && y < BOARD_SIZE ? Cell(x + BOARD_SIZE * y) : NO_CELL;
+    }
+    for(int p = 0; p < PADDED_CELL_COUNT; p++)
+    {
+        t.unpadded[p] = NO_CELL;
+    }
+    for(int c = 0; c < CELL_COUNT; c++)
+    {
+        const int x = c % BOARD_SIZE, y = c / BOARD_SIZE;
+        t.x[c] = uint8_t(x);
+        t.y[c] = uint8_t(y);
+        t.neighbors[c][0] = Cell(c);
+        t.neighbors[c][1] = y > 0 ? Cell(c - BOARD_SIZE) : NO_CELL;
+        t.neighbors[c][2] = y < BOARD_SIZE - 1 ? Cell(c + BOARD_SIZE) : NO_CELL;
+        t.neighbors[c][3] = x > 0 ? Cell(c - 1) : NO_CELL;
+        t.neighbors[c][4] = x < BOARD_SIZE - 1 ? Cell(c + 1) : NO_CELL;
+        t.neighbors[c][5] = Cell(c);
+        t.padded[c] = uint8_t(x + 1 + PADDED_SIZE * (y + 1));
+        t.unpadded[t.padded[c]] = Cell(c);
+    }
+    return t;
+}
+
+constexpr CellTables CELL_TABLES = MakeCellTables();
+
+/**
+ * @brief ToCell Returns the cell at (x, y), which has to be
+ * on the board
+ */
+constexpr Cell ToCell(int x, int y)
+{
+    return Cell(x + BOARD_SIZE * y);
+}
+
+/**
+ * @brief ToCell Returns the cell of a position (NO_CELL if the
+ * position is out of bounds)
+ */
+inline Cell ToCell(const Position& p)
+{
+    return p.x < 0 || p.y < 0 || p.x >= BOARD_SIZE || p.y >= BOARD_SIZE
+           ? NO_CELL : ToCell(p.x, p.y);
+}
+
+inline int CellX(Cell c)
+{
+    return CELL_TABLES.x[c];
+}
+
+inline int CellY(Cell c)
+{
+    return CELL_TABLES.y[c];
+}
+
+inline Position ToPosition(Cell c)
+{
+    return {CellX(c), CellY(c)};
+}
+
+/**
+ * @brief Neighbor Returns the cell reached by the given move
+ * (NO_CELL if it leaves the board)
+ */
+inline Cell Neighbor(Cell c, Move m)
+{
+    return CELL_TABLES.neighbors[c][int(m)];
+}
+
+/**
+ * @brief PaddedIndex Returns the index of a cell in Board::cells
+ */
+inline int PaddedIndex(Cell c)
+{
+    return CELL_TABLES.padded[c];
+}
+
+/**
+ * @brief UnpaddedCell Returns the cell of a padded index (NO_CELL
+ * for the border)
+ */
+inline Cell UnpaddedCell(int padded)
+{
+    return CELL_TABLES.unpadded[padded];
+}
+
 /**
  * @brief The AgentInfo struct holds information ABOUT
  * an agent.
@@ -220,6 +440,7 @@ struct AgentInfo
 #define BMB_ID(x)       (((x) & 0xF00) >> 8)    // [ 8,12]
 #define BMB_STRENGTH(x) (((x) & 0xF000) >> 12)  // [12,16]
 #define BMB_TIME(x)     (((x) & 0xF0000) >> 16) // [16,64]
+#define BMB_CELL(x)     (CELL_TABLES.bombCells[BMB_POS(x)])
 
 /**
  * Represents all information about a single
@@ -251,6 +472,10 @@ inline void SetBombPosition(Bomb& bomb, int x, int y)
 {
     bomb = (bomb & cmask0_4 & cmask4_8) + (x) + (y << 4);
 }
+inline void SetBombCell(Bomb& bomb, Cell cell)
+{
+    SetBombPosition(bomb, CellX(cell), CellY(cell));
+}
 inline void SetBombID(Bomb& bomb, int id)
 {
     bomb = (bomb & cmask8_12) + (id << 8);
@@ -271,11 +496,42 @@ inline void SetBombTime(Bomb& bomb, int time)
  */
 struct Flame
 {
-    Position position;
+    Cell cell;
     int timeLeft = FLAME_LIFETIME;
     int strength;
 };
 
+/**
+ * The items of a board in the padded layout. Rows keep the
+ * usual coordinates: board[y][x] for 0 <= x, y < BOARD_SIZE, while
+ * the rows and columns -1 and BOARD_SIZE are the RIGID border. The
+ * border must never be overwritten.
+ *
+ * @brief The board of a state, surrounded by RIGID sentinels
+ */
+struct Board
+{
+    int cells[PADDED_CELL_COUNT];
+
+    /**
+     * @brief Board Creates an empty board (PASSAGE everywhere)
+     */
+    Board();
+
+    int*       operator[] (int y);
+    const int* operator[] (int y) const;
+};
+
+inline int* Board::operator[] (int y)
+{
+    return cells + PADDED_SIZE * (y + 1) + 1;
+}
+
+inline const int* Board::operator[] (int y) const
+{
+    return cells + PADDED_SIZE * (y + 1) + 1;
+}
+
 /**
  * Represents all information associated with the game board.
  * Includes (in)destructible obstacles, bombs, player positions,
@@ -294,11 +550,23 @@ struct State
      */
     int& operator[] (const Position& pos);
 
-    int board[BOARD_SIZE][BOARD_SIZE];
+    /**
+     * @brief operator [] References the board at the given cell
+     */
+    int& operator[] (Cell cell);
+    int  operator[] (Cell cell) const;
+
+    Board board;
 
     int timeStep = 0;
     int aliveAgents = AGENT_COUNT;
 
+    /**
+     * @brief aliveMask Bit i is set while agent i is alive
+     * (kept in sync with AgentInfo::dead by Kill and UpdateAlive)
+     */
+    int aliveMask = ALL_ALIVE;
+
     /**
      * @brief agents Array of all agents and their properties
      */
@@ -316,12 +584,14 @@ struct State
 
     /**
      * @brief PlantBomb Plants a bomb at the given position.
-     * Does not add a bomb to the queue if the agent maxed out.
+     * Does not add a bomb to the queue if the agent maxed out
+     * (at most R::MAX_BOMBS at once).
      * @param id Agent that plants the bomb
      * @param x X position of the bomb
      * @param y Y position of the bomb
      * @param setItem Should the bomb item be set on that position
      */
+    template<class R = StandardRules>
     void PlantBomb(int x, int y, int id, bool setItem = false);
 
     /**
@@ -329,6 +599,7 @@ struct State
      * queue and subsequently spawns flames. Handles "dead" bombs,
      * edge conditions etc.
      */
+    template<class R = StandardRules>
     void ExplodeTopBomb();
 
     /**
@@ -345,6 +616,7 @@ struct State
      * @param strength The farthest reachable distance
      * from the origin
      */
+    template<class R = StandardRules>
     void SpawnFlame(int x, int y, int strength);
 
     /**
@@ -376,9 +648,16 @@ struct State
         {
             agents[agentID].dead = true;
             aliveAgents--;
+            aliveMask &= ~(1 << agentID);
         }
     }
 
+    /**
+     * @brief UpdateAlive Recomputes aliveAgents and aliveMask
+     * after the dead flags were set directly
+     */
+    void UpdateAlive();
+
     /**
      * Kills all listed agents.
      */
@@ -409,6 +688,66 @@ inline int& State::operator[] (const Position& pos)
     return board[pos.y][pos.x];
 }
 
+inline int& State::operator[] (Cell cell)
+{
+    return board.cells[PaddedIndex(cell)];
+}
+
+inline int State::operator[] (Cell cell) const
+{
+    return board.cells[PaddedIndex(cell)];
+}
+
+/**
+ * @brief The CellChange struct is the new item of a cell
+ */
+struct CellChange
+{
+    Cell cell;
+    int item;
+};
+
+/**
+ * Recorded by Step from what it touches anyway (flames that
+ * burn out, new flames, the bomb queue and the agents), so it
+ * costs O(changes) instead of a diff of the whole board.
+ *
+ * @brief The StepDelta struct holds the changes of a single step
+ */
+struct StepDelta
+{
+    // cells whose item changed (each cell at most once)
+    int changeCount = 0;
+    CellChange changes[CELL_COUNT];
+
+    // bombs that exploded (as they were before the step) and
+    // bombs that were planted (the last ones of State::bombs)
+    int explodedCount = 0;
+    Bomb exploded[MAX_BOMBS];
+    int plantedCount = 0;
+    Bomb planted[MAX_BOMBS];
+
+    // flames that burned out and flames that were spawned (the
+    // last ones of State::flames)
+    int extinguishedCount = 0;
+    Flame extinguished[MAX_BOMBS];
+    int spawnedCount = 0;
+    Flame spawned[MAX_BOMBS];
+
+    // agents that changed their cell (from -> to) or died
+    int movedMask = 0;
+    int diedMask = 0;
+    Cell from[AGENT_COUNT];
+    Cell to[AGENT_COUNT];
+};
+
+/**
+ * @brief ApplyDelta Applies the cell changes and agent moves and
+ * deaths of a delta to the state before the step. Bombs, flames
+ * and power-ups are not updated.
+ */
+void ApplyDelta(State& state, const StepDelta& delta);
+
 /**
  * @brief The Agent struct defines a behaviour. For a given
  * state it will return a Move.
@@ -429,6 +768,18 @@ struct Agent
      * @return A Move (integer, 0-..)
      */
     virtual Move act(const State* state) = 0;
+
+    /**
+     * Only called if the Environment has deltas enabled. An
+     * incremental agent can update its model from the delta
+     * instead of reading the whole state in its next act (a
+     * state with timeStep 0 starts a new game).
+     *
+     * @brief observe Receives the changes of the last step
+     * @param delta The changes from the previous to the current
+     * state
+     */
+    virtual void observe(const StepDelta& /*delta*/) {}
 };
 
 
@@ -457,13 +808,17 @@ private:
     bool threading = false;
     int threadCount = 1;
 
+    Rules rules;
+    std::unique_ptr<StepDelta> delta;
+
 public:
 
     Environment();
     /**
      * @brief MakeGame Initializes the state
+     * @param seed The random seed for the board items
      */
-    void MakeGame(std::array<Agent*, AGENT_COUNT> a);
+    void MakeGame(std::array<Agent*, AGENT_COUNT> a, int seed = 0x1337);
 
     /**
      * @brief StartGame starts a game and prints in the terminal output
@@ -496,6 +851,29 @@ public:
      */
     State& GetState() const;
 
+    /**
+     * @brief SetRules Sets the rules of the following games
+     * (call before MakeGame)
+     */
+    void SetRules(const Rules& rules);
+
+    /**
+     * @brief GetRules Returns the rules of the current game
+     */
+    const Rules& GetRules() const;
+
+    /**
+     * @brief SetDeltas Enables or disables the StepDelta of
+     * every step, the agents receive it via Agent::observe
+     */
+    void SetDeltas(bool enabled);
+
+    /**
+     * @brief GetDelta Returns the changes of the last step
+     * (nullptr if deltas are disabled)
+     */
+    const StepDelta* GetDelta() const;
+
     /**
      * @brief SetAgents Registers all agents that will participate
      * in this game
@@ -548,8 +926,27 @@ void InitBoardItems(State& state, int seed = 0x1337);
  * @param a1 Agent no. that should be top right
  * @param a2 Agent no. that should be bottom right
  * @param a3 Agent no. that should be bottom left
+ * @param seed The random seed for the board items
+ */
+void InitState(State* state, int a0, int a1, int a2, int a3, int seed = 0x1337);
+
+/**
+ * @brief InitState Same as above, the agents start with the
+ * bomb strength of the RuleSet of rules.preset
+ */
+void InitState(State* state, int a0, int a1, int a2, int a3, int seed, const Rules& rules);
+
+/**
+ * @brief FogState Creates the observation of an agent. Every cell
+ * outside the agent's view becomes Item::FOG, bombs and flames
+ * outside the view are dropped and hidden agents get the
+ * position (-1, -1). Dead flags stay visible.
+ * @param state The full state
+ * @param obs The fogged observation (output)
+ * @param agentID The observing agent
+ * @param radius The view radius
  */
-void InitState(State* state, int a0, int a1, int a2, int a3);
+void FogState(const State& state, State& obs, int agentID, int radius = VIEW_RADIUS);
 
 /**
  * @brief Applies given moves to the given board state.
@@ -558,6 +955,25 @@ void InitState(State* state, int a0, int a1, int a2, int a3);
  */
 void Step(State* state, Move* moves);
 
+/**
+ * @brief Step Applies the moves with the rules of the preset
+ * (dispatches to the specialized Step<R>)
+ */
+void Step(State* state, Move* moves, const Rules& rules);
+
+/**
+ * @brief Step Same as above, also records the changes of the
+ * step in the delta
+ */
+void Step(State* state, Move* moves, const Rules& rules, StepDelta& delta);
+
+/**
+ * @brief Step Applies the moves with the given RuleSet. Every
+ * RuleSet of BBOARD_RULESETS is instantiated.
+ */
+template<class R>
+void Step(State* state, Move* moves);
+
 /**
  * @brief StartGame starts a game and prints in the terminal output
  * (blocking)
@@ -0,0 +1,204 @@
+#include <limits>
+#include <algorithm>
+
+#include "bboard.hpp"
+#include "belief.hpp"
+#include "step_utility.hpp"
+
+namespace bboard
+{
+
+/**
+ * @brief MergeByTime Merges two time-sorted queues into one
+ * (queue order is the explosion/extinguish order)
+ */
+template<typename T, int N, typename Time>
+void MergeByTime(const FixedQueue<T, N>& a, const FixedQueue<T, N>& b,
+                 FixedQueue<T, N>& result, Time time)
+{
+    result.index = 0;
+    result.count = 0;
+    int i = 0, j = 0;
+    while(i < a.count || j < b.count)
+    {
+        if(j >= b.count || (i < a.count && time(a[i]) <= time(b[j])))
+        {
+            result.AddElem(a[i++]);
+        }
+        else
+        {
+            result.AddElem(b[j++]);
+        }
+    }
+}
+
+void BeliefState::Reset(int agentID)
+{
+    this->agentID = agentID;
+    state = State();
+    for(int y = 0; y < BOARD_SIZE; y++)
+    {
+        std::fill(state.board[y], state.board[y] + BOARD_SIZE, int(Item::FOG));
+    }
+    state.PutAgentsInCorners(0, 1, 2, 3);
+
+    seen = 0;
+    visible = 0;
+    std::fill(lastSeen, lastSeen + AGENT_COUNT, -1);
+}
+
+void BeliefState::Update(const State& obs)
+{
+    // predict what happened to remembered bombs and flames
+    while(state.timeStep < obs.timeStep)
+    {
+        util::TickFlames(state);
+        util::TickBombs(state);
+        state.timeStep++;
+    }
+    state.timeStep = obs.timeStep;
+
+    const AgentInfo& me = obs.agents[agentID];
+    if(me.x < 0)
+    {
+        // dead agents don't observe anything
+        for(int i = 0; i < AGENT_COUNT; i++)
+        {
+            state.agents[i].dead = obs.agents[i].dead;
+        }
+        state.UpdateAlive();
+        return;
+    }
+
+    const int x0 = std::max(0, me.x - VIEW_RADIUS);
+    const int x1 = std::min(BOARD_SIZE - 1, me.x + VIEW_RADIUS);
+    const int y0 = std::max(0, me.y - VIEW_RADIUS);
+    const int y1 = std::min(BOARD_SIZE - 1, me.y + VIEW_RADIUS);
+    visible = ViewMask(me.x, me.y, VIEW_RADIUS);
+    seen |= visible;
+
+    for(int y = y0; y <= y1; y++)
+    {
+        std::copy(&obs.board[y][x0], &obs.board[y][x1] + 1, &state.board[y][x0]);
+    }
+
+    // observed bombs and flames replace the remembered ones in view
+    FixedQueue<Bomb, MAX_BOMBS> bombs;
+    for(int i = 0; i < state.bombs.count; i++)
+    {
+        const Bomb& b = state.bombs[i];
+        if(!HasCell(visible, BMB_POS_X(b), BMB_POS_Y(b)))
+        {
+            bombs.AddElem(b);
+        }
+    }
+    MergeByTime(bombs, obs.bombs, state.bombs, [](const Bomb& b)
+    {
+        return BMB_TIME(b);
+    });
+
+    FixedQueue<Flame, MAX_BOMBS> flames;
+    for(int i = 0; i < state.flames.count; i++)
+    {
+        const Flame& f = state.flames[i];
+        if(!HasCell(visible, f.cell))
+        {
+            flames.AddElem(f);
+        }
+    }
+    MergeByTime(flames, obs.flames, state.flames, [](const Flame& f)
+    {
+        return f.timeLeft;
+    });
+
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        AgentInfo& b = state.agents[i];
+        const AgentInfo& o = obs.agents[i];
+
+        // remove the agent from its outdated position
+        const bool moved = o.x >= 0 && (o.x != b.x || o.y != b.y);
+        if((moved || o.dead) && b.x >= 0 && !HasCell(visible, b.x, b.y)
+                && state.board[b.y][b.x] == Item::AGENT0 + i)
+        {
+            if(state.HasBomb(b.x, b.y))
+            {
+                state.board[b.y][b.x] = Item::BOMB;
+            }
+            else
+            {
+                state.board[b.y][b.x] = HasCell(seen, b.x, b.y) ? Item::PASSAGE : Item::FOG;
+            }
+        }
+
+        if(o.x >= 0)
+        {
+            b = o;
+            lastSeen[i] = obs.timeStep;
+        }
+        b.dead = o.dead;
+    }
+    state.UpdateAlive();
+}
+
+void BeliefState::Sample(State& out, std::mt19937_64& rng) const
+{
+    out = state;
+
+    // same distribution as InitBoardItems
+    std::uniform_int_distribution<int> itemDist(0, 6);
+    std::uniform_int_distribution<int> flagDist(0, 7);
+    ForEachCell(BoardMask() & ~seen, [&](int x, int y)
+    {
+        if(out.board[y][x] != Item::FOG)
+        {
+            return;
+        }
+        const int tmp = itemDist(rng);
+        if(tmp == 1)
+        {
+            out.board[y][x] = Item::RIGID;
+        }
+        else if(tmp == 2)
+        {
+            const int flag = flagDist(rng);
+            out.board[y][x] = Item::WOOD + (flag < 3 ? flag + 1 : 0);
+        }
+        else
+        {
+            out.board[y][x] = Item::PASSAGE;
+        }
+    });
+
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        AgentInfo& a = out.agents[i];
+        if(i == agentID || a.dead || (a.x >= 0 && out.board[a.y][a.x] == Item::AGENT0 + i))
+        {
+            continue;
+        }
+
+        // the last known position is outdated, assume the
+        // agent went to the closest hidden free cell
+        int best = std::numeric_limits<int>::max();
+        Position target = {a.x, a.y};
+        for(int y = 0; y < BOARD_SIZE; y++)
+        {
+            for(int x = 0; x < BOARD_SIZE; x++)
+            {
+                const int d = std::abs(x - a.x) + std::abs(y - a.y);
+                if(d < best && !HasCell(visible, x, y) && out.board[y][x] == Item::PASSAGE)
+                {
+                    best = d;
+                    target = {x, y};
+                }
+            }
+        }
+        if(best != std::numeric_limits<int>::max())
+        {
+            out.PutAgent(target.x, target.y, i);
+        }
+    }
+}
+
+}
@@ -0,0 +1,79 @@
+#ifndef BELIEF_H
+#define BELIEF_H
+
+#include <random>
+
+#include "bboard.hpp"
+#include "bitboard.hpp"
+
+namespace bboard
+{
+
+/**
+ * @brief The BeliefState struct remembers everything an agent has
+ * seen under fog of war. Each fogged observation (see FogState) is
+ * merged in incrementally:
+ *
+ * - Cells in view are copied, cells out of view keep their last
+ *   known content (destroyed wood, powerups, wood powerup flags)
+ * - Remembered bombs and flames out of view keep ticking, so
+ *   their explosions are predicted on the remembered board
+ *   (which also reveals powerups of remembered wood)
+ * - Enemies out of view stay at their last known position
+ *
+ * Cells that were never seen remain Item::FOG. Use Sample to get
+ * a fully determinized State for search.
+ */
+struct BeliefState
+{
+    /**
+     * @brief state The merged belief. Never seen cells are FOG
+     */
+    State state;
+
+    /**
+     * @brief seen All cells that were observed at least once
+     */
+    BitBoard seen = 0;
+
+    /**
+     * @brief visible The cells of the last observation
+     */
+    BitBoard visible = 0;
+
+    /**
+     * @brief lastSeen The time step at which each agent was seen
+     * the last time (-1 if never)
+     */
+    int lastSeen[AGENT_COUNT];
+
+    int agentID = -1;
+
+    /**
+     * @brief Reset Forgets everything. Agents are assumed to be
+     * in their starting corners (see Environment::MakeGame)
+     * @param agentID The agent that owns this belief
+     */
+    void Reset(int agentID);
+
+    /**
+     * @brief Update Merges a fogged observation into the belief.
+     * Advances remembered bombs and flames up to obs.timeStep first.
+     * @param obs An observation created with FogState
+     */
+    void Update(const State& obs);
+
+    /**
+     * @brief Sample Creates a determinized state that is consistent
+     * with the belief. Never seen cells are drawn from the board
+     * generator's distribution, enemies whose last known position
+     * was contradicted are moved to the closest hidden free cell.
+     * @param out The determinized state (output)
+     * @param rng The random generator used for sampling
+     */
+    void Sample(State& out, std::mt19937_64& rng) const;
+};
+
+}
+
+#endif // BELIEF_H
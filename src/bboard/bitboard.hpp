@@ -0,0 +1,143 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include "bboard.hpp"
+
+namespace bboard
+{
+
+static_assert (BOARD_SIZE * BOARD_SIZE <= 128, "Board must fit into 128 bits");
+
+/**
+ * @brief BitBoard One bit per board cell. Cell (x, y) maps to
+ * bit x + BOARD_SIZE * y. Relies on the GCC 128-bit integer
+ * extension, so all mask operations are a handful of instructions.
+ */
+typedef unsigned __int128 BitBoard;
+
+/**
+ * @brief CellBit Returns the bitboard with only (x, y) set
+ */
+inline BitBoard CellBit(int x, int y)
+{
+    return BitBoard(1) << (x + BOARD_SIZE * y);
+}
+
+/**
+ * @brief HasCell Returns true if (x, y) is set in the mask
+ */
+inline bool HasCell(const BitBoard& b, int x, int y)
+{
+    return (b >> (x + BOARD_SIZE * y)) & 1;
+}
+
+/**
+ * @brief HasCell Returns true if the cell is set in the mask
+ */
+inline bool HasCell(const BitBoard& b, Cell c)
+{
+    return (b >> c) & 1;
+}
+
+/**
+ * @brief BoardMask Returns the mask with every board cell set
+ */
+inline BitBoard BoardMask()
+{
+    return (BitBoard(1) << (BOARD_SIZE * BOARD_SIZE)) - 1;
+}
+
+/**
+ * @brief PopCount Counts the cells set in the mask
+ */
+inline int PopCount(const BitBoard& b)
+{
+    return __builtin_popcountll(uint64_t(b)) + __builtin_popcountll(uint64_t(b >> 64));
+}
+
+/**
+ * @brief ForEachCell Invokes f(x, y) for every cell set in the
+ * mask, ordered by index
+ */
+template<typename F>
+inline void ForEachCell(BitBoard b, F f)
+{
+    for(int half = 0; half < 2; half++)
+    {
+        uint64_t bits = uint64_t(b >> (64 * half));
+        while(bits)
+        {
+            const int idx = 64 * half + __builtin_ctzll(bits);
+            f(CellX(Cell(idx)), CellY(Cell(idx)));
+            bits &= bits - 1;
+        }
+    }
+}
+
+/**
+ * @brief ColumnMask Returns the mask of all cells in column x
+ */
+constexpr BitBoard ColumnMask(int x)
+{
+    BitBoard result = 0;
+    for(int y = 0; y < BOARD_SIZE; y++)
+    {
+        result |= BitBoard(1) << (x + BOARD_SIZE * y);
+    }
+    return result;
+}
+
+// cells that can be reached with a step to the right (left)
+const BitBoard NOT_LEFT_COLUMN = ((BitBoard(1) << (BOARD_SIZE * BOARD_SIZE)) - 1) & ~ColumnMask(0);
+const BitBoard NOT_RIGHT_COLUMN = ((BitBoard(1) << (BOARD_SIZE * BOARD_SIZE)) - 1) & ~ColumnMask(BOARD_SIZE - 1);
+
+/**
+ * @brief Dilate Adds the 4-neighbors of every cell to the mask
+ */
+inline BitBoard Dilate(const BitBoard& b)
+{
+    return (b | (b << BOARD_SIZE) | (b >> BOARD_SIZE)
+            | ((b << 1) & NOT_LEFT_COLUMN) | ((b >> 1) & NOT_RIGHT_COLUMN)) & BoardMask();
+}
+
+/**
+ * @brief FloodFill Returns all cells of the open mask that are
+ * connected to the seed cells (over 4-neighbors)
+ */
+inline BitBoard FloodFill(BitBoard seed, const BitBoard& open)
+{
+    seed &= open;
+    while(true)
+    {
+        const BitBoard next = Dilate(seed) & open;
+        if(next == seed)
+        {
+            return seed;
+        }
+        seed = next;
+    }
+}
+
+/**
+ * @brief ViewMask Returns the square of cells within the given
+ * (chebyshev) radius around (x, y), clipped at the board edges.
+ */
+inline BitBoard ViewMask(int x, int y, int radius)
+{
+    const int x0 = std::max(0, x - radius);
+    const int x1 = std::min(BOARD_SIZE - 1, x + radius);
+    const int y0 = std::max(0, y - radius);
+    const int y1 = std::min(BOARD_SIZE - 1, y + radius);
+
+    const BitBoard row = ((BitBoard(1) << (x1 - x0 + 1)) - 1) << x0;
+    BitBoard result = 0;
+    for(int i = y0; i <= y1; i++)
+    {
+        result |= row << (BOARD_SIZE * i);
+    }
+    return result;
+}
+
+}
+
+#endif // BITBOARD_H
@@ -0,0 +1,463 @@
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+
+#include "serialization.hpp"
+#include "dataset.hpp"
+
+namespace bboard
+{
+
+// blocks per write call
+const int MAX_WRITE_BLOCKS = 512;
+
+static inline size_t RoundUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+static std::atomic<uint64_t> writerIds(1);
+
+struct LocalBuffer
+{
+    uint64_t writer = 0;
+    void* buffer = nullptr;
+};
+
+// last used buffer of this thread (avoids the lookup)
+thread_local LocalBuffer localBuffer;
+
+DatasetWriter::DatasetWriter(const DatasetSettings& settings)
+    : id(writerIds++)
+{
+    this->settings = settings;
+    this->settings.blockSize = RoundUp(std::max<size_t>(settings.blockSize, 1), DATASET_ALIGNMENT);
+    this->settings.shardSize = std::max(settings.shardSize, this->settings.blockSize);
+
+    mkdir(settings.directory.c_str(), 0755);
+    writer = std::thread(&DatasetWriter::WriterLoop, this);
+}
+
+DatasetWriter::~DatasetWriter()
+{
+    Close();
+}
+
+DatasetWriter::ThreadBuffer& DatasetWriter::Local()
+{
+    if(localBuffer.writer == id)
+    {
+        return *static_cast<ThreadBuffer*>(localBuffer.buffer);
+    }
+
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    std::unique_ptr<ThreadBuffer>& b = buffers[std::this_thread::get_id()];
+    if(!b)
+    {
+        b = std::make_unique<ThreadBuffer>();
+    }
+    localBuffer = {id, b.get()};
+    return *b;
+}
+
+DatasetWriter::Block* DatasetWriter::Acquire(size_t bytes)
+{
+    const size_t capacity = std::max(settings.blockSize, RoundUp(bytes, DATASET_ALIGNMENT));
+    {
+        std::unique_lock<std::mutex> lock(poolMutex);
+        if(capacity == settings.blockSize)
+        {
+            auto available = [&]()
+            {
+                // never wait if no block is in flight (it would
+                // not come back)
+                return !pool.empty() || allocated + capacity <= settings.maxMemory || pending == 0;
+            };
+            if(!available())
+            {
+                stalls++;
+                while(!poolCondition.wait_for(lock, std::chrono::milliseconds(1), available));
+            }
+            if(!pool.empty())
+            {
+                Block* b = pool.back();
+                pool.pop_back();
+                b->size = 0;
+                return b;
+            }
+        }
+        allocated += capacity;
+    }
+
+    uint8_t* data = static_cast<uint8_t*>(std::aligned_alloc(DATASET_ALIGNMENT, capacity));
+    if(!data)
+    {
+        throw std::bad_alloc();
+    }
+    return new Block{data, capacity, 0};
+}
+
+void DatasetWriter::Release(Block* block)
+{
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        if(block->capacity == settings.blockSize && !closed)
+        {
+            pool.push_back(block);
+            block = nullptr;
+        }
+        else
+        {
+            allocated -= block->capacity;
+        }
+    }
+    poolCondition.notify_one();
+
+    if(block)
+    {
+        std::free(block->data);
+        delete block;
+    }
+}
+
+void DatasetWriter::Submit(Block* block)
+{
+    if(block->size == 0)
+    {
+        Release(block);
+        return;
+    }
+
+    // a zero header pads up to the next block boundary
+    const size_t padded = RoundUp(block->size, DATASET_ALIGNMENT);
+    std::memset(block->data + block->size, 0, padded - block->size);
+    block->size = padded;
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        queue.push_back(block);
+        pending++;
+    }
+    queueCondition.notify_one();
+}
+
+void DatasetWriter::Append(const void* data, size_t size)
+{
+    if(size == 0)
+    {
+        return;
+    }
+
+    const size_t bytes = 4 + RoundUp(size, 4);
+    ThreadBuffer& b = Local();
+    std::lock_guard<std::mutex> lock(b.mutex);
+
+    if(b.block && b.block->size + bytes > b.block->capacity)
+    {
+        Submit(b.block);
+        b.block = nullptr;
+    }
+    if(!b.block)
+    {
+        b.block = Acquire(bytes);
+    }
+
+    uint8_t* out = b.block->data + b.block->size;
+    const uint32_t header = uint32_t(size);
+    std::memcpy(out, &header, 4);
+    std::memcpy(out + 4, data, size);
+    std::memset(out + 4 + size, 0, bytes - 4 - size);
+
+    b.block->size += bytes;
+    b.records++;
+    b.recordBytes += size;
+}
+
+void DatasetWriter::Append(const State& state)
+{
+    uint8_t buffer[MAX_SERIALIZED_SIZE];
+    Append(buffer, Serialize(state, buffer));
+}
+
+bool DatasetWriter::OpenShard()
+{
+    char name[16];
+    std::snprintf(name, sizeof(name), "-%05d.bin", int(shards.size()));
+    const std::string path = settings.directory + "/" + settings.prefix + name;
+
+    const int flags = O_WRONLY | O_CREAT | O_TRUNC;
+    fd = -1;
+    direct = false;
+#ifdef O_DIRECT
+    if(settings.direct)
+    {
+        fd = open(path.c_str(), flags | O_DIRECT, 0644);
+        direct = fd != -1;
+    }
+#endif
+    if(fd == -1)
+    {
+        fd = open(path.c_str(), flags, 0644);
+    }
+    if(fd == -1)
+    {
+        return false;
+    }
+
+    shards.push_back(path);
+    shardBytes = 0;
+    return true;
+}
+
+void DatasetWriter::CloseShard()
+{
+    if(fd == -1)
+    {
+        return;
+    }
+    if(settings.sync != SyncPolicy::NONE && fsync(fd) != 0)
+    {
+        failed = true;
+    }
+    close(fd);
+    fd = -1;
+}
+
+void DatasetWriter::WriterLoop()
+{
+    std::vector<Block*> batch;
+    std::vector<iovec> iov;
+    while(true)
+    {
+        batch.clear();
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this]()
+            {
+                return !queue.empty() || stop;
+            });
+            if(queue.empty())
+            {
+                break;
+            }
+
+            size_t total = 0;
+            while(!queue.empty() && int(batch.size()) < MAX_WRITE_BLOCKS
+                  && (batch.empty() || total + queue.front()->size <= settings.writeSize))
+            {
+                total += queue.front()->size;
+                batch.push_back(queue.front());
+                queue.pop_front();
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(fileMutex);
+            size_t i = 0;
+            while(i < batch.size() && !failed)
+            {
+                if(fd != -1 && shardBytes > 0 && shardBytes + batch[i]->size > settings.shardSize)
+                {
+                    CloseShard();
+                }
+                if(fd == -1 && !OpenShard())
+                {
+                    failed = true;
+                    break;
+                }
+
+                // consecutive blocks that fit into the shard
+                iov.clear();
+                size_t bytes = 0;
+                for(; i < batch.size(); i++)
+                {
+                    if(bytes > 0 && shardBytes + bytes + batch[i]->size > settings.shardSize)
+                    {
+                        break;
+                    }
+                    iov.push_back({batch[i]->data, batch[i]->size});
+                    bytes += batch[i]->size;
+                }
+
+                size_t done = 0, first = 0;
+                while(done < bytes)
+                {
+                    const ssize_t n = pwritev(fd, iov.data() + first, int(iov.size() - first),
+                                              off_t(shardBytes + done));
+                    if(n < 0 && errno == EINTR)
+                    {
+                        continue;
+                    }
+                    if(n <= 0)
+                    {
+                        failed = true;
+                        break;
+                    }
+                    writes++;
+                    done += size_t(n);
+
+                    // skip the written parts of a partial write
+                    for(size_t rest = size_t(n); rest > 0;)
+                    {
+                        const size_t m = std::min(rest, iov[first].iov_len);
+                        iov[first].iov_base = static_cast<uint8_t*>(iov[first].iov_base) + m;
+                        iov[first].iov_len -= m;
+                        rest -= m;
+                        if(iov[first].iov_len == 0)
+                        {
+                            first++;
+                        }
+                    }
+                }
+                shardBytes += done;
+                writtenBytes += done;
+
+                if(settings.sync == SyncPolicy::WRITE && fdatasync(fd) != 0)
+                {
+                    failed = true;
+                }
+            }
+        }
+
+        for(Block* b : batch)
+        {
+            Release(b);
+        }
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            pending -= batch.size();
+        }
+        writtenCondition.notify_all();
+    }
+}
+
+bool DatasetWriter::Flush()
+{
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        for(auto& kv : buffers)
+        {
+            ThreadBuffer& b = *kv.second;
+            std::lock_guard<std::mutex> bufferLock(b.mutex);
+            if(b.block)
+            {
+                Submit(b.block);
+                b.block = nullptr;
+            }
+        }
+    }
+    {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        writtenCondition.wait(lock, [this]()
+        {
+            return pending == 0;
+        });
+    }
+    if(settings.sync != SyncPolicy::NONE)
+    {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        if(fd != -1 && fdatasync(fd) != 0)
+        {
+            failed = true;
+        }
+    }
+    return !failed;
+}
+
+bool DatasetWriter::Close()
+{
+    if(closed)
+    {
+        return !failed;
+    }
+    Flush();
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stop = true;
+    }
+    queueCondition.notify_all();
+    writer.join();
+    CloseShard();
+
+    std::lock_guard<std::mutex> lock(poolMutex);
+    closed = true;
+    for(Block* b : pool)
+    {
+        std::free(b->data);
+        delete b;
+    }
+    pool.clear();
+    allocated = 0;
+    return !failed;
+}
+
+DatasetStats DatasetWriter::Stats()
+{
+    DatasetStats stats;
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        for(auto& kv : buffers)
+        {
+            std::lock_guard<std::mutex> bufferLock(kv.second->mutex);
+            stats.records += kv.second->records;
+            stats.recordBytes += kv.second->recordBytes;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        stats.stalls = stalls;
+    }
+    {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        stats.shards = shards.size();
+        stats.direct = direct;
+    }
+    stats.writtenBytes = writtenBytes;
+    stats.writes = writes;
+    return stats;
+}
+
+const std::vector<std::string>& DatasetWriter::Shards() const
+{
+    return shards;
+}
+
+bool ReadRecords(const std::string& path, const std::function<void(const uint8_t*, size_t)>& f)
+{
+    std::ifstream in(path, std::ios::binary);
+    if(!in)
+    {
+        return false;
+    }
+    const std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    size_t pos = 0;
+    while(pos + 4 <= data.size())
+    {
+        uint32_t size;
+        std::memcpy(&size, data.data() + pos, 4);
+        if(size == 0)
+        {
+            pos = RoundUp(pos + 1, DATASET_ALIGNMENT);
+            continue;
+        }
+        if(pos + 4 + size > data.size())
+        {
+            return false;
+        }
+        f(data.data() + pos + 4, size);
+        pos += 4 + RoundUp(size, 4);
+    }
+    return pos == data.size();
+}
+
+}
@@ -0,0 +1,213 @@
+#ifndef DATASET_H
+#define DATASET_H
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <condition_variable>
+
+#include "bboard.hpp"
+
+namespace bboard
+{
+
+// alignment of blocks in memory and on disk (O_DIRECT)
+const size_t DATASET_ALIGNMENT = 4096;
+
+/**
+ * @brief The SyncPolicy enum defines when written data is
+ * forced to the disk
+ */
+enum class SyncPolicy
+{
+    NONE = 0, // leave it to the OS
+    SHARD,    // fsync finished shards (and on Flush/Close)
+    WRITE     // fdatasync after every write call
+};
+
+/**
+ * @brief The DatasetSettings struct configures a DatasetWriter
+ */
+struct DatasetSettings
+{
+    // shards are called <directory>/<prefix>-<index>.bin
+    std::string directory = ".";
+    std::string prefix = "dataset";
+
+    // size of a per-thread buffer (rounded up to DATASET_ALIGNMENT)
+    size_t blockSize = 1 << 20;
+
+    // upper bound for the bytes of a single write call
+    size_t writeSize = 16 << 20;
+
+    // a new shard is started before a shard grows beyond this size
+    size_t shardSize = size_t(1) << 30;
+
+    // memory for all buffers, appending threads only wait when
+    // the writer falls this far behind
+    size_t maxMemory = 256 << 20;
+
+    // bypass the page cache (falls back to buffered writes if the
+    // file system does not support it)
+    bool direct = false;
+
+    SyncPolicy sync = SyncPolicy::SHARD;
+};
+
+/**
+ * @brief The DatasetStats struct summarizes the work of a writer
+ */
+struct DatasetStats
+{
+    size_t records = 0;
+    size_t recordBytes = 0;  // payload
+    size_t writtenBytes = 0; // including headers and padding
+    size_t writes = 0;       // write calls
+    size_t shards = 0;
+    size_t stalls = 0;       // appends that had to wait for memory
+    bool direct = false;     // O_DIRECT is in use
+};
+
+/**
+ * Shards are sequences of records:
+ *
+ *   4 bytes  payload size n (little endian), 0 = padding
+ *   n bytes  payload, zero padded to a multiple of 4 bytes
+ *
+ * A padding record fills the rest of a DATASET_ALIGNMENT block,
+ * the next record starts at the following block boundary.
+ *
+ * Every thread appends into its own buffer. Full buffers are
+ * padded to the block alignment and handed to a background thread
+ * that writes them (several at once) with pwritev and swaps them
+ * back into a pool. Appending never waits for the disk, only for
+ * memory once maxMemory is exhausted (counted as stall).
+ *
+ * Records of one thread keep their order, records of different
+ * threads are interleaved at buffer granularity.
+ *
+ * @brief Asynchronous, double-buffered writer of record shards
+ */
+class DatasetWriter
+{
+
+private:
+
+    struct Block
+    {
+        uint8_t* data;
+        size_t capacity;
+        size_t size;
+    };
+
+    struct ThreadBuffer
+    {
+        std::mutex mutex;
+        Block* block = nullptr;
+        size_t records = 0;
+        size_t recordBytes = 0;
+    };
+
+    DatasetSettings settings;
+    const uint64_t id;
+
+    // per-thread buffers
+    std::mutex buffersMutex;
+    std::unordered_map<std::thread::id, std::unique_ptr<ThreadBuffer>> buffers;
+
+    // block pool
+    std::mutex poolMutex;
+    std::condition_variable poolCondition;
+    std::vector<Block*> pool;
+    size_t allocated = 0;
+    size_t stalls = 0;
+
+    // full blocks
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::condition_variable writtenCondition;
+    std::deque<Block*> queue;
+    std::atomic<size_t> pending{0};
+    bool stop = false;
+
+    // file state (writer thread)
+    std::mutex fileMutex;
+    int fd = -1;
+    size_t shardBytes = 0;
+    bool direct = false;
+    std::vector<std::string> shards;
+    std::atomic<bool> failed{false};
+    std::atomic<size_t> writtenBytes{0};
+    std::atomic<size_t> writes{0};
+
+    std::thread writer;
+    bool closed = false;
+
+    ThreadBuffer& Local();
+    Block* Acquire(size_t bytes);
+    void Release(Block* block);
+    void Submit(Block* block);
+    bool OpenShard();
+    void CloseShard();
+    void WriterLoop();
+
+public:
+
+    DatasetWriter(const DatasetSettings& settings = DatasetSettings());
+    ~DatasetWriter();
+
+    DatasetWriter(const DatasetWriter&) = delete;
+    DatasetWriter& operator=(const DatasetWriter&) = delete;
+
+    /**
+     * @brief Append Adds a record (thread-safe). Empty records
+     * are not stored.
+     */
+    void Append(const void* data, size_t size);
+
+    /**
+     * @brief Append Adds a serialized state (thread-safe)
+     */
+    void Append(const State& state);
+
+    /**
+     * @brief Flush Submits the buffers of all threads and waits
+     * until everything was written (and synced, see SyncPolicy)
+     * @return False if a write failed
+     */
+    bool Flush();
+
+    /**
+     * @brief Close Flushes and closes the writer, further appends
+     * are not allowed. Called by the destructor.
+     * @return False if a write failed
+     */
+    bool Close();
+
+    /**
+     * @brief Stats Returns the statistics (thread-safe)
+     */
+    DatasetStats Stats();
+
+    /**
+     * @brief Shards Returns the paths of all shards (call after Close)
+     */
+    const std::vector<std::string>& Shards() const;
+};
+
+/**
+ * @brief ReadRecords Calls f for every record of a shard
+ * @return False if the file can't be read or is malformed
+ */
+bool ReadRecords(const std::string& path, const std::function<void(const uint8_t*, size_t)>& f);
+
+}
+
+#endif // DATASET_H
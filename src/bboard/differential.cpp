@@ -0,0 +1,341 @@
+#include <iomanip>
+#include <algorithm>
+
+#include "bboard.hpp"
+#include "reference.hpp"
+#include "serialization.hpp"
+#include "differential.hpp"
+
+namespace bboard
+{
+
+const char* const MOVE_NAMES[] = {"IDLE", "UP", "DOWN", "LEFT", "RIGHT", "BOMB"};
+
+/**
+ * @brief PlaceAgent Puts the agent on a free cell of the area,
+ * clears a cell if there is none
+ */
+void PlaceAgent(State& state, int id, int ox, int oy, int size, std::mt19937_64& rng)
+{
+    int x = 0, y = 0;
+    for(int attempt = 0; attempt < 32; attempt++)
+    {
+        x = ox + int(rng() % size);
+        y = oy + int(rng() % size);
+        if(state.board[y][x] == Item::PASSAGE)
+        {
+            break;
+        }
+    }
+    if(state.board[y][x] >= Item::AGENT0)
+    {
+        // occupied by an agent, take any free cell
+        for(int i = 0; i < BOARD_SIZE * BOARD_SIZE; i++)
+        {
+            x = i % BOARD_SIZE;
+            y = i / BOARD_SIZE;
+            if(state.board[y][x] < Item::AGENT0) break;
+        }
+    }
+    state.PutAgent(x, y, id);
+}
+
+void RandomDiffState(State& state, std::mt19937_64& rng)
+{
+    state = State();
+    InitState(&state, 0, 1, 2, 3, int(rng() & 0x7FFFFFFF));
+
+    // crowd the agents in a small area to provoke collisions
+    if(rng() % 2 == 0)
+    {
+        const int size = 3 + int(rng() % 4);
+        const int ox = int(rng() % (BOARD_SIZE - size + 1));
+        const int oy = int(rng() % (BOARD_SIZE - size + 1));
+        for(int i = 0; i < AGENT_COUNT; i++)
+        {
+            state.board[state.agents[i].y][state.agents[i].x] = Item::PASSAGE;
+        }
+        for(int i = 0; i < AGENT_COUNT; i++)
+        {
+            PlaceAgent(state, i, ox, oy, size, rng);
+        }
+    }
+
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        AgentInfo& a = state.agents[i];
+        a.maxBombCount = 1 + int(rng() % 3);
+        a.bombStrength = 1 + int(rng() % 4);
+        a.canKick = rng() % 4 == 0;
+
+        if(rng() % 10 == 0 && state.aliveAgents > 1)
+        {
+            state.Kill(i);
+            state.board[a.y][a.x] = Item::PASSAGE;
+        }
+    }
+
+    // bombs (the queue is sorted by the remaining time)
+    struct PendingBomb { int x, y, id, time; };
+    std::vector<PendingBomb> pending;
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        const AgentInfo& a = state.agents[i];
+        const int count = a.dead ? 0 : int(rng() % (a.maxBombCount + 1));
+        for(int b = 0; b < count; b++)
+        {
+            int x = a.x, y = a.y;
+            if(b > 0 || rng() % 2 == 0)
+            {
+                x = std::min(BOARD_SIZE - 1, std::max(0, a.x + int(rng() % 7) - 3));
+                y = std::min(BOARD_SIZE - 1, std::max(0, a.y + int(rng() % 7) - 3));
+            }
+            const bool free = state.board[y][x] == Item::PASSAGE
+                              || state.board[y][x] == Item::AGENT0 + i;
+            const bool taken = std::any_of(pending.begin(), pending.end(), [x, y](const PendingBomb& p)
+            {
+                return p.x == x && p.y == y;
+            });
+            if(free && !taken)
+            {
+                pending.push_back({x, y, i, 1 + int(rng() % BOMB_LIFETIME)});
+            }
+        }
+    }
+    std::stable_sort(pending.begin(), pending.end(), [](const PendingBomb& l, const PendingBomb& r)
+    {
+        return l.time < r.time;
+    });
+    for(const PendingBomb& p : pending)
+    {
+        state.PlantBomb(p.x, p.y, p.id, state.board[p.y][p.x] == Item::PASSAGE);
+        SetBombTime(state.bombs[state.bombs.count - 1], p.time);
+    }
+}
+
+int CheckLockstep(const DiffCase& c, StepFunction step, std::string* diff)
+{
+    State state = c.initial;
+    reference::State ref;
+    reference::FromState(state, ref);
+
+    for(size_t t = 0; t < c.moves.size(); t++)
+    {
+        MoveSet m = c.moves[t];
+        step(&state, m.data());
+        reference::Step(ref, c.moves[t].data());
+
+        if(!reference::Compare(state, ref))
+        {
+            if(diff)
+            {
+                reference::Compare(state, ref, diff);
+            }
+            return int(t);
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Mismatch Like CheckLockstep, but only counts mismatches
+ * of cases where dead agents are IDLE
+ */
+int Mismatch(const DiffCase& c, StepFunction step)
+{
+    const int k = CheckLockstep(c, step);
+    if(k < 0)
+    {
+        return -1;
+    }
+
+    reference::State ref;
+    reference::FromState(c.initial, ref);
+    for(int t = 0; t <= k; t++)
+    {
+        for(int i = 0; i < AGENT_COUNT; i++)
+        {
+            if(ref.agents[i].dead && c.moves[t][i] != Move::IDLE)
+            {
+                return -1;
+            }
+        }
+        reference::Step(ref, c.moves[t].data());
+    }
+    return k;
+}
+
+void MinimizeCase(DiffCase& c, StepFunction step)
+{
+    int k = CheckLockstep(c, step);
+    if(k < 0)
+    {
+        return;
+    }
+    c.moves.resize(size_t(k) + 1);
+
+    // shorten the prefix
+    reference::State ref;
+    DiffCase shorter;
+    while(c.moves.size() > 1)
+    {
+        reference::FromState(c.initial, ref);
+        reference::Step(ref, c.moves[0].data());
+        reference::ToState(ref, shorter.initial);
+        shorter.moves.assign(c.moves.begin() + 1, c.moves.end());
+
+        k = Mismatch(shorter, step);
+        if(k < 0)
+        {
+            break;
+        }
+        shorter.moves.resize(size_t(k) + 1);
+        c = shorter;
+    }
+
+    // idle as many moves as possible
+    for(size_t t = 0; t < c.moves.size(); t++)
+    {
+        for(int i = 0; i < AGENT_COUNT && t < c.moves.size(); i++)
+        {
+            const Move m = c.moves[t][i];
+            if(m == Move::IDLE)
+            {
+                continue;
+            }
+            c.moves[t][i] = Move::IDLE;
+            k = Mismatch(c, step);
+            if(k < 0)
+            {
+                c.moves[t][i] = m;
+            }
+            else
+            {
+                c.moves.resize(size_t(k) + 1);
+            }
+        }
+    }
+}
+
+DiffResult CheckCase(const DiffCase& c, StepFunction step, bool minimize)
+{
+    DiffResult result;
+    const int k = CheckLockstep(c, step);
+    result.steps = k < 0 ? long(c.moves.size()) : k + 1;
+    if(k >= 0)
+    {
+        result.mismatch = true;
+        result.reproduction = c;
+        if(minimize)
+        {
+            MinimizeCase(result.reproduction, step);
+        }
+        result.reproduction.moves.resize(size_t(CheckLockstep(result.reproduction, step, &result.diff)) + 1);
+    }
+    return result;
+}
+
+DiffResult RunDifferential(const DiffSettings& settings)
+{
+    DiffResult result;
+    std::mt19937_64 rng(settings.seed);
+
+    DiffCase c;
+    State state;
+    reference::State ref;
+    for(int g = 0; g < settings.games; g++)
+    {
+        RandomDiffState(c.initial, rng);
+        c.moves.clear();
+        state = c.initial;
+        reference::FromState(state, ref);
+
+        for(int t = 0; t < settings.steps && ref.aliveAgents > 0; t++)
+        {
+            MoveSet m;
+            const uint64_t r = rng();
+            for(int i = 0; i < AGENT_COUNT; i++)
+            {
+                m[i] = ref.agents[i].dead ? Move::IDLE : Move((r >> (8 * i)) % 6);
+            }
+            c.moves.push_back(m);
+
+            MoveSet copy = m;
+            settings.step(&state, copy.data());
+            reference::Step(ref, m.data());
+            result.steps++;
+
+            if(!reference::Compare(state, ref))
+            {
+                const long steps = result.steps;
+                result = CheckCase(c, settings.step, settings.minimize);
+                result.steps = steps;
+                return result;
+            }
+        }
+    }
+    return result;
+}
+
+void PrintReproduction(const DiffResult& result, std::ostream& out)
+{
+    if(!result.mismatch)
+    {
+        out << "No mismatch in " << result.steps << " steps" << std::endl;
+        return;
+    }
+
+    const State& s = result.reproduction.initial;
+    out << "Step mismatch after " << result.reproduction.moves.size() << " step(s)" << std::endl;
+    out << "Initial state (time step " << s.timeStep << "):" << std::endl;
+    for(int y = 0; y < BOARD_SIZE; y++)
+    {
+        for(int x = 0; x < BOARD_SIZE; x++)
+        {
+            out << PrintItem(s.board[y][x]);
+        }
+        out << std::endl;
+    }
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        const AgentInfo& a = s.agents[i];
+        out << "  agent " << i << ": " << Position{a.x, a.y}
+            << " bombs " << a.bombCount << "/" << a.maxBombCount
+            << " strength " << a.bombStrength << " kick " << a.canKick
+            << (a.dead ? " dead" : "") << std::endl;
+    }
+    for(int i = 0; i < s.bombs.count; i++)
+    {
+        const Bomb b = s.bombs[i];
+        out << "  bomb " << i << ": " << Position{BMB_POS_X(b), BMB_POS_Y(b)}
+            << " id " << BMB_ID(b) << " strength " << BMB_STRENGTH(b)
+            << " time " << BMB_TIME(b) << std::endl;
+    }
+    for(int i = 0; i < s.flames.count; i++)
+    {
+        const Flame& f = s.flames[i];
+        out << "  flame " << i << ": " << ToPosition(f.cell) << " strength " << f.strength
+            << " time " << f.timeLeft << std::endl;
+    }
+
+    out << "Serialized: " << std::hex << std::setfill('0');
+    for(uint8_t byte : Serialize(s))
+    {
+        out << std::setw(2) << int(byte);
+    }
+    out << std::dec << std::setfill(' ') << std::endl;
+
+    out << "Moves:" << std::endl;
+    for(size_t t = 0; t < result.reproduction.moves.size(); t++)
+    {
+        out << "  " << t << ":";
+        for(Move m : result.reproduction.moves[t])
+        {
+            out << " " << MOVE_NAMES[int(m)];
+        }
+        out << std::endl;
+    }
+    out << "Differences (actual vs. reference):" << std::endl << result.diff;
+}
+
+}
@@ -0,0 +1,116 @@
+#ifndef DIFFERENTIAL_H
+#define DIFFERENTIAL_H
+
+#include <array>
+#include <random>
+#include <string>
+#include <vector>
+#include <ostream>
+
+#include "bboard.hpp"
+
+namespace bboard
+{
+
+/**
+ * @brief StepFunction Signature of a Step implementation
+ */
+typedef void (*StepFunction)(State* state, Move* moves);
+
+typedef std::array<Move, AGENT_COUNT> MoveSet;
+
+/**
+ * @brief The DiffCase struct is a reproducible scenario: an
+ * initial state and the moves of every step
+ */
+struct DiffCase
+{
+    State initial;
+    std::vector<MoveSet> moves;
+};
+
+/**
+ * @brief The DiffResult struct holds the outcome of a
+ * differential run
+ */
+struct DiffResult
+{
+    // amount of compared steps
+    long steps = 0;
+
+    bool mismatch = false;
+
+    // (minimized) reproduction of the first mismatch. The
+    // mismatch occurs after the last step of the case
+    DiffCase reproduction;
+    std::string diff;
+};
+
+/**
+ * @brief The DiffSettings struct configures RunDifferential
+ */
+struct DiffSettings
+{
+    // the implementation under test
+    StepFunction step = &Step;
+
+    int games = 1000;
+    int steps = 100;
+    uint64_t seed = 0;
+
+    bool minimize = true;
+};
+
+/**
+ * Fills the state with a random but consistent position: a seeded
+ * board, agents that are (possibly) moved close to each other,
+ * random power-ups, dead agents and bombs with random timers.
+ *
+ * @brief RandomDiffState Creates a random initial state
+ */
+void RandomDiffState(State& state, std::mt19937_64& rng);
+
+/**
+ * Runs the implementation under test and the frozen reference
+ * (see reference.hpp) in lockstep and compares the full states
+ * after every step.
+ *
+ * @brief CheckLockstep Compares step against the reference
+ * @param diff If not null, receives the differences of the mismatch
+ * @return The index of the first mismatching step or -1
+ */
+int CheckLockstep(const DiffCase& c, StepFunction step, std::string* diff = nullptr);
+
+/**
+ * Shortens the prefix (the initial state is advanced with the
+ * reference), drops all steps after the mismatch and replaces as
+ * many moves as possible with IDLE.
+ *
+ * @brief MinimizeCase Minimizes a mismatching case in place
+ */
+void MinimizeCase(DiffCase& c, StepFunction step);
+
+/**
+ * @brief CheckCase Checks a (replayed) case and minimizes the
+ * mismatch, if there is one
+ */
+DiffResult CheckCase(const DiffCase& c, StepFunction step, bool minimize = true);
+
+/**
+ * Plays random games (random states, random moves, dead agents
+ * always IDLE) and stops at the first mismatch.
+ *
+ * @brief RunDifferential Checks a step implementation against the
+ * reference
+ */
+DiffResult RunDifferential(const DiffSettings& settings);
+
+/**
+ * @brief PrintReproduction Prints the reproduction of a mismatch
+ * (state, serialized state, moves and differences)
+ */
+void PrintReproduction(const DiffResult& result, std::ostream& out);
+
+}
+
+#endif // DIFFERENTIAL_H
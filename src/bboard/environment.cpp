@@ -49,9 +49,16 @@ Environment::Environment()
     state = std::make_unique<State>();
 }
 
-void Environment::MakeGame(std::array<Agent*, AGENT_COUNT> a)
+void Environment::MakeGame(std::array<Agent*, AGENT_COUNT> a, int seed)
 {
-    bboard::InitState(state.get(), 0, 1, 2, 3);
+    // start from a clean state, games can be restarted
+    *state = State();
+    finished = false;
+    isDraw = false;
+    agentWon = -1;
+    teamWon = -1;
+
+    bboard::InitState(state.get(), 0, 1, 2, 3, seed, rules);
 
     state->PutAgentsInCorners(0, 1, 2, 3);
 
@@ -81,11 +88,11 @@ void Environment::StartGame(int timeSteps, bool render, bool stepByStep)
     PrintGameResult(*this);
 }
 
-void ProxyAct(Move& writeBack, Agent& agent, State& state)
-{
-    writeBack = agent.act(&state);
-}
-
+/**
+ * @brief CollectMovesAsync Lets all living agents act at the same
+ * time, every agent on its own thread (agents search on the
+ * shared job system themselves)
+ */
 void CollectMovesAsync(Move m[AGENT_COUNT], Environment& e)
 {
     std::thread threads[AGENT_COUNT];
@@ -93,16 +100,16 @@ void CollectMovesAsync(Move m[AGENT_COUNT], Environment& e)
     {
         if(!e.GetState().agents[i].dead)
         {
-            threads[i] = std::thread(ProxyAct,
-                                     std::ref(m[i]),
-                                     std::ref(*e.GetAgent(i)),
-                                     std::ref(e.GetState()));
+            threads[i] = std::thread([&m, &e, i]()
+            {
+                m[i] = e.GetAgent(i)->act(&e.GetState());
+            });
         }
     }
     Pause(true); //competitive pause
     for(uint i = 0; i < AGENT_COUNT; i++)
     {
-        if(!e.GetState().agents[i].dead)
+        if(threads[i].joinable())
         {
             threads[i].join();
         }
@@ -135,9 +142,24 @@ void Environment::Step(bool competitiveTimeLimit)
     }
 
 
-    bboard::Step(state.get(), m);
+    if(delta)
+    {
+        bboard::Step(state.get(), m, rules, *delta);
+    }
+    else
+    {
+        bboard::Step(state.get(), m, rules);
+    }
     state->timeStep++;
 
+    if(delta)
+    {
+        for(uint i = 0; i < AGENT_COUNT; i++)
+        {
+            agents[i]->observe(*delta);
+        }
+    }
+
     if(state->aliveAgents == 1)
     {
         finished = true;
@@ -164,6 +186,33 @@ void Environment::Print(bool clear)
     PrintState(state.get());
 }
 
+void Environment::SetRules(const Rules& rules)
+{
+    this->rules = rules;
+}
+
+const Rules& Environment::GetRules() const
+{
+    return rules;
+}
+
+void Environment::SetDeltas(bool enabled)
+{
+    if(!enabled)
+    {
+        delta.reset();
+    }
+    else if(!delta)
+    {
+        delta = std::make_unique<StepDelta>();
+    }
+}
+
+const StepDelta* Environment::GetDelta() const
+{
+    return delta.get();
+}
+
 State& Environment::GetState() const
 {
     return *state.get();
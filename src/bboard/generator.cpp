@@ -0,0 +1,186 @@
+#include <algorithm>
+
+#include "generator.hpp"
+#include "bitboard.hpp"
+
+namespace bboard
+{
+
+/**
+ * @brief The SplitMix struct is a small and fast generator
+ * (splitmix64), one call per cell
+ */
+struct SplitMix
+{
+    uint64_t state;
+
+    uint64_t Next()
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+};
+
+/**
+ * @brief Threshold Converts a probability to a bound for 32
+ * random bits
+ */
+inline uint64_t Threshold(float p)
+{
+    return uint64_t(double(std::min(1.0f, std::max(0.0f, p))) * 4294967296.0);
+}
+
+/**
+ * @brief Images Writes the cells that are symmetric to (x, y),
+ * including the cell itself
+ * @return The amount of cells
+ */
+int Images(int x, int y, Symmetry symmetry, Cell* out)
+{
+    const int n = BOARD_SIZE - 1;
+    int count = 0;
+    out[count++] = ToCell(x, y);
+    switch(symmetry)
+    {
+        case Symmetry::MIRROR:
+            out[count++] = ToCell(n - x, y);
+            break;
+        case Symmetry::POINT:
+            out[count++] = ToCell(n - x, n - y);
+            break;
+        case Symmetry::ROTATION:
+            out[count++] = ToCell(n - y, x);
+            out[count++] = ToCell(n - x, n - y);
+            out[count++] = ToCell(y, n - x);
+            break;
+        case Symmetry::FULL:
+            out[count++] = ToCell(n - x, y);
+            out[count++] = ToCell(x, n - y);
+            out[count++] = ToCell(n - x, n - y);
+            out[count++] = ToCell(y, x);
+            out[count++] = ToCell(n - y, x);
+            out[count++] = ToCell(y, n - x);
+            out[count++] = ToCell(n - y, n - x);
+            break;
+        default:
+            break;
+    }
+    return count;
+}
+
+Cell StartCell(const BoardParams& params, int agentID)
+{
+    const int n = BOARD_SIZE - 1;
+    const int i = std::min(std::max(params.inset, 0), BOARD_SIZE / 2 - 1);
+    switch(agentID)
+    {
+        case 0:  return ToCell(i, i);
+        case 1:  return ToCell(n - i, i);
+        case 2:  return ToCell(n - i, n - i);
+        default: return ToCell(i, n - i);
+    }
+}
+
+void GenerateBoard(State& state, const BoardParams& params, uint64_t seed, const Rules& rules)
+{
+    SplitMix rng{seed};
+    const uint64_t rigidBound = Threshold(params.rigid);
+    const uint64_t woodBound = rigidBound + Threshold(params.wood);
+    const uint64_t powerupBound = Threshold(params.powerups);
+
+    BitBoard starts = 0;
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        starts |= BitBoard(1) << StartCell(params, i);
+    }
+    BitBoard clear = starts;
+    for(int i = 0; i < params.clearance; i++)
+    {
+        clear = Dilate(clear);
+    }
+
+    // symmetric cells copy the cell with the lowest index
+    BitBoard rigid = 0;
+    Cell images[8];
+    for(int c = 0; c < CELL_COUNT; c++)
+    {
+        const int x = CellX(Cell(c)), y = CellY(Cell(c));
+        const int count = Images(x, y, params.symmetry, images);
+        const Cell canonical = *std::min_element(images, images + count);
+
+        int item = Item::PASSAGE;
+        if(canonical != c)
+        {
+            item = state[canonical];
+        }
+        else if(!HasCell(clear, Cell(c)))
+        {
+            const uint64_t r = rng.Next() & 0xFFFFFFFF;
+            if(r < rigidBound)
+            {
+                item = Item::RIGID;
+            }
+            else if(r < woodBound)
+            {
+                item = Item::WOOD;
+                const uint64_t p = rng.Next();
+                if((p & 0xFFFFFFFF) < powerupBound)
+                {
+                    item += 1 + int((p >> 32) % 3);
+                }
+            }
+        }
+
+        state.board[y][x] = item;
+        if(item == Item::RIGID)
+        {
+            rigid |= BitBoard(1) << c;
+        }
+    }
+
+    // open a random rigid cell next to the region of agent 0
+    // until every start is in there
+    if(params.connected)
+    {
+        const Cell first = StartCell(params, 0);
+        BitBoard open = BoardMask() & ~rigid;
+        BitBoard reached = FloodFill(BitBoard(1) << first, open);
+        while((reached & starts) != starts)
+        {
+            const BitBoard frontier = Dilate(reached) & rigid;
+            int k = int(rng.Next() % uint64_t(PopCount(frontier)));
+            Cell pick = NO_CELL;
+            ForEachCell(frontier, [&k, &pick](int x, int y)
+            {
+                if(k-- == 0)
+                {
+                    pick = ToCell(x, y);
+                }
+            });
+
+            const int count = Images(CellX(pick), CellY(pick), params.symmetry, images);
+            for(int i = 0; i < count; i++)
+            {
+                state[images[i]] = Item::PASSAGE;
+                rigid &= ~(BitBoard(1) << images[i]);
+            }
+            open = BoardMask() & ~rigid;
+            reached = FloodFill(reached, open);
+        }
+    }
+
+    const int strength = DispatchRules(rules.preset, [](auto r)
+    {
+        return decltype(r)::BOMB_STRENGTH;
+    });
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        const Cell c = StartCell(params, i);
+        state.PutAgent(CellX(c), CellY(c), i);
+        state.agents[i].bombStrength = strength;
+    }
+}
+
+}
@@ -0,0 +1,75 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <cstdint>
+
+#include "bboard.hpp"
+
+namespace bboard
+{
+
+/**
+ * @brief The Symmetry enum defines the symmetry group of a
+ * generated board
+ */
+enum class Symmetry
+{
+    NONE = 0,
+    MIRROR,   // left <-> right
+    POINT,    // 180 degree rotation
+    ROTATION, // 90 degree rotations (every agent sees the same board)
+    FULL      // rotations and mirrors
+};
+
+/**
+ * @brief The BoardParams struct holds the knobs of the board
+ * generator. Probabilities are per cell (or per wooden box).
+ */
+struct BoardParams
+{
+    float rigid = 1.0f / 7;
+    float wood = 1.0f / 7;
+
+    // probability that a wooden box hides a power-up (extra bomb,
+    // range and kick are equally likely)
+    float powerups = 0.375f;
+
+    // agents start this many cells away from their corner
+    // (diagonally), at most BOARD_SIZE / 2 - 1
+    int inset = 0;
+
+    // cells within this (manhattan) distance of a start are
+    // kept free
+    int clearance = 0;
+
+    Symmetry symmetry = Symmetry::NONE;
+
+    // all starts are connected over non-rigid cells
+    bool connected = true;
+};
+
+/**
+ * @brief StartCell Returns the start cell of an agent (clockwise
+ * from top left, like PutAgentsInCorners)
+ */
+Cell StartCell(const BoardParams& params, int agentID);
+
+/**
+ * Every cell is decided with one random number, cells that are
+ * symmetric copy their canonical cell. If the starts are not
+ * connected, random rigid cells at the border of the region of
+ * agent 0 (and their symmetric images) are turned into passages
+ * until they are (checked with a bitboard flood fill).
+ *
+ * @brief GenerateBoard Fills the board with generated items and
+ * puts the agents on their start cells
+ * @param state A new state
+ * @param params The distribution of the board
+ * @param seed The random seed
+ * @param rules Rules, the preset decides the initial bomb strength
+ */
+void GenerateBoard(State& state, const BoardParams& params, uint64_t seed, const Rules& rules = Rules());
+
+}
+
+#endif // GENERATOR_H
@@ -0,0 +1,43 @@
+#include "bboard.hpp"
+#include "hash.hpp"
+
+namespace bboard
+{
+
+uint64_t HashState(const State& state)
+{
+    uint64_t h = 0x1337;
+    for(int y = 0; y < BOARD_SIZE; y++)
+    {
+        for(int x = 0; x < BOARD_SIZE; x++)
+        {
+            h = HashCombine(h, uint32_t(state.board[y][x]));
+        }
+    }
+
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        const AgentInfo& a = state.agents[i];
+        h = HashCombine(h, uint64_t(uint8_t(a.x)) | uint64_t(uint8_t(a.y)) << 8
+                        | uint64_t(uint8_t(a.bombCount)) << 16
+                        | uint64_t(uint8_t(a.maxBombCount)) << 24
+                        | uint64_t(uint8_t(a.bombStrength)) << 32
+                        | uint64_t(a.canKick) << 40 | uint64_t(a.dead) << 41);
+    }
+
+    for(int i = 0; i < state.bombs.count; i++)
+    {
+        h = HashCombine(h, uint32_t(state.bombs[i]));
+    }
+
+    for(int i = 0; i < state.flames.count; i++)
+    {
+        const Flame& f = state.flames[i];
+        h = HashCombine(h, uint64_t(CellX(f.cell)) | uint64_t(CellY(f.cell)) << 8
+                        | uint64_t(uint8_t(f.timeLeft)) << 16
+                        | uint64_t(uint8_t(f.strength)) << 24 | uint64_t(1) << 63);
+    }
+    return h;
+}
+
+}
@@ -0,0 +1,30 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstdint>
+
+#include "bboard.hpp"
+
+namespace bboard
+{
+
+/**
+ * @brief HashCombine Mixes the value v into the hash h
+ */
+inline uint64_t HashCombine(uint64_t h, uint64_t v)
+{
+    h = (h ^ v) * 0xBF58476D1CE4E5B9ULL;
+    return h ^ (h >> 31);
+}
+
+/**
+ * @brief HashState Returns a 64-bit hash of the game relevant
+ * content of a state: board, agents, live bombs and flames.
+ * Stale queue slots and the time step are ignored, so equal
+ * positions always hash equally.
+ */
+uint64_t HashState(const State& state);
+
+}
+
+#endif // HASH_H
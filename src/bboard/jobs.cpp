@@ -0,0 +1,210 @@
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+#include <chrono>
+
+#include "jobs.hpp"
+
+namespace bboard
+{
+
+thread_local const JobSystem* currentSystem = nullptr;
+thread_local int currentWorker = -1;
+
+JobSystem::JobSystem(const JobSettings& settings)
+{
+    int workers = settings.workers;
+    if(workers <= 0)
+    {
+        workers = std::max(1, int(std::thread::hardware_concurrency()) - 1);
+    }
+    spinCount = settings.spinCount;
+
+    for(int i = 0; i <= workers; i++)
+    {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for(int i = 0; i < workers; i++)
+    {
+        threads.emplace_back(&JobSystem::WorkerLoop, this, i, settings.pinThreads);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(parkMutex);
+        stop.store(true);
+    }
+    parkCondition.notify_all();
+    for(std::thread& t : threads)
+    {
+        t.join();
+    }
+}
+
+int JobSystem::WorkerCount() const
+{
+    return int(threads.size());
+}
+
+int JobSystem::CurrentWorker() const
+{
+    return currentSystem == this ? currentWorker : -1;
+}
+
+void JobSystem::Run(TaskGroup& group, Job job)
+{
+    group.pending.fetch_add(1, std::memory_order_relaxed);
+
+    const int self = CurrentWorker();
+    Queue& q = *queues[self == -1 ? queues.size() - 1 : size_t(self)];
+    {
+        std::lock_guard<std::mutex> lock(q.mutex);
+        q.tasks.push_back({std::move(job), &group});
+    }
+
+    queued.fetch_add(1);
+    if(sleeping.load() > 0)
+    {
+        // synchronize with a worker that is about to park
+        {
+            std::lock_guard<std::mutex> lock(parkMutex);
+        }
+        parkCondition.notify_one();
+    }
+}
+
+bool JobSystem::TryPop(int self, Task& task, const TaskGroup* group)
+{
+    if(queued.load(std::memory_order_relaxed) == 0)
+    {
+        return false;
+    }
+
+    const int n = int(queues.size());
+    // own jobs first (newest first), then steal the oldest
+    // jobs of the injection queue and the other workers. With a
+    // group, only the jobs of that group are taken.
+    for(int k = 0; k < n; k++)
+    {
+        const int i = self == -1 ? (n - 1 + k) % n : (self + n - k) % n;
+        Queue& q = *queues[size_t(i)];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if(q.tasks.empty())
+        {
+            continue;
+        }
+        if(group)
+        {
+            auto it = std::find_if(q.tasks.begin(), q.tasks.end(), [group](const Task& t)
+            {
+                return t.group == group;
+            });
+            if(it == q.tasks.end())
+            {
+                continue;
+            }
+            task = std::move(*it);
+            q.tasks.erase(it);
+        }
+        else if(i == self)
+        {
+            task = std::move(q.tasks.back());
+            q.tasks.pop_back();
+        }
+        else
+        {
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+        }
+        queued.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::Execute(Task& task)
+{
+    task.job();
+    task.job = nullptr;
+    task.group->pending.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::WorkerLoop(int index, bool pin)
+{
+    currentSystem = this;
+    currentWorker = index;
+
+#ifdef __linux__
+    if(pin)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(index % std::max(1u, std::thread::hardware_concurrency()), &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+#else
+    (void)pin;
+#endif
+
+    Task task;
+    int idle = 0;
+    while(!stop.load(std::memory_order_relaxed))
+    {
+        if(TryPop(index, task))
+        {
+            Execute(task);
+            idle = 0;
+            continue;
+        }
+        if(++idle < spinCount)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // park until there is work
+        std::unique_lock<std::mutex> lock(parkMutex);
+        sleeping.fetch_add(1);
+        parkCondition.wait(lock, [this]()
+        {
+            return queued.load() > 0 || stop.load();
+        });
+        sleeping.fetch_sub(1);
+        idle = 0;
+    }
+}
+
+void JobSystem::Wait(TaskGroup& group)
+{
+    const int self = CurrentWorker();
+    Task task;
+    int idle = 0;
+    while(!group.Done())
+    {
+        if(TryPop(self, task, &group))
+        {
+            Execute(task);
+            idle = 0;
+        }
+        else if(++idle < spinCount)
+        {
+            std::this_thread::yield();
+        }
+        else
+        {
+            // the remaining jobs are running elsewhere
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+}
+
+JobSystem& Jobs()
+{
+    static JobSystem system;
+    return system;
+}
+
+}
@@ -0,0 +1,184 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <atomic>
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+namespace bboard
+{
+
+typedef std::function<void()> Job;
+
+/**
+ * @brief The TaskGroup class counts the unfinished jobs that were
+ * submitted with it. Wait on the group before it goes out of scope.
+ */
+class TaskGroup
+{
+    friend class JobSystem;
+
+private:
+
+    std::atomic<int> pending{0};
+
+public:
+
+    /**
+     * @brief Done Returns true if all jobs of the group finished
+     */
+    bool Done() const
+    {
+        return pending.load(std::memory_order_acquire) == 0;
+    }
+};
+
+/**
+ * @brief The JobSettings struct configures a JobSystem
+ */
+struct JobSettings
+{
+    // amount of worker threads, 0 = one less than the amount
+    // of hardware threads (the waiting thread helps)
+    int workers = 0;
+
+    // pin worker i to core i (Linux only)
+    bool pinThreads = false;
+
+    // failed steal attempts before an idle worker parks
+    int spinCount = 2048;
+};
+
+/**
+ * Every worker owns a deque: it pushes and pops its own jobs at
+ * the back, idle workers steal from the front of the others.
+ * Jobs from other threads go to a shared injection queue. Idle
+ * workers spin for a while before they park.
+ *
+ * Waiting (Wait, ParallelFor) executes pending jobs of the awaited
+ * group instead of blocking, so jobs can submit and wait for jobs
+ * themselves (nested parallelism) without deadlocks. Waiters never
+ * run unrelated jobs, a search waiting on its workers is not held
+ * up by another agent or game. Jobs should still finish in bounded
+ * time: open-ended work (like pondering) belongs on its own thread.
+ *
+ * @brief Work-stealing thread pool
+ */
+class JobSystem
+{
+
+private:
+
+    struct Task
+    {
+        Job job;
+        TaskGroup* group;
+    };
+
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::thread> threads;
+    // one queue per worker, the last one is the injection queue
+    std::vector<std::unique_ptr<Queue>> queues;
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> queued{0};
+    std::atomic<int> sleeping{0};
+    std::mutex parkMutex;
+    std::condition_variable parkCondition;
+
+    int spinCount;
+
+    void WorkerLoop(int index, bool pin);
+    bool TryPop(int self, Task& task, const TaskGroup* group = nullptr);
+    void Execute(Task& task);
+
+public:
+
+    JobSystem(const JobSettings& settings = JobSettings());
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+     * @brief WorkerCount Returns the amount of worker threads
+     */
+    int WorkerCount() const;
+
+    /**
+     * @brief CurrentWorker Returns the index of the calling worker
+     * thread of this system or -1 for any other thread
+     */
+    int CurrentWorker() const;
+
+    /**
+     * @brief Run Submits a job
+     */
+    void Run(TaskGroup& group, Job job);
+
+    /**
+     * @brief Wait Executes jobs of the group until all of them
+     * finished
+     */
+    void Wait(TaskGroup& group);
+
+    /**
+     * Calls f(i) for every i in [0, count). At most width jobs
+     * (including the calling thread) take indices one by one from
+     * a shared counter, width = 1 runs everything on the caller.
+     *
+     * @brief ParallelFor Dynamically scheduled parallel loop
+     */
+    template<typename F>
+    void ParallelFor(int count, int width, F f);
+
+    /**
+     * @brief ParallelFor Parallel loop using all workers
+     */
+    template<typename F>
+    void ParallelFor(int count, F f)
+    {
+        ParallelFor(count, WorkerCount() + 1, f);
+    }
+};
+
+template<typename F>
+void JobSystem::ParallelFor(int count, int width, F f)
+{
+    std::atomic<int> next(0);
+    auto work = [&next, &f, count]()
+    {
+        for(int i = next++; i < count; i = next++)
+        {
+            f(i);
+        }
+    };
+
+    TaskGroup group;
+    for(int t = 1; t < std::min(width, count); t++)
+    {
+        Run(group, work);
+    }
+    work();
+    Wait(group);
+}
+
+/**
+ * @brief Jobs Returns the job system shared by the whole process
+ */
+JobSystem& Jobs();
+
+}
+
+#endif // JOBS_H
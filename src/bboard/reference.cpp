@@ -0,0 +1,599 @@
+#include <sstream>
+#include <algorithm>
+
+#include "reference.hpp"
+
+namespace bboard::reference
+{
+
+///////////////////
+// Packed Values //
+///////////////////
+
+// same layout as bboard::Bomb, kept separately on purpose
+inline int BombX(int b)        { return b & 0xF; }
+inline int BombY(int b)        { return (b & 0xF0) >> 4; }
+inline int BombPos(int b)      { return b & 0xFF; }
+inline int BombID(int b)       { return (b & 0xF00) >> 8; }
+inline int BombStrength(int b) { return (b & 0xF000) >> 12; }
+inline int BombTime(int b)     { return (b & 0xF0000) >> 16; }
+
+inline bool IsWood(int item)    { return (item >> 8) == 2; }
+inline bool IsPowerup(int item) { return item > 5 && item < 9; }
+inline bool IsFlame(int item)   { return (item >> 16) == 4; }
+inline int FlameID(int item)    { return (item & 0xFFFF) >> 3; }
+inline int PowFlag(int item)    { return item & 0b11; }
+
+inline bool IsOutOfBounds(int x, int y)
+{
+    return x < 0 || y < 0 || x >= BOARD_SIZE || y >= BOARD_SIZE;
+}
+
+////////////
+// Queues //
+////////////
+
+template<typename T>
+inline T& NextPos(Queue<T>& q)
+{
+    return q.slots[(q.index + q.count) % MAX_BOMBS];
+}
+
+template<typename T>
+inline void PopElem(Queue<T>& q)
+{
+    q.index = (q.index + 1) % MAX_BOMBS;
+    q.count--;
+}
+
+template<typename T>
+inline void RemoveAt(Queue<T>& q, int removeAt)
+{
+    for(int i = removeAt + 1; i < q.count; i++)
+    {
+        int translated = (q.index + i) % MAX_BOMBS;
+        q.slots[(translated - 1 + MAX_BOMBS) % MAX_BOMBS] = q.slots[translated];
+    }
+    q.count--;
+}
+
+///////////////
+// Mechanics //
+///////////////
+
+void SpawnFlame(State& s, int x, int y, int strength);
+
+void Kill(State& s, int id)
+{
+    if(!s.agents[id].dead)
+    {
+        s.agents[id].dead = true;
+        s.aliveAgents--;
+    }
+}
+
+bool HasBomb(const State& s, int x, int y)
+{
+    for(int i = 0; i < s.bombs.count; i++)
+    {
+        if(BombX(s.bombs[i]) == x && BombY(s.bombs[i]) == y)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void PlantBomb(State& s, int x, int y, int id)
+{
+    if(s.agents[id].bombCount >= s.agents[id].maxBombCount)
+    {
+        return;
+    }
+
+    int& b = NextPos(s.bombs);
+    b = (b & ~0xF00) + (id << 8);
+    b = (b & ~0xF & ~0xF0) + x + (y << 4);
+    b = (b & ~0xF000) + (s.agents[id].bombStrength << 12);
+    b = (b & 0xFFFF) + (BOMB_LIFETIME << 16);
+
+    s.agents[id].bombCount++;
+    s.bombs.count++;
+}
+
+int FlagItem(int powFlag)
+{
+    if     (powFlag == 1) return EXTRABOMB;
+    else if(powFlag == 2) return INCRRANGE;
+    else if(powFlag == 3) return KICK;
+    else                  return PASSAGE;
+}
+
+bool SpawnFlameItem(State& s, int x, int y, int signature)
+{
+    if(s.board[y][x] >= AGENT0)
+    {
+        Kill(s, s.board[y][x] - AGENT0);
+    }
+    if(s.board[y][x] == BOMB || s.board[y][x] >= AGENT0)
+    {
+        for(int i = 0; i < s.bombs.count; i++)
+        {
+            if(BombPos(s.bombs[i]) == (x + (y << 4)))
+            {
+                SpawnFlame(s, x, y, s.agents[BombID(s.bombs[i])].bombStrength);
+                s.agents[BombID(s.bombs[i])].bombCount--;
+                RemoveAt(s.bombs, i);
+                break;
+            }
+        }
+    }
+
+    if(s.board[y][x] == RIGID)
+    {
+        return false;
+    }
+    const int old = s.board[y][x];
+    s.board[y][x] = FLAMES + signature;
+    if(IsWood(old))
+    {
+        s.board[y][x] += PowFlag(old);
+        return false;
+    }
+    return true;
+}
+
+void SpawnFlame(State& s, int x, int y, int strength)
+{
+    Flame& f = NextPos(s.flames);
+    f.x = x;
+    f.y = y;
+    f.strength = strength;
+    f.timeLeft = FLAME_LIFETIME;
+    s.flames.count++;
+
+    const int signature = (x + BOARD_SIZE * y) << 3;
+
+    if(s.board[y][x] >= AGENT0)
+    {
+        Kill(s, s.board[y][x] - AGENT0);
+    }
+    s.board[y][x] = FLAMES + signature;
+
+    for(int i = 1; i <= strength && x + i < BOARD_SIZE; i++)
+    {
+        if(!SpawnFlameItem(s, x + i, y, signature)) break;
+    }
+    for(int i = 1; i <= strength && x - i >= 0; i++)
+    {
+        if(!SpawnFlameItem(s, x - i, y, signature)) break;
+    }
+    for(int i = 1; i <= strength && y + i < BOARD_SIZE; i++)
+    {
+        if(!SpawnFlameItem(s, x, y + i, signature)) break;
+    }
+    for(int i = 1; i <= strength && y - i >= 0; i++)
+    {
+        if(!SpawnFlameItem(s, x, y - i, signature)) break;
+    }
+}
+
+void PopFlame(State& s)
+{
+    const Flame& f = s.flames[0];
+    const int signature = f.x + BOARD_SIZE * f.y;
+
+    for(int i = -f.strength; i <= f.strength; i++)
+    {
+        if(!IsOutOfBounds(f.x + i, f.y))
+        {
+            int& c = s.board[f.y][f.x + i];
+            if(IsFlame(c) && FlameID(c) == signature)
+            {
+                c = FlagItem(PowFlag(c));
+            }
+        }
+        if(!IsOutOfBounds(f.x, f.y + i))
+        {
+            int& c = s.board[f.y + i][f.x];
+            if(IsFlame(c) && FlameID(c) == signature)
+            {
+                c = FlagItem(PowFlag(c));
+            }
+        }
+    }
+    PopElem(s.flames);
+}
+
+void TickFlames(State& s)
+{
+    for(int i = 0; i < s.flames.count; i++)
+    {
+        s.flames[i].timeLeft--;
+    }
+    const int flameCount = s.flames.count;
+    for(int i = 0; i < flameCount; i++)
+    {
+        if(s.flames[0].timeLeft == 0)
+        {
+            PopFlame(s);
+        }
+    }
+}
+
+void TickBombs(State& s)
+{
+    for(int i = 0; i < s.bombs.count; i++)
+    {
+        s.bombs[i] -= 1 << 16;
+    }
+
+    const int bombCount = s.bombs.count;
+    for(int i = 0; i < bombCount && s.bombs.count > 0; i++)
+    {
+        if(BombTime(s.bombs[0]) != 0)
+        {
+            break;
+        }
+        const int b = s.bombs[0];
+        SpawnFlame(s, BombX(b), BombY(b), BombStrength(b));
+        s.agents[BombID(s.bombs[0])].bombCount--;
+        PopElem(s.bombs);
+    }
+}
+
+void ConsumePowerup(State& s, int id, int item)
+{
+    if(item == EXTRABOMB)
+    {
+        s.agents[id].maxBombCount++;
+    }
+    else if(item == INCRRANGE)
+    {
+        s.agents[id].bombStrength++;
+    }
+    else if(item == KICK)
+    {
+        s.agents[id].canKick = true;
+    }
+}
+
+//////////
+// Step //
+//////////
+
+void Step(State& s, const Move moves[AGENT_COUNT])
+{
+    TickFlames(s);
+    TickBombs(s);
+
+    // desired positions
+    Position dest[AGENT_COUNT];
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        dest[i] = {s.agents[i].x, s.agents[i].y};
+        switch(moves[i])
+        {
+            case Move::UP:    dest[i].y--; break;
+            case Move::DOWN:  dest[i].y++; break;
+            case Move::LEFT:  dest[i].x--; break;
+            case Move::RIGHT: dest[i].x++; break;
+            default: break;
+        }
+    }
+
+    // agents can't switch places
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        for(int j = i; j < AGENT_COUNT; j++)
+        {
+            if(dest[i].x == s.agents[j].x && dest[i].y == s.agents[j].y
+                    && dest[j].x == s.agents[i].x && dest[j].y == s.agents[i].y)
+            {
+                dest[i] = {s.agents[i].x, s.agents[i].y};
+                dest[j] = {s.agents[j].x, s.agents[j].y};
+            }
+        }
+    }
+
+    // dependency chains (dependency[j] wants to move onto j)
+    int dependency[AGENT_COUNT] = {-1, -1, -1, -1};
+    int roots[AGENT_COUNT] = {-1, -1, -1, -1};
+    int rootNumber = 0;
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        bool isRoot = true;
+        for(int j = 0; j < AGENT_COUNT && !s.agents[i].dead; j++)
+        {
+            if(i == j || s.agents[j].dead) continue;
+
+            if(dest[i].x == s.agents[j].x && dest[i].y == s.agents[j].y)
+            {
+                dependency[j] = i;
+                isRoot = false;
+                break;
+            }
+        }
+        if(isRoot)
+        {
+            roots[rootNumber++] = i;
+        }
+    }
+    const bool ouroboros = rootNumber == 0;
+
+    int rootIdx = 0;
+    int i = ouroboros ? 0 : roots[0];
+    for(int _ = 0; _ < AGENT_COUNT; _++, i = dependency[i])
+    {
+        if(i == -1)
+        {
+            // agents that are not part of any chain compete
+            // for a destination and can't move
+            if(++rootIdx >= rootNumber) break;
+            i = roots[rootIdx];
+        }
+        const Move m = moves[i];
+        AgentInfo& a = s.agents[i];
+
+        if(a.dead || m == Move::IDLE)
+        {
+            continue;
+        }
+        if(m == Move::BOMB)
+        {
+            PlantBomb(s, a.x, a.y, i);
+            continue;
+        }
+
+        const Position d = dest[i];
+        if(IsOutOfBounds(d.x, d.y))
+        {
+            continue;
+        }
+
+        int item = s.board[d.y][d.x];
+        if(ouroboros && HasBomb(s, d.x, d.y))
+        {
+            item = BOMB;
+        }
+
+        if(IsFlame(item))
+        {
+            Kill(s, i);
+            if(s.board[a.y][a.x] == AGENT0 + i)
+            {
+                s.board[a.y][a.x] = HasBomb(s, a.x, a.y) ? BOMB : PASSAGE;
+            }
+            continue;
+        }
+
+        bool collision = false;
+        for(int j = 0; j < AGENT_COUNT; j++)
+        {
+            if(j != i && !s.agents[j].dead && dest[j] == d)
+            {
+                collision = true;
+            }
+        }
+        if(collision)
+        {
+            continue;
+        }
+
+        if(IsPowerup(item))
+        {
+            ConsumePowerup(s, i, item);
+            item = PASSAGE;
+        }
+
+        if(item == PASSAGE || (ouroboros && item >= AGENT0))
+        {
+            if(s.board[a.y][a.x] == AGENT0 + i)
+            {
+                s.board[a.y][a.x] = HasBomb(s, a.x, a.y) ? BOMB : PASSAGE;
+            }
+            s.board[d.y][d.x] = AGENT0 + i;
+            a.x = d.x;
+            a.y = d.y;
+        }
+    }
+}
+
+/////////////////
+// Conversions //
+/////////////////
+
+void FromState(const bboard::State& state, State& ref)
+{
+    for(int y = 0; y < BOARD_SIZE; y++)
+    {
+        std::copy(state.board[y], state.board[y] + BOARD_SIZE, ref.board[y]);
+    }
+    ref.timeStep = state.timeStep;
+    ref.aliveAgents = state.aliveAgents;
+
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        const bboard::AgentInfo& a = state.agents[i];
+        ref.agents[i] = {a.x, a.y, a.bombCount, a.maxBombCount, a.bombStrength, a.canKick, a.dead};
+    }
+
+    for(int i = 0; i < MAX_BOMBS; i++)
+    {
+        const bboard::Flame& f = state.flames.queue[i];
+        ref.bombs.slots[i] = state.bombs.queue[i];
+        // raw slots (the unused ones can hold any cell)
+        ref.flames.slots[i] = {f.cell % BOARD_SIZE, f.cell / BOARD_SIZE, f.timeLeft, f.strength};
+    }
+    ref.bombs.index = state.bombs.index;
+    ref.bombs.count = state.bombs.count;
+    ref.flames.index = state.flames.index;
+    ref.flames.count = state.flames.count;
+}
+
+void ToState(const State& ref, bboard::State& state)
+{
+    for(int y = 0; y < BOARD_SIZE; y++)
+    {
+        std::copy(ref.board[y], ref.board[y] + BOARD_SIZE, state.board[y]);
+    }
+    state.timeStep = ref.timeStep;
+
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        const AgentInfo& a = ref.agents[i];
+        bboard::AgentInfo& b = state.agents[i];
+        b.x = a.x;
+        b.y = a.y;
+        b.bombCount = a.bombCount;
+        b.maxBombCount = a.maxBombCount;
+        b.bombStrength = a.bombStrength;
+        b.canKick = a.canKick;
+        b.dead = a.dead;
+    }
+    state.UpdateAlive();
+
+    for(int i = 0; i < MAX_BOMBS; i++)
+    {
+        const Flame& f = ref.flames.slots[i];
+        bboard::Flame& g = state.flames.queue[i];
+        state.bombs.queue[i] = ref.bombs.slots[i];
+        g.cell = Cell(f.x + BOARD_SIZE * f.y);
+        g.timeLeft = f.timeLeft;
+        g.strength = f.strength;
+    }
+    state.bombs.index = ref.bombs.index;
+    state.bombs.count = ref.bombs.count;
+    state.flames.index = ref.flames.index;
+    state.flames.count = ref.flames.count;
+}
+
+bool Equal(const bboard::State& state, const State& ref)
+{
+    for(int y = 0; y < BOARD_SIZE; y++)
+    {
+        for(int x = 0; x < BOARD_SIZE; x++)
+        {
+            if(state.board[y][x] != ref.board[y][x]) return false;
+        }
+    }
+    if(state.timeStep != ref.timeStep || state.aliveAgents != ref.aliveAgents)
+    {
+        return false;
+    }
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        const bboard::AgentInfo& a = state.agents[i];
+        const AgentInfo& e = ref.agents[i];
+        if(a.x != e.x || a.y != e.y || a.bombCount != e.bombCount
+                || a.maxBombCount != e.maxBombCount || a.bombStrength != e.bombStrength
+                || a.canKick != e.canKick || a.dead != e.dead)
+        {
+            return false;
+        }
+    }
+    if(state.bombs.count != ref.bombs.count || state.flames.count != ref.flames.count)
+    {
+        return false;
+    }
+    for(int i = 0; i < state.bombs.count; i++)
+    {
+        if(state.bombs[i] != ref.bombs[i]) return false;
+    }
+    for(int i = 0; i < state.flames.count; i++)
+    {
+        const bboard::Flame& a = state.flames[i];
+        const Flame& e = ref.flames[i];
+        if(a.cell != e.x + BOARD_SIZE * e.y
+                || a.timeLeft != e.timeLeft || a.strength != e.strength)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Compare(const bboard::State& state, const State& ref, std::string* diff)
+{
+    if(Equal(state, ref))
+    {
+        if(diff) diff->clear();
+        return true;
+    }
+    if(!diff)
+    {
+        return false;
+    }
+
+    const int maxReported = 8;
+    int differences = 0;
+    std::ostringstream out;
+
+    auto check = [&](bool equal, const auto& what, long long actual, long long expected)
+    {
+        if(!equal)
+        {
+            if(differences < maxReported)
+            {
+                out << what << ": " << actual << " (expected " << expected << ")\n";
+            }
+            differences++;
+        }
+    };
+
+    for(int y = 0; y < BOARD_SIZE; y++)
+    {
+        for(int x = 0; x < BOARD_SIZE; x++)
+        {
+            const int a = state.board[y][x], e = ref.board[y][x];
+            if(a != e)
+            {
+                std::ostringstream cell;
+                cell << "board (" << x << ", " << y << ")";
+                check(false, cell.str(), a, e);
+            }
+        }
+    }
+    check(state.timeStep == ref.timeStep, "timeStep", state.timeStep, ref.timeStep);
+    check(state.aliveAgents == ref.aliveAgents, "aliveAgents", state.aliveAgents, ref.aliveAgents);
+
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        const bboard::AgentInfo& a = state.agents[i];
+        const AgentInfo& e = ref.agents[i];
+        const std::string p = "agent " + std::to_string(i) + " ";
+        check(a.x == e.x, p + "x", a.x, e.x);
+        check(a.y == e.y, p + "y", a.y, e.y);
+        check(a.bombCount == e.bombCount, p + "bombCount", a.bombCount, e.bombCount);
+        check(a.maxBombCount == e.maxBombCount, p + "maxBombCount", a.maxBombCount, e.maxBombCount);
+        check(a.bombStrength == e.bombStrength, p + "bombStrength", a.bombStrength, e.bombStrength);
+        check(a.canKick == e.canKick, p + "canKick", a.canKick, e.canKick);
+        check(a.dead == e.dead, p + "dead", a.dead, e.dead);
+    }
+
+    check(state.bombs.count == ref.bombs.count, "bomb count", state.bombs.count, ref.bombs.count);
+    for(int i = 0; i < std::min(state.bombs.count, ref.bombs.count); i++)
+    {
+        check(state.bombs[i] == ref.bombs[i], "bomb " + std::to_string(i), state.bombs[i], ref.bombs[i]);
+    }
+
+    check(state.flames.count == ref.flames.count, "flame count", state.flames.count, ref.flames.count);
+    for(int i = 0; i < std::min(state.flames.count, ref.flames.count); i++)
+    {
+        const bboard::Flame& a = state.flames[i];
+        const Flame& e = ref.flames[i];
+        // compare the packed flame to report a single difference
+        const long long pa = CellX(a.cell) | CellY(a.cell) << 8 | a.timeLeft << 16 | (long long)a.strength << 24;
+        const long long pe = e.x | e.y << 8 | e.timeLeft << 16 | (long long)e.strength << 24;
+        check(pa == pe, "flame " + std::to_string(i) + " (x | y << 8 | time << 16 | strength << 24)", pa, pe);
+    }
+
+    if(differences > maxReported)
+    {
+        out << "... " << differences - maxReported << " more\n";
+    }
+    *diff = out.str();
+    return false;
+}
+
+}
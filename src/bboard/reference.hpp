@@ -0,0 +1,123 @@
+#ifndef REFERENCE_H
+#define REFERENCE_H
+
+#include <string>
+
+#include "bboard.hpp"
+
+/**
+ * A frozen copy of the game mechanics (Step and everything it
+ * calls) on its own state type. It is deliberately simple and
+ * must not be optimized: it is the specification that optimized
+ * versions of bboard::Step are checked against (see differential.hpp).
+ *
+ * Changes to the rules have to be made here as well, everything
+ * else has to stay untouched.
+ */
+namespace bboard::reference
+{
+
+const int PASSAGE   = 0;
+const int RIGID     = 1;
+const int WOOD      = 2 << 8;
+const int BOMB      = 3;
+const int FLAMES    = 4 << 16;
+const int EXTRABOMB = 6;
+const int INCRRANGE = 7;
+const int KICK      = 8;
+const int AGENT0    = 1 << 24;
+
+/**
+ * @brief The AgentInfo struct holds the properties of an agent
+ */
+struct AgentInfo
+{
+    int x = 0;
+    int y = 0;
+    int bombCount = 0;
+    int maxBombCount = 1;
+    int bombStrength = 1;
+    bool canKick = false;
+    bool dead = false;
+};
+
+/**
+ * @brief The Flame struct holds a flame (all fire cells of a
+ * single explosion)
+ */
+struct Flame
+{
+    int x = 0;
+    int y = 0;
+    int timeLeft = 0;
+    int strength = 0;
+};
+
+/**
+ * @brief The Queue struct is a circular buffer with the semantics
+ * of bboard::FixedQueue. The mechanics can read stale slots (e.g.
+ * after chained explosions), so those are kept as well.
+ */
+template<typename T>
+struct Queue
+{
+    T slots[MAX_BOMBS];
+    int index = 0;
+    int count = 0;
+
+    T& operator[] (int i)
+    {
+        return slots[(index + i) % MAX_BOMBS];
+    }
+    const T& operator[] (int i) const
+    {
+        return slots[(index + i) % MAX_BOMBS];
+    }
+};
+
+/**
+ * Bombs use the packed layout of bboard::Bomb (including its
+ * overflow behaviour), see the BMB_ macros.
+ *
+ * @brief The reference game state
+ */
+struct State
+{
+    int board[BOARD_SIZE][BOARD_SIZE];
+
+    int timeStep = 0;
+    int aliveAgents = AGENT_COUNT;
+
+    AgentInfo agents[AGENT_COUNT];
+
+    Queue<int> bombs;
+    Queue<Flame> flames;
+};
+
+/**
+ * @brief Step Applies the moves to the state (reference semantics)
+ */
+void Step(State& state, const Move moves[AGENT_COUNT]);
+
+/**
+ * @brief FromState Converts a state into a reference state
+ */
+void FromState(const bboard::State& state, State& ref);
+
+/**
+ * @brief ToState Converts a reference state into a state
+ */
+void ToState(const State& ref, bboard::State& state);
+
+/**
+ * @brief Compare Compares all game relevant content of the
+ * states (stale queue slots are ignored).
+ * @param diff If not null, receives a description of the first
+ * differences
+ * @return True if the states are equal
+ */
+bool Compare(const bboard::State& state, const State& ref, std::string* diff = nullptr);
+
+}
+
+#endif // REFERENCE_H
@@ -0,0 +1,170 @@
+#include <sstream>
+
+#include "bboard.hpp"
+#include "hash.hpp"
+#include "serialization.hpp"
+#include "step_utility.hpp"
+#include "replay.hpp"
+
+namespace bboard
+{
+
+const char* const BASE36 = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+inline int FromBase36(char c)
+{
+    if(c >= '0' && c <= '9') return c - '0';
+    if(c >= 'a' && c <= 'z') return c - 'a' + 10;
+    return -1;
+}
+
+inline int FromHex(char c)
+{
+    if(c >= '0' && c <= '9') return c - '0';
+    if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+std::string FormatReplay(const Replay& replay)
+{
+    std::string line = replay.name + " ";
+
+    const char* hex = "0123456789abcdef";
+    for(uint8_t b : Serialize(replay.initial))
+    {
+        line += hex[b >> 4];
+        line += hex[b & 0xF];
+    }
+    line += " ";
+
+    for(const MoveSet& m : replay.moves)
+    {
+        const int v = int(m[0]) + 6 * int(m[1]) + 36 * int(m[2]) + 216 * int(m[3]);
+        line += BASE36[v / 36];
+        line += BASE36[v % 36];
+    }
+
+    std::ostringstream h;
+    h << " " << std::hex << replay.finalHash;
+    return line + h.str();
+}
+
+bool ParseReplay(const std::string& line, Replay& replay)
+{
+    std::istringstream in(line);
+    std::string state, moves, hash;
+    if(!(in >> replay.name >> state >> moves >> hash) || state.size() % 2 != 0
+            || moves.size() % 2 != 0 || hash.size() > 16)
+    {
+        return false;
+    }
+
+    std::vector<uint8_t> bytes(state.size() / 2);
+    for(size_t i = 0; i < bytes.size(); i++)
+    {
+        const int hi = FromHex(state[2 * i]), lo = FromHex(state[2 * i + 1]);
+        if(hi < 0 || lo < 0) return false;
+        bytes[i] = uint8_t(hi << 4 | lo);
+    }
+    replay.initial = State();
+    if(!Deserialize(bytes.data(), bytes.size(), replay.initial))
+    {
+        return false;
+    }
+
+    replay.moves.resize(moves.size() / 2);
+    for(size_t t = 0; t < replay.moves.size(); t++)
+    {
+        const int hi = FromBase36(moves[2 * t]), lo = FromBase36(moves[2 * t + 1]);
+        int v = hi * 36 + lo;
+        if(hi < 0 || lo < 0 || v >= 6 * 6 * 6 * 6) return false;
+        for(int i = 0; i < AGENT_COUNT; i++, v /= 6)
+        {
+            replay.moves[t][i] = Move(v % 6);
+        }
+    }
+
+    replay.finalHash = 0;
+    for(char c : hash)
+    {
+        const int d = FromHex(c);
+        if(d < 0) return false;
+        replay.finalHash = replay.finalHash << 4 | uint64_t(d);
+    }
+    return true;
+}
+
+bool ParseReplays(const std::string& text, std::vector<Replay>& replays)
+{
+    std::istringstream in(text);
+    std::string line;
+    while(std::getline(in, line))
+    {
+        const size_t start = line.find_first_not_of(" \t\r");
+        if(start == std::string::npos || line[start] == '#')
+        {
+            continue;
+        }
+        replays.emplace_back();
+        if(!ParseReplay(line, replays.back()))
+        {
+            replays.pop_back();
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t PlayReplay(const Replay& replay, State& state, StepFunction step)
+{
+    state = replay.initial;
+    for(const MoveSet& m : replay.moves)
+    {
+        MoveSet copy = m;
+        step(&state, copy.data());
+        state.timeStep++;
+    }
+    return HashState(state);
+}
+
+ReplayFeatures AnalyzeReplay(const Replay& replay)
+{
+    ReplayFeatures f;
+    State state = replay.initial;
+    for(const MoveSet& m : replay.moves)
+    {
+        MoveSet copy = m;
+
+        int timedOut = 0, expiring = 0;
+        for(int i = 0; i < state.bombs.count; i++)
+        {
+            timedOut += BMB_TIME(state.bombs[i]) == 1;
+        }
+        for(int i = 0; i < state.flames.count; i++)
+        {
+            expiring += state.flames[i].timeLeft == 1;
+        }
+
+        Cell dest[AGENT_COUNT];
+        int dependency[AGENT_COUNT] = {-1, -1, -1, -1};
+        int roots[AGENT_COUNT] = {-1, -1, -1, -1};
+        util::FillDestCells(&state, copy.data(), dest);
+        util::FixSwitchMove(&state, dest);
+        if(util::ResolveDependencies(&state, dest, dependency, roots) == 0)
+        {
+            f.ouroboros++;
+        }
+
+        const int alive = state.aliveAgents;
+        const int flames = state.flames.count - expiring;
+        Step(&state, copy.data());
+        state.timeStep++;
+
+        f.chainExplosions += state.flames.count - flames > timedOut;
+        f.simultaneousDeaths += alive - state.aliveAgents >= 2;
+        f.endgameSteps += state.aliveAgents <= 2;
+    }
+    return f;
+}
+
+}
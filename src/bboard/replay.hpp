@@ -0,0 +1,85 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "bboard.hpp"
+#include "differential.hpp"
+
+namespace bboard
+{
+
+/**
+ * @brief The Replay struct is a recorded game: the initial state,
+ * the moves of every step and the hash of the final state
+ */
+struct Replay
+{
+    std::string name;
+    State initial;
+    std::vector<MoveSet> moves;
+    uint64_t finalHash = 0;
+};
+
+/**
+ * @brief The ReplayFeatures struct summarizes the situations that
+ * occur in a replay
+ */
+struct ReplayFeatures
+{
+    // steps with more explosions than timed out bombs
+    int chainExplosions = 0;
+    // steps in which all agents move in a cycle
+    int ouroboros = 0;
+    // steps in which at least two agents die
+    int simultaneousDeaths = 0;
+    // steps with at most two agents alive
+    int endgameSteps = 0;
+};
+
+/**
+ * Text format, one replay per line (lines starting with '#' are
+ * comments):
+ *
+ *   <name> <initial state> <moves> <final hash>
+ *
+ * The initial state is the hex encoded serialization (see
+ * serialization.hpp). Every step takes two base-36 digits that
+ * encode m0 + 6 m1 + 36 m2 + 216 m3. The final hash (HashState)
+ * is written in hex.
+ *
+ * @brief FormatReplay Returns the replay as a single line
+ */
+std::string FormatReplay(const Replay& replay);
+
+/**
+ * @brief ParseReplay Parses a single line written by FormatReplay
+ * @return False if the line is not a valid replay
+ */
+bool ParseReplay(const std::string& line, Replay& replay);
+
+/**
+ * @brief ParseReplays Parses all replays of a corpus (skips
+ * comments and empty lines)
+ * @return False if any line is invalid
+ */
+bool ParseReplays(const std::string& text, std::vector<Replay>& replays);
+
+/**
+ * @brief PlayReplay Plays the moves of the replay (the time step
+ * advances like in the Environment)
+ * @param step The step implementation
+ * @return The hash of the final state
+ */
+uint64_t PlayReplay(const Replay& replay, State& state, StepFunction step = &Step);
+
+/**
+ * @brief AnalyzeReplay Plays the replay and counts its features
+ */
+ReplayFeatures AnalyzeReplay(const Replay& replay);
+
+}
+
+#endif // REPLAY_H
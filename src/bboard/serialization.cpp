@@ -0,0 +1,332 @@
+#include "bboard.hpp"
+#include "serialization.hpp"
+
+namespace bboard
+{
+
+
+// 4-bit cell codes, items 0-9 (except WOOD, FLAMES) keep their value
+const uint8_t CODE_WOOD = 2;
+const uint8_t CODE_FLAME = 4;
+const uint8_t CODE_AGENT0 = 10;
+const uint8_t CODE_FLAGGED_WOOD = 14;
+const uint8_t CODE_ESCAPE = 15;
+
+// extra bits per code
+const int FLAME_BITS = 9;
+const int WOOD_FLAG_BITS = 2;
+const int ESCAPE_BITS = 32;
+
+const uint8_t HIDDEN_POSITION = 15;
+
+/**
+ * @brief The BitWriter struct appends bit fields (LSB first)
+ */
+struct BitWriter
+{
+    uint8_t* out;
+    uint64_t buffer = 0;
+    int bits = 0;
+
+    void Put(uint32_t value, int count)
+    {
+        buffer |= uint64_t(value) << bits;
+        bits += count;
+        while(bits >= 8)
+        {
+            *out++ = uint8_t(buffer);
+            buffer >>= 8;
+            bits -= 8;
+        }
+    }
+
+    uint8_t* Finish()
+    {
+        if(bits > 0)
+        {
+            *out++ = uint8_t(buffer);
+        }
+        return out;
+    }
+};
+
+/**
+ * @brief The BitReader struct reads bit fields written by a BitWriter
+ */
+struct BitReader
+{
+    const uint8_t* in;
+    const uint8_t* end;
+    uint64_t buffer = 0;
+    int bits = 0;
+
+    bool Get(int count, uint32_t& value)
+    {
+        while(bits < count)
+        {
+            if(in >= end)
+            {
+                return false;
+            }
+            buffer |= uint64_t(*in++) << bits;
+            bits += 8;
+        }
+        value = uint32_t(buffer & ((uint64_t(1) << count) - 1));
+        buffer >>= count;
+        bits -= count;
+        return true;
+    }
+};
+
+/**
+ * @brief CellCode Returns the 4-bit code of an item
+ */
+inline uint8_t CellCode(int item)
+{
+    // common case first: plain items keep their value
+    static const uint8_t smallCodes[Item::AGENTDUMMY + 1] =
+    {
+        0, 1, CODE_ESCAPE, 3, CODE_ESCAPE, 5, 6, 7, 8, 9
+    };
+    if(uint32_t(item) <= Item::AGENTDUMMY)
+    {
+        return smallCodes[item];
+    }
+    if(item >= Item::AGENT0 && item <= Item::AGENT3)
+    {
+        return uint8_t(CODE_AGENT0 + item - Item::AGENT0);
+    }
+    if(item == Item::WOOD)
+    {
+        return CODE_WOOD;
+    }
+    if(IS_WOOD(item) && (item & ~0b11) == Item::WOOD)
+    {
+        return CODE_FLAGGED_WOOD;
+    }
+    if(IS_FLAME(item) && (item & 0b100) == 0 && FLAME_ID(item) < CELL_COUNT)
+    {
+        return CODE_FLAME;
+    }
+    return CODE_ESCAPE;
+}
+
+inline uint8_t PackPosition(int v)
+{
+    return v < 0 ? HIDDEN_POSITION : uint8_t(v);
+}
+
+inline int UnpackPosition(uint8_t v)
+{
+    return v == HIDDEN_POSITION ? -1 : int(v);
+}
+
+size_t Serialize(const State& state, uint8_t* out)
+{
+    uint8_t* p = out;
+    *p++ = STATE_FORMAT_VERSION;
+    *p++ = uint8_t(state.timeStep);
+    *p++ = uint8_t(state.timeStep >> 8);
+
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        const AgentInfo& a = state.agents[i];
+        const bool wide = a.bombCount < 0 || a.bombCount > 15 || a.maxBombCount < 0
+                          || a.maxBombCount > 15 || a.bombStrength < 0 || a.bombStrength > 255;
+
+        *p++ = uint8_t(PackPosition(a.x) | PackPosition(a.y) << 4);
+        *p++ = uint8_t(a.canKick | a.dead << 1 | wide << 2);
+        if(wide)
+        {
+            *p++ = uint8_t(a.bombCount);
+            *p++ = uint8_t(a.maxBombCount);
+        }
+        else
+        {
+            *p++ = uint8_t(a.bombCount | a.maxBombCount << 4);
+        }
+        *p++ = uint8_t(a.bombStrength);
+    }
+
+    // cell codes
+    uint8_t codes[CELL_COUNT + 1];
+    codes[CELL_COUNT] = 0;
+    for(int i = 0; i < CELL_COUNT; i++)
+    {
+        codes[i] = CellCode(state[Cell(i)]);
+    }
+    for(int i = 0; i < CELL_COUNT; i += 2)
+    {
+        *p++ = uint8_t(codes[i] | codes[i + 1] << 4);
+    }
+
+    // extra bits
+    BitWriter w = {p};
+    for(int i = 0; i < CELL_COUNT; i++)
+    {
+        const int item = state[Cell(i)];
+        switch(codes[i])
+        {
+            case CODE_FLAME:
+                w.Put(uint32_t(FLAME_ID(item) | FLAME_POWFLAG(item) << 7), FLAME_BITS);
+                break;
+            case CODE_FLAGGED_WOOD:
+                w.Put(uint32_t(WOOD_POWFLAG(item)), WOOD_FLAG_BITS);
+                break;
+            case CODE_ESCAPE:
+                w.Put(uint32_t(item), ESCAPE_BITS);
+                break;
+        }
+    }
+    p = w.Finish();
+
+    *p++ = uint8_t(state.bombs.count);
+    for(int i = 0; i < state.bombs.count; i++)
+    {
+        const Bomb b = state.bombs[i];
+        *p++ = uint8_t(b);
+        *p++ = uint8_t(b >> 8);
+        *p++ = uint8_t(b >> 16);
+    }
+
+    *p++ = uint8_t(state.flames.count);
+    for(int i = 0; i < state.flames.count; i++)
+    {
+        const Flame& f = state.flames[i];
+        *p++ = f.cell;
+        *p++ = uint8_t(f.timeLeft << 4 | f.strength);
+    }
+
+    return size_t(p - out);
+}
+
+std::vector<uint8_t> Serialize(const State& state)
+{
+    uint8_t buffer[MAX_SERIALIZED_SIZE];
+    size_t size = Serialize(state, buffer);
+    return std::vector<uint8_t>(buffer, buffer + size);
+}
+
+bool Deserialize(const uint8_t* data, size_t size, State& state)
+{
+    const uint8_t* p = data;
+    const uint8_t* end = data + size;
+
+    // header, agents (at least 3 bytes each) and cells
+    if(size < size_t(3 + AGENT_COUNT * 3 + (CELL_COUNT + 1) / 2)
+            || *p++ != STATE_FORMAT_VERSION)
+    {
+        return false;
+    }
+
+    state = State();
+    state.timeStep = p[0] | p[1] << 8;
+    p += 2;
+
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        AgentInfo& a = state.agents[i];
+        const bool wide = p[1] & 0b100;
+        if(p + (wide ? 5 : 4) > end)
+        {
+            return false;
+        }
+        a.x = UnpackPosition(p[0] & 0xF);
+        a.y = UnpackPosition(p[0] >> 4);
+        a.canKick = p[1] & 0b1;
+        a.dead = p[1] & 0b10;
+        p += 2;
+        if(wide)
+        {
+            a.bombCount = int8_t(*p++);
+            a.maxBombCount = int8_t(*p++);
+        }
+        else
+        {
+            a.bombCount = *p & 0xF;
+            a.maxBombCount = *p++ >> 4;
+        }
+        a.bombStrength = *p++;
+    }
+    state.UpdateAlive();
+
+    if(p + (CELL_COUNT + 1) / 2 > end)
+    {
+        return false;
+    }
+    uint8_t codes[CELL_COUNT + 1];
+    for(int i = 0; i < CELL_COUNT; i += 2)
+    {
+        codes[i] = *p & 0xF;
+        codes[i + 1] = *p++ >> 4;
+    }
+
+    BitReader r = {p, end};
+    for(int i = 0; i < CELL_COUNT; i++)
+    {
+        const uint8_t code = codes[i];
+        uint32_t extra = 0;
+        if(code == CODE_FLAME)
+        {
+            if(!r.Get(FLAME_BITS, extra)) return false;
+            state[Cell(i)] = Item::FLAMES + int((extra & 0x7F) << 3) + int(extra >> 7);
+        }
+        else if(code == CODE_FLAGGED_WOOD)
+        {
+            if(!r.Get(WOOD_FLAG_BITS, extra)) return false;
+            state[Cell(i)] = Item::WOOD + int(extra);
+        }
+        else if(code == CODE_ESCAPE)
+        {
+            if(!r.Get(ESCAPE_BITS, extra)) return false;
+            state[Cell(i)] = int(extra);
+        }
+        else if(code == CODE_WOOD)
+        {
+            state[Cell(i)] = Item::WOOD;
+        }
+        else if(code >= CODE_AGENT0)
+        {
+            state[Cell(i)] = Item::AGENT0 + code - CODE_AGENT0;
+        }
+        else
+        {
+            state[Cell(i)] = code;
+        }
+    }
+    p = r.in;
+
+    if(p >= end || *p > MAX_BOMBS || p + 1 + *p * 3 > end)
+    {
+        return false;
+    }
+    const int bombCount = *p++;
+    for(int i = 0; i < bombCount; i++)
+    {
+        state.bombs.AddElem(Bomb(p[0] | p[1] << 8 | p[2] << 16));
+        p += 3;
+    }
+
+    if(p >= end || *p > MAX_BOMBS || p + 1 + *p * 2 > end)
+    {
+        return false;
+    }
+    const int flameCount = *p++;
+    for(int i = 0; i < flameCount; i++)
+    {
+        if(p[0] >= CELL_COUNT)
+        {
+            return false;
+        }
+        Flame& f = state.flames.NextPos();
+        f.cell = p[0];
+        f.timeLeft = p[1] >> 4;
+        f.strength = p[1] & 0xF;
+        state.flames.count++;
+        p += 2;
+    }
+
+    return p == end;
+}
+
+}
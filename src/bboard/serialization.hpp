@@ -0,0 +1,62 @@
+#ifndef SERIALIZATION_H
+#define SERIALIZATION_H
+
+#include <vector>
+#include <cstdint>
+
+#include "bboard.hpp"
+
+namespace bboard
+{
+
+const uint8_t STATE_FORMAT_VERSION = 1;
+
+/**
+ * Upper bound for the size of a serialized state (all cells
+ * escaped, all queues full)
+ */
+const int MAX_SERIALIZED_SIZE = 3 + AGENT_COUNT * 5 + (BOARD_SIZE * BOARD_SIZE + 1) / 2
+                                + BOARD_SIZE * BOARD_SIZE * 4 + 1 + 2 + MAX_BOMBS * 5;
+
+/**
+ * Canonical binary format (version 1), little endian:
+ *
+ *   byte     version
+ *   2 bytes  time step
+ *   per agent:
+ *     byte   x | y << 4 (15 means hidden)
+ *     byte   canKick | dead << 1 | wide << 2
+ *     wide = 0: 2 bytes   bombCount | maxBombCount << 4, bombStrength
+ *     wide = 1: 3 bytes   bombCount, maxBombCount, bombStrength
+ *   61 bytes  one 4-bit code per cell (see CellCode)
+ *   n bytes   extra bits of flames, flagged wood and escaped cells
+ *   byte     bomb count, then 3 bytes per live bomb (its lower 24 bits)
+ *   byte     flame count, then 2 bytes per live flame
+ *             (cell index, timeLeft << 4 | strength)
+ *
+ * Only live queue entries are written and aliveAgents is derived
+ * from the dead flags, so equal positions serialize to equal bytes.
+ * A typical state takes around 100 bytes.
+ */
+
+/**
+ * @brief Serialize Writes the state into a buffer
+ * @param out Buffer with at least MAX_SERIALIZED_SIZE bytes
+ * @return The amount of written bytes
+ */
+size_t Serialize(const State& state, uint8_t* out);
+
+/**
+ * @brief Serialize Returns the serialized state
+ */
+std::vector<uint8_t> Serialize(const State& state);
+
+/**
+ * @brief Deserialize Reads a state written by Serialize.
+ * @return False if the data is not a valid serialized state
+ */
+bool Deserialize(const uint8_t* data, size_t size, State& state);
+
+}
+
+#endif // SERIALIZATION_H
@@ -7,73 +7,124 @@ namespace bboard
 {
 
 
-void Step(State* state, Move* moves)
+/**
+ * Moves the agents ids[0..N-1] (ascending) that were alive at the
+ * start of the step. Agents that died before are left out
+ * completely (their moves have to be IDLE, so they could not block
+ * anyone), which gives all loops a fixed trip count. Otherwise this
+ * is the same procedure as with the util functions: fill the
+ * destinations, fix switches, resolve dependency chains and move
+ * chain by chain.
+ *
+ * @brief MoveAgents Player movement of a single step
+ */
+template<class R, int N>
+void MoveAgents(State* state, const Move* moves, const int* ids)
 {
-    ///////////////////////
-    // Flames, Explosion //
-    ///////////////////////
-
-    util::TickFlames(*state);
-    util::TickBombs(*state);
-
-    ///////////////////////
-    //  Player Movement  //
-    ///////////////////////
+    Cell source[N];
+    Cell destPos[N];
+    bool alive[N];
+    for(int k = 0; k < N; k++)
+    {
+        const Move m = moves[ids[k]];
+        source[k] = util::AgentCell(state->agents[ids[k]]);
+        destPos[k] = source[k] == NO_CELL || unsigned(m) > unsigned(Move::BOMB)
+                     ? source[k] : Neighbor(source[k], m);
+        alive[k] = !state->agents[ids[k]].dead;
+    }
 
-    Position destPos[AGENT_COUNT];
-    util::FillDestPos(state, moves, destPos);
-    util::FixSwitchMove(state, destPos);
+    // agents can't switch places (not even with an agent that
+    // was just killed by a bomb)
+    for(int k = 0; k < N; k++)
+    {
+        for(int l = k + 1; l < N; l++)
+        {
+            if(destPos[k] == source[l] && destPos[l] == source[k])
+            {
+                destPos[k] = source[k];
+                destPos[l] = source[l];
+            }
+        }
+    }
 
-    int dependency[AGENT_COUNT] = {-1, -1, -1, -1};
-    int roots[AGENT_COUNT] = {-1, -1, -1, -1};
+    int dependency[N];
+    int roots[N];
+    int rootNumber = 0;
+    for(int k = 0; k < N; k++)
+    {
+        dependency[k] = -1;
+    }
+    for(int k = 0; k < N; k++)
+    {
+        // dead agents are handled as roots
+        bool isChainRoot = true;
+        for(int l = 0; l < N && alive[k]; l++)
+        {
+            if(k != l && alive[l] && destPos[k] == source[l])
+            {
+                dependency[l] = k;
+                isChainRoot = false;
+                break;
+            }
+        }
+        if(isChainRoot)
+        {
+            roots[rootNumber++] = k;
+        }
+    }
 
-    // the amount of chain roots
-    const int rootNumber = util::ResolveDependencies(state, destPos, dependency, roots);
-    const bool ouroboros = rootNumber == 0; // ouroboros formation?
+    // dead agents count as chain roots, so only a full
+    // board can be an ouroboros formation
+    if(rootNumber == 0 && N < AGENT_COUNT)
+    {
+        return;
+    }
+    const bool ouroboros = rootNumber == 0;
 
     int rootIdx = 0;
-    int i = rootNumber == 0 ? 0 : roots[0]; // no roots -> start from 0
+    int k = rootNumber == 0 ? 0 : roots[0]; // no roots -> start from 0
 
-    // iterates 4 times but the index i jumps around the dependencies
-    for(int _ = 0; _ < AGENT_COUNT; _++, i = dependency[i])
+    // iterates N times but the index k jumps around the dependencies
+    for(int _ = 0; _ < N; _++, k = dependency[k])
     {
-        if(i == -1)
+        if(k == -1)
         {
-            rootIdx++;
-            i = roots[rootIdx];
+            // agents that are not part of any chain compete
+            // for a destination and can't move
+            if(++rootIdx >= rootNumber) break;
+            k = roots[rootIdx];
         }
+        const int i = ids[k];
         const Move m = moves[i];
 
-        if(state->agents[i].dead || m == Move::IDLE)
+        if(!alive[k] || m == Move::IDLE)
         {
             continue;
         }
         else if(m == Move::BOMB)
         {
-            state->PlantBomb(state->agents[i].x, state->agents[i].y, i);
+            state->PlantBomb<R>(state->agents[i].x, state->agents[i].y, i);
             continue;
         }
 
-
         int x = state->agents[i].x;
         int y = state->agents[i].y;
 
-        Position desired = destPos[i];
+        const Cell desired = destPos[k];
 
-        if(util::IsOutOfBounds(desired))
+        if(desired == NO_CELL)
         {
             continue;
         }
 
-        int itemOnDestination = state->board[desired.y][desired.x];
+        int itemOnDestination = (*state)[desired];
 
         //if ouroboros, the bomb will be covered by an agent
         if(ouroboros)
         {
             for(int j = 0; j < state->bombs.count; j++)
             {
-                if(BMB_POS_X(state->bombs[j]) == desired.x
-                        && BMB_POS_Y(state->bombs[j]) == desired.y)
+                if(BMB_CELL(state->bombs[j]) == desired)
                 {
                     itemOnDestination = Item::BOMB;
                     break;
@@ -98,7 +149,18 @@ void Step(State* state, Move* moves)
             }
             continue;
         }
-        if(util::HasDPCollision(*state, destPos, i))
+
+        // destination collision (agents that just died don't count)
+        bool collision = false;
+        for(int l = 0; l < N; l++)
+        {
+            if(l != k && destPos[l] == desired && !state->agents[ids[l]].dead)
+            {
+                collision = true;
+                break;
+            }
+        }
+        if(collision)
         {
             continue;
         }
@@ -135,13 +197,215 @@ void Step(State* state, Move* moves)
                 }
 
             }
-            state->board[desired.y][desired.x] = Item::AGENT0 + i;
-            state->agents[i].x = desired.x;
-            state->agents[i].y = desired.y;
+            (*state)[desired] = Item::AGENT0 + i;
+            state->agents[i].x = CellX(desired);
+            state->agents[i].y = CellY(desired);
         }
+    }
+}
 
+static_assert (AGENT_COUNT == 4, "Step dispatches on 1 to 4 living agents");
+
+template<class R>
+void Step(State* state, Move* moves)
+{
+    ///////////////////////
+    // Flames, Explosion //
+    ///////////////////////
+
+    // agents killed by the explosions still block switches
+    const int aliveMask = state->aliveMask;
+
+    util::TickFlames(*state);
+    util::TickBombs<R>(*state);
+
+    ///////////////////////
+    //  Player Movement  //
+    ///////////////////////
+
+    int ids[AGENT_COUNT];
+    int n = 0;
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        if(aliveMask & (1 << i))
+        {
+            ids[n++] = i;
+        }
+    }
+
+    switch(n)
+    {
+        case 1: MoveAgents<R, 1>(state, moves, ids); break;
+        case 2: MoveAgents<R, 2>(state, moves, ids); break;
+        case 3: MoveAgents<R, 3>(state, moves, ids); break;
+        case 4: MoveAgents<R, 4>(state, moves, ids); break;
+        default: break;
     }
+}
+
+#define INSTANTIATE_STEP_RULES(R) template void Step<R>(State*, Move*);
+BBOARD_RULESETS(INSTANTIATE_STEP_RULES)
+
+void Step(State* state, Move* moves)
+{
+    Step<StandardRules>(state, moves);
+}
 
+void Step(State* state, Move* moves, const Rules& rules)
+{
+    DispatchRules(rules.preset, [state, moves](auto r)
+    {
+        Step<decltype(r)>(state, moves);
+    });
+}
+
+/**
+ * @brief AddChange Adds a cell to the changes (its item is read
+ * after the step)
+ */
+inline void AddChange(StepDelta& delta, bool* seen, Cell c)
+{
+    if(c != NO_CELL && !seen[c])
+    {
+        seen[c] = true;
+        delta.changes[delta.changeCount++].cell = c;
+    }
+}
+
+/**
+ * @brief AddFlameCells Adds the cells that carry the flame (its
+ * origin and the rays up to the first RIGID cell)
+ */
+void AddFlameCells(const State& state, StepDelta& delta, bool* seen, const Flame& f)
+{
+    const int origin = PaddedIndex(f.cell);
+    if(IS_FLAME(state.board.cells[origin]) && FLAME_ID(state.board.cells[origin]) == f.cell)
+    {
+        AddChange(delta, seen, f.cell);
+    }
+    for(int m = int(Move::UP); m <= int(Move::RIGHT); m++)
+    {
+        const int step = PADDED_STEP[m];
+        for(int i = 1, p = origin + step; i <= f.strength; i++, p += step)
+        {
+            const int item = state.board.cells[p];
+            if(item == Item::RIGID)
+            {
+                break;
+            }
+            if(IS_FLAME(item) && FLAME_ID(item) == f.cell)
+            {
+                AddChange(delta, seen, UnpaddedCell(p));
+            }
+        }
+    }
+}
+
+void Step(State* state, Move* moves, const Rules& rules, StepDelta& delta)
+{
+    delta.changeCount = 0;
+    delta.explodedCount = 0;
+    delta.plantedCount = 0;
+    delta.extinguishedCount = 0;
+    delta.spawnedCount = 0;
+    delta.movedMask = 0;
+    delta.diedMask = 0;
+
+    bool seen[CELL_COUNT] = {};
+
+    // flames that burn out in this step (TickFlames pops them from
+    // the front), their cells have to be found before
+    const int flameCount = state->flames.count;
+    while(delta.extinguishedCount < flameCount && state->flames[delta.extinguishedCount].timeLeft == 1)
+    {
+        const Flame& f = state->flames[delta.extinguishedCount];
+        delta.extinguished[delta.extinguishedCount++] = f;
+        AddFlameCells(*state, delta, seen, f);
+    }
+
+    const int bombCount = state->bombs.count;
+    Bomb bombs[MAX_BOMBS];
+    for(int i = 0; i < bombCount; i++)
+    {
+        bombs[i] = state->bombs[i];
+    }
+
+    bool dead[AGENT_COUNT];
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        delta.from[i] = util::AgentCell(state->agents[i]);
+        dead[i] = state->agents[i].dead;
+    }
+
+    Step(state, moves, rules);
+
+    // the survivors keep their order, new bombs are appended
+    int j = 0;
+    for(int i = 0; i < bombCount; i++)
+    {
+        Bomb ticked = bombs[i];
+        ReduceBombTimer(ticked);
+        if(j < state->bombs.count && state->bombs[j] == ticked)
+        {
+            j++;
+        }
+        else
+        {
+            delta.exploded[delta.explodedCount++] = bombs[i];
+        }
+    }
+    for(; j < state->bombs.count; j++)
+    {
+        delta.planted[delta.plantedCount++] = state->bombs[j];
+    }
+
+    delta.spawnedCount = state->flames.count - (flameCount - delta.extinguishedCount);
+    for(int i = state->flames.count - delta.spawnedCount; i < state->flames.count; i++)
+    {
+        delta.spawned[i - state->flames.count + delta.spawnedCount] = state->flames[i];
+        AddFlameCells(*state, delta, seen, state->flames[i]);
+    }
+
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        delta.to[i] = util::AgentCell(state->agents[i]);
+        if(state->agents[i].dead && !dead[i])
+        {
+            delta.diedMask |= 1 << i;
+            AddChange(delta, seen, delta.from[i]);
+        }
+        else if(delta.to[i] != delta.from[i])
+        {
+            delta.movedMask |= 1 << i;
+            AddChange(delta, seen, delta.from[i]);
+            AddChange(delta, seen, delta.to[i]);
+        }
+    }
+
+    for(int i = 0; i < delta.changeCount; i++)
+    {
+        delta.changes[i].item = (*state)[delta.changes[i].cell];
+    }
+}
+
+void ApplyDelta(State& state, const StepDelta& delta)
+{
+    for(int i = 0; i < delta.changeCount; i++)
+    {
+        state[delta.changes[i].cell] = delta.changes[i].item;
+    }
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        if(delta.diedMask & (1 << i))
+        {
+            state.Kill(i);
+        }
+        else if(delta.movedMask & (1 << i))
+        {
+            state.agents[i].x = CellX(delta.to[i]);
+            state.agents[i].y = CellY(delta.to[i]);
+        }
+    }
 }
 
 }
@@ -90,6 +90,77 @@ int ResolveDependencies(State* s, Position des[AGENT_COUNT],
     return rootCount;
 }
 
+void FillDestCells(const State* s, const Move m[AGENT_COUNT], Cell c[AGENT_COUNT])
+{
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        // dead agents can have any move (unknown moves stay)
+        const Cell source = AgentCell(s->agents[i]);
+        c[i] = source == NO_CELL || unsigned(m[i]) > unsigned(Move::BOMB)
+               ? source : Neighbor(source, m[i]);
+    }
+}
+
+void FixSwitchMove(const State* s, Cell d[AGENT_COUNT])
+{
+    Cell source[AGENT_COUNT];
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        source[i] = AgentCell(s->agents[i]);
+    }
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        for(int j = i; j < AGENT_COUNT; j++)
+        {
+            if(d[i] == source[j] && d[j] == source[i])
+            {
+                d[i] = source[i];
+                d[j] = source[j];
+            }
+        }
+    }
+}
+
+int ResolveDependencies(const State* s, const Cell des[AGENT_COUNT],
+                        int dependency[AGENT_COUNT], int chain[AGENT_COUNT])
+{
+    Cell source[AGENT_COUNT];
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        source[i] = AgentCell(s->agents[i]);
+    }
+
+    int rootCount = 0;
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        // dead agents are handled as roots
+        if(s->agents[i].dead)
+        {
+            chain[rootCount] = i;
+            rootCount++;
+            continue;
+        }
+
+        bool isChainRoot = true;
+        for(int j = 0; j < AGENT_COUNT; j++)
+        {
+            if(i == j || s->agents[j].dead) continue;
+
+            if(des[i] == source[j])
+            {
+                dependency[j] = i;
+                isChainRoot = false;
+                break;
+            }
+        }
+        if(isChainRoot)
+        {
+            chain[rootCount] = i;
+            rootCount++;
+        }
+    }
+    return rootCount;
+}
 
 void TickFlames(State& state)
 {
@@ -107,6 +178,7 @@ void TickFlames(State& state)
     }
 }
 
+template<class R>
 void TickBombs(State& state)
 {
     for(int i = 0; i < state.bombs.count; i++)
@@ -120,7 +192,7 @@ void TickBombs(State& state)
     {
         if(BMB_TIME(state.bombs[0]) == 0)
         {
-            state.ExplodeTopBomb();
+            state.ExplodeTopBomb<R>();
         }
         else
         {
@@ -130,6 +202,9 @@ void TickBombs(State& state)
     }
 }
 
+#define INSTANTIATE_TICK_RULES(R) template void TickBombs<R>(State&);
+BBOARD_RULESETS(INSTANTIATE_TICK_RULES)
+
 void ConsumePowerup(State& state, int agentID, int powerUp)
 {
     if(powerUp == Item::EXTRABOMB)
@@ -162,6 +237,19 @@ bool HasDPCollision(const State& state, Position dp[AGENT_COUNT], int agentID)
     return false;
 }
 
+bool HasDPCollision(const State& state, const Cell dest[AGENT_COUNT], int agentID)
+{
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        if(agentID == i || state.agents[i].dead) continue;
+        if(dest[agentID] == dest[i])
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 void PrintDependency(int dependency[AGENT_COUNT])
 {
     for(int i = 0; i < AGENT_COUNT; i++)
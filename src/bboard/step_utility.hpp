@@ -39,6 +39,31 @@ void FixSwitchMove(State* s, Position desiredPositions[AGENT_COUNT]);
 int ResolveDependencies(State* s, Position des[AGENT_COUNT],
                         int dependency[AGENT_COUNT], int chain[AGENT_COUNT]);
 
+/**
+ * @brief AgentCell Returns the cell of an agent (NO_CELL if hidden)
+ */
+inline Cell AgentCell(const AgentInfo& a)
+{
+    return ToCell(Position{a.x, a.y});
+}
+
+/**
+ * @brief FillDestCells Fills an array of destination cells
+ * (NO_CELL if the move leaves the board)
+ */
+void FillDestCells(const State* s, const Move m[AGENT_COUNT], Cell c[AGENT_COUNT]);
+
+/**
+ * @brief FixSwitchMove Same as above for destination cells
+ */
+void FixSwitchMove(const State* s, Cell dest[AGENT_COUNT]);
+
+/**
+ * @brief ResolveDependencies Same as above for destination cells
+ */
+int ResolveDependencies(const State* s, const Cell dest[AGENT_COUNT],
+                        int dependency[AGENT_COUNT], int chain[AGENT_COUNT]);
+
 /**
  * @brief TickFlames Counts down all flames in the flame queue
  * (and possible extinguishes the flame)
@@ -47,8 +72,9 @@ void TickFlames(State& state);
 
 /**
  * @brief TickBombs Counts down all bomb timers and explodes them
- * if they arrive at 10
+ * if they arrive at 0
  */
+template<class R = StandardRules>
 void TickBombs(State& state);
 
 /**
@@ -82,6 +108,7 @@ void PrintDependencyChain(int dependency[AGENT_COUNT], int chain[AGENT_COUNT]);
  * @return True if there is at least one collision
  */
 bool HasDPCollision(const State& state, Position dp[AGENT_COUNT], int agentID);
+bool HasDPCollision(const State& state, const Cell dest[AGENT_COUNT], int agentID);
 
 /**
  * @brief IsOutOfBounds Checks wether a given position is out of bounds
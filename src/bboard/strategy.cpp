@@ -34,60 +34,54 @@ int RMap::GetPredecessor(int x, int y) const
     return map[y][x] >> 16;
 }
 
-template <typename T, int N>
-inline RMapInfo TryAdd(const State& s, FixedQueue<T, N>& q, RMap& r, Position& c, int cx, int cy)
-{
-    int dist = r.GetDistance(c.x, c.y);
-    int item = s.board[cy][cx];
-    if(!util::IsOutOfBounds(cx, cy) &&
-            r.GetDistance(cx, cy) == 0 &&
-            (IS_WALKABLE(item) || item >= Item::AGENT0))
-    {
-        r.SetPredecessor(cx, cy, c.x, c.y);
-        r.SetDistance(cx, cy, dist + 1);
-
-        // we compute paths to agent positions but don't
-        // continue search
-        if(item < Item::AGENT0)
-            q.AddElem({cx, cy});
-        return 0;
-    }
-    return 0;
-}
 // BFS
 void FillRMap(const State& s, RMap& r, int agentID)
 {
     std::fill(r.map[0], r.map[0] + BOARD_SIZE * BOARD_SIZE, 0);
-    int x = s.agents[agentID].x;
-    int y = s.agents[agentID].y;
-    r.source = {x, y};
+    const AgentInfo& a = s.agents[agentID];
+    const Cell source = ToCell(a.x, a.y);
+    r.source = {a.x, a.y};
 
-    FixedQueue<Position, BOARD_SIZE * BOARD_SIZE> queue;
-    r.SetDistance(x, y, 0);
-    queue.AddElem({x, y});
+    FixedQueue<Cell, CELL_COUNT> queue;
+    r.SetDistance(source, 0);
+    queue.AddElem(source);
 
-    const AgentInfo& a = s.agents[agentID];
+    // expansion order of the neighbors
+    const Move order[4] = {Move::DOWN, Move::UP, Move::RIGHT, Move::LEFT};
     RMapInfo result = 0;
 
     while(queue.count != 0)
     {
-
-        Position& c = queue.PopElem();
-        int dist = r.GetDistance(c.x, c.y);
-        if(IsInBombRange(a.x, a.y, a.bombStrength, c) && dist < 10)
+        const Cell c = queue.PopElem();
+        const int dist = r.GetDistance(c);
+        if(IsInBombRange(a.x, a.y, a.bombStrength, ToPosition(c)) && dist < 10)
         {
             result |= 0b1;
         }
 
-        if(c.x != x || c.y+1 != y)
-            TryAdd(s, queue, r, c, c.x, c.y + 1);
-        if(c.x != x || c.y-1 != y)
-            TryAdd(s, queue, r, c, c.x, c.y - 1);
-        if(c.x+1 != x || c.y != y)
-            TryAdd(s, queue, r, c, c.x + 1, c.y);
-        if(c.x-1 != x || c.y != y)
-            TryAdd(s, queue, r, c, c.x - 1, c.y);
+        const int p = PaddedIndex(c);
+        for(Move m : order)
+        {
+            // the border is RIGID and never walkable
+            const int q = p + PADDED_STEP[int(m)];
+            const int item = s.board.cells[q];
+            if(!IS_WALKABLE(item) && item < Item::AGENT0)
+            {
+                continue;
+            }
+            const Cell n = UnpaddedCell(q);
+            if(n == source || r.GetDistance(n) != 0)
+            {
+                continue;
+            }
+            r.SetPredecessor(n, c);
+            r.SetDistance(n, dist + 1);
 
+            // we compute paths to agent positions but don't
+            // continue search
+            if(item < Item::AGENT0)
+                queue.AddElem(n);
+        }
     }
     r.info = result;
 }
@@ -98,24 +92,23 @@ void FillRMap(const State& s, RMap& r, int agentID)
 
 Move MoveTowardsPosition(const RMap& r, const Position& position)
 {
-    Position curr = position;
+    const Cell source = ToCell(r.source.x, r.source.y);
+    Cell curr = ToCell(position.x, position.y);
     for(int i = 0;; i++)
     {
-        int idx = r.GetPredecessor(curr.x, curr.y);
-        int y = idx / BOARD_SIZE;
-        int x = idx % BOARD_SIZE;
-        if(x == r.source.x && y == r.source.y)
+        const Cell predecessor = r.GetPredecessor(curr);
+        if(predecessor == source)
         {
-            if(curr.x > r.source.x) return Move::RIGHT;
-            if(curr.x < r.source.x) return Move::LEFT;
-            if(curr.y > r.source.y) return Move::DOWN;
-            if(curr.y < r.source.y) return Move::UP;
+            if(CellX(curr) > r.source.x) return Move::RIGHT;
+            if(CellX(curr) < r.source.x) return Move::LEFT;
+            if(CellY(curr) > r.source.y) return Move::DOWN;
+            if(CellY(curr) < r.source.y) return Move::UP;
         }
-        else if(r.GetDistance(curr.x, curr.y) == 0)
+        else if(r.GetDistance(curr) == 0)
         {
             return Move::IDLE;
         }
-        curr = {x, y};
+        curr = predecessor;
     }
 }
 
@@ -123,12 +116,11 @@ Move MoveTowardsSafePlace(const State& state, const RMap& r, int radius)
 {
     int originX = r.source.x;
     int originY = r.source.y;
-    for(int y = originY - radius; y < radius; y++)
+    for(int y = std::max(0, originY - radius); y < std::min(radius, BOARD_SIZE); y++)
     {
-        for(int x = originX - radius; x < radius; x++)
+        for(int x = std::max(0, originX - radius); x < std::min(radius, BOARD_SIZE); x++)
         {
-            if(util::IsOutOfBounds({x, y}) ||
-                    std::abs(x - originX) + std::abs(y - originY) > radius) continue;
+            if(std::abs(x - originX) + std::abs(y - originY) > radius) continue;
 
             if(r.GetDistance(x, y) != 0 && !IsInDanger(state, x, y))
             {
@@ -142,12 +134,11 @@ Move MoveTowardsSafePlace(const State& state, const RMap& r, int radius)
 Move MoveTowardsPowerup(const State& state, const RMap& r, int radius)
 {
     const Position& a = r.source;
-    for(int y = a.y - radius; y <= a.y + radius; y++)
+    for(int y = std::max(0, a.y - radius); y <= std::min(a.y + radius, BOARD_SIZE - 1); y++)
     {
-        for(int x = a.x - radius; x <= a.x + radius; x++)
+        for(int x = std::max(0, a.x - radius); x <= std::min(a.x + radius, BOARD_SIZE - 1); x++)
         {
-            if(util::IsOutOfBounds(x, y) ||
-                    std::abs(x - a.x) + std::abs(y - a.y) > radius) continue;
+            if(std::abs(x - a.x) + std::abs(y - a.y) > radius) continue;
 
             if(IS_POWERUP(state.board[y][x]))
             {
@@ -186,7 +177,8 @@ Move MoveTowardsEnemy(const State& state, const RMap& r, int radius)
 
 bool _CheckPos(const State& state, int x, int y)
 {
-    return !util::IsOutOfBounds(x, y) && IS_WALKABLE(state.board[y][x]);
+    // at most one cell off the board (the RIGID border)
+    return IS_WALKABLE(state.board[y][x]);
 }
 
 void SafeDirections(const State& state, FixedQueue<Move, MOVE_COUNT>& q, int x, int y)
@@ -264,10 +256,7 @@ void PrintPath(RMap &r, Position from, Position to)
     for(uint i = 0; !(curr == from); i++)
     {
         pathx.insert(curr);
-        int idx = r.GetPredecessor(curr.x, curr.y);
-        int y = idx / BOARD_SIZE;
-        int x = idx % BOARD_SIZE;
-        curr = path[i] = {x, y};
+        curr = path[i] = ToPosition(r.GetPredecessor(ToCell(curr.x, curr.y)));
     }
 
     for(int i = 0; i < BOARD_SIZE; i++)
@@ -306,12 +295,11 @@ bool IsAdjacentItem(const State& state, int agentID, int distance, Item item)
     const AgentInfo& a = state.agents[agentID];
     const int originX = a.x;
     const int originY = a.y;
-    for(int y = originY - distance; y <= originY + distance; y++)
+    for(int y = std::max(0, originY - distance); y <= std::min(originY + distance, BOARD_SIZE - 1); y++)
     {
-        for(int x = originX - distance; x <= originX + distance; x++)
+        for(int x = std::max(0, originX - distance); x <= std::min(originX + distance, BOARD_SIZE - 1); x++)
         {
-            if(util::IsOutOfBounds(x, y) ||
-                    std::abs(x - originX) + std::abs(y - originY) > distance) continue;
+            if(std::abs(x - originX) + std::abs(y - originY) > distance) continue;
 
             if(IS_WOOD(item) && IS_WOOD(state.board[y][x]))
             {
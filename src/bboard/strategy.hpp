@@ -45,6 +45,26 @@ struct RMap
      */
     int  GetPredecessor(int x, int y) const;
     void SetPredecessor(int x, int y, int xPredecessor, int yPredecessor);
+
+    // cell versions (used by the BFS)
+    int GetDistance(Cell c) const
+    {
+        return *(&map[0][0] + c) & chalf;
+    }
+    void SetDistance(Cell c, int distance)
+    {
+        int& v = *(&map[0][0] + c);
+        v = (v & ~chalf) + distance;
+    }
+    Cell GetPredecessor(Cell c) const
+    {
+        return Cell(*(&map[0][0] + c) >> 16);
+    }
+    void SetPredecessor(Cell c, Cell predecessor)
+    {
+        int& v = *(&map[0][0] + c);
+        v = (v & chalf) + (predecessor << 16);
+    }
 };
 
 /**
@@ -126,13 +146,14 @@ void SafeDirections(const State& state, FixedQueue<Move, MOVE_COUNT>& q, int x,
  */
 template <int X>
 void SortDirections(FixedQueue<Move, MOVE_COUNT>& q,
-                    FixedQueue<Position, X>& p, int x, int y)
+                    FixedQueue<Cell, X>& p, int x, int y)
 {
+    const Cell source = ToCell(x, y);
     int moves = q.count;
     for(int _ = 0; _ < moves; _++)
     {
         int i = _;
-        Position pos = util::DesiredPosition(x, y, q[i]);
+        const Cell pos = Neighbor(source, q[i]);
         for(int j = 0; j < p.count; j++)
         {
             if(pos == p[j])
@@ -0,0 +1,528 @@
+#include <cstddef>
+#include <cstring>
+
+#include "bboard.hpp"
+#include "trajectory.hpp"
+
+namespace bboard
+{
+
+const uint8_t TRAJECTORY_MAGIC[4] = {'B', 'B', 'T', 'R'};
+const uint8_t TRAJECTORY_VERSION = 3;
+
+/////////////////////
+// Byte Primitives //
+/////////////////////
+
+inline void PutVarint(std::vector<uint8_t>& out, uint32_t v)
+{
+    while(v >= 0x80)
+    {
+        out.push_back(uint8_t(v) | 0x80);
+        v >>= 7;
+    }
+    out.push_back(uint8_t(v));
+}
+
+/**
+ * @brief GetVarint Reads a varint that ends before end
+ * @return False if the data is truncated or the varint is too long
+ */
+inline bool GetVarint(const uint8_t*& p, const uint8_t* end, uint32_t& v)
+{
+    v = 0;
+    for(int shift = 0; shift < 35 && p < end; shift += 7)
+    {
+        const uint8_t b = *p++;
+        v |= uint32_t(b & 0x7F) << shift;
+        if(!(b & 0x80))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline void PutU32(std::vector<uint8_t>& out, uint32_t v)
+{
+    for(int i = 0; i < 4; i++)
+    {
+        out.push_back(uint8_t(v >> (8 * i)));
+    }
+}
+
+inline uint32_t GetU32(const uint8_t* p)
+{
+    return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+}
+
+//////////
+// rANS //
+//////////
+
+// byte-wise rANS with 12-bit probabilities
+const int RANS_SCALE_BITS = 12;
+const uint32_t RANS_SCALE = 1 << RANS_SCALE_BITS;
+const uint32_t RANS_L = 1 << 23;
+
+// upper bound of a delta record: amount, then gap, mask and
+// four bytes for every word
+const uint64_t MAX_DELTA_SIZE = 5 + uint64_t(STATE_WORDS) * (5 + 1 + 4);
+
+/**
+ * @brief NormalizeFrequencies Scales symbol counts so that they
+ * sum up to RANS_SCALE, every occurring symbol keeps freq >= 1
+ */
+void NormalizeFrequencies(const uint32_t counts[256], uint32_t total, uint32_t freq[256])
+{
+    uint32_t sum = 0;
+    for(int s = 0; s < 256; s++)
+    {
+        freq[s] = 0;
+        if(counts[s] > 0)
+        {
+            freq[s] = std::max<uint32_t>(1, uint32_t(uint64_t(counts[s]) * RANS_SCALE / total));
+        }
+        sum += freq[s];
+    }
+    while(sum != RANS_SCALE)
+    {
+        int best = 0;
+        for(int s = 1; s < 256; s++)
+        {
+            if(freq[s] > freq[best]) best = s;
+        }
+        if(sum < RANS_SCALE)
+        {
+            freq[best] += RANS_SCALE - sum;
+            sum = RANS_SCALE;
+        }
+        else
+        {
+            freq[best]--;
+            sum--;
+        }
+    }
+}
+
+/**
+ * @brief EncodeChunk Appends a chunk (header, frequencies and
+ * rANS payload) to the output
+ */
+void EncodeChunk(const std::vector<uint8_t>& tokens, int steps, std::vector<uint8_t>& out)
+{
+    uint32_t counts[256] = {};
+    for(uint8_t t : tokens)
+    {
+        counts[t]++;
+    }
+    uint32_t freq[256], start[256];
+    NormalizeFrequencies(counts, uint32_t(tokens.size()), freq);
+    for(uint32_t s = 0, acc = 0; s < 256; s++)
+    {
+        start[s] = acc;
+        acc += freq[s];
+    }
+
+    // rANS encodes backwards
+    std::vector<uint8_t> payload(tokens.size() * 2 + 16);
+    uint8_t* ptr = payload.data() + payload.size();
+    uint32_t x = RANS_L;
+    for(size_t i = tokens.size(); i-- > 0;)
+    {
+        const uint32_t f = freq[tokens[i]];
+        const uint32_t xMax = ((RANS_L >> RANS_SCALE_BITS) << 8) * f;
+        while(x >= xMax)
+        {
+            *--ptr = uint8_t(x);
+            x >>= 8;
+        }
+        x = ((x / f) << RANS_SCALE_BITS) + (x % f) + start[tokens[i]];
+    }
+    ptr -= 4;
+    for(int i = 0; i < 4; i++)
+    {
+        ptr[i] = uint8_t(x >> (8 * i));
+    }
+    const uint32_t payloadSize = uint32_t(payload.data() + payload.size() - ptr);
+
+    PutU32(out, uint32_t(steps));
+    PutU32(out, uint32_t(tokens.size()));
+    PutU32(out, payloadSize);
+    for(int s = 0; s < 256; s++)
+    {
+        PutVarint(out, freq[s]);
+    }
+    out.insert(out.end(), ptr, ptr + payloadSize);
+}
+
+///////////////////////
+// TrajectoryEncoder //
+///////////////////////
+
+TrajectoryEncoder::TrajectoryEncoder(int keyframeInterval)
+{
+    this->keyframeInterval = keyframeInterval;
+    data.insert(data.end(), TRAJECTORY_MAGIC, TRAJECTORY_MAGIC + 4);
+    data.push_back(TRAJECTORY_VERSION);
+}
+
+void TrajectoryEncoder::Add(const State& state)
+{
+    uint32_t words[STATE_WORDS];
+    std::memcpy(words, &state, sizeof(State));
+
+    if(chunkSteps == 0)
+    {
+        // keyframe
+        const uint8_t* raw = reinterpret_cast<const uint8_t*>(words);
+        tokens.insert(tokens.end(), raw, raw + sizeof(State));
+    }
+    else
+    {
+        int changed = 0;
+        for(int i = 0; i < STATE_WORDS; i++)
+        {
+            changed += words[i] != previous[i];
+        }
+        PutVarint(tokens, uint32_t(changed));
+
+        int last = -1;
+        for(int i = 0; i < STATE_WORDS; i++)
+        {
+            const uint32_t diff = words[i] ^ previous[i];
+            if(diff == 0)
+            {
+                continue;
+            }
+            PutVarint(tokens, uint32_t(i - last - 1));
+            last = i;
+
+            uint8_t mask = 0;
+            for(int b = 0; b < 4; b++)
+            {
+                mask |= uint8_t(((diff >> (8 * b)) & 0xFF) != 0) << b;
+            }
+            tokens.push_back(mask);
+            for(int b = 0; b < 4; b++)
+            {
+                if(mask & (1 << b))
+                {
+                    tokens.push_back(uint8_t(diff >> (8 * b)));
+                }
+            }
+        }
+    }
+
+    std::memcpy(previous, words, sizeof(State));
+    chunkSteps++;
+    if(chunkSteps == keyframeInterval)
+    {
+        Flush();
+    }
+}
+
+void TrajectoryEncoder::Flush()
+{
+    if(chunkSteps == 0)
+    {
+        return;
+    }
+    EncodeChunk(tokens, chunkSteps, data);
+    tokens.clear();
+    chunkSteps = 0;
+}
+
+const std::vector<uint8_t>& TrajectoryEncoder::Data() const
+{
+    return data;
+}
+
+///////////////////////
+// TrajectoryDecoder //
+///////////////////////
+
+/**
+ * @brief ValidFlag Returns true if the bool holds 0 or 1 (the
+ * bytes of a decoded state are not trusted)
+ */
+inline bool ValidFlag(const bool& b)
+{
+    uint8_t v;
+    std::memcpy(&v, &b, 1);
+    return v <= 1;
+}
+
+/**
+ * @brief ValidItem Returns true if x is an item the engine can
+ * put on the board
+ */
+inline bool ValidItem(int x)
+{
+    if(IS_WOOD(x))
+    {
+        return (x & 0xFF) <= 3;
+    }
+    if(IS_FLAME(x))
+    {
+        return FLAME_ID(x) < CELL_COUNT;
+    }
+    return (x >= Item::PASSAGE && x <= Item::AGENTDUMMY)
+            || (x >= Item::AGENT0 && x <= Item::AGENT3);
+}
+
+// the board is stored first, delta records that stay below this
+// word only change cells
+static_assert (offsetof(State, board) == 0 && sizeof(Board) == PADDED_CELL_COUNT * 4,
+               "The board is stored in the first words of a State");
+
+/**
+ * @brief ValidCell Returns true if the item can be at the given
+ * index of Board::cells (the border is RIGID)
+ */
+inline bool ValidCell(int index, int item)
+{
+    const int x = index % PADDED_SIZE, y = index / PADDED_SIZE;
+    if(x == 0 || y == 0 || x == PADDED_SIZE - 1 || y == PADDED_SIZE - 1)
+    {
+        return item == Item::RIGID;
+    }
+    return ValidItem(item);
+}
+
+/**
+ * Checks everything Step and ApplyDelta index with except the
+ * board: agent positions and counters and the queues.
+ *
+ * @brief ValidFields Returns true if the fields after the board
+ * are safe to use
+ */
+bool ValidFields(const State& s)
+{
+    int aliveMask = 0, aliveAgents = 0;
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        const AgentInfo& a = s.agents[i];
+        if(!ValidFlag(a.dead) || !ValidFlag(a.canKick))
+        {
+            return false;
+        }
+        // hidden agents of observations are at (-1, -1)
+        const bool hidden = a.x == -1 && a.y == -1;
+        const bool onBoard = a.x >= 0 && a.x < BOARD_SIZE && a.y >= 0 && a.y < BOARD_SIZE;
+        if(!(hidden || onBoard)
+                || a.bombCount < 0 || a.bombCount > MAX_BOMBS
+                || a.maxBombCount < 0 || a.maxBombCount > MAX_BOMBS
+                || a.bombStrength < 0)
+        {
+            return false;
+        }
+        aliveMask |= int(!a.dead) << i;
+        aliveAgents += !a.dead;
+    }
+    if(s.aliveMask != aliveMask || s.aliveAgents != aliveAgents || s.timeStep < 0)
+    {
+        return false;
+    }
+
+    if(s.bombs.count < 0 || s.bombs.count > MAX_BOMBS || s.bombs.index < 0 || s.bombs.index >= MAX_BOMBS
+            || s.flames.count < 0 || s.flames.count > MAX_BOMBS || s.flames.index < 0 || s.flames.index >= MAX_BOMBS)
+    {
+        return false;
+    }
+    for(int i = 0; i < s.bombs.count; i++)
+    {
+        const Bomb b = s.bombs[i];
+        if(b < 0 || BMB_POS_X(b) >= BOARD_SIZE || BMB_POS_Y(b) >= BOARD_SIZE || BMB_ID(b) >= AGENT_COUNT)
+        {
+            return false;
+        }
+    }
+    for(int i = 0; i < s.flames.count; i++)
+    {
+        const Flame& f = s.flames[i];
+        if(f.cell >= CELL_COUNT || f.timeLeft < 0 || f.strength < 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief ValidState Returns true if a decoded state is safe to use
+ */
+bool ValidState(const State& s)
+{
+    for(int i = 0; i < PADDED_CELL_COUNT; i++)
+    {
+        if(!ValidCell(i, s.board.cells[i]))
+        {
+            return false;
+        }
+    }
+    return ValidFields(s);
+}
+
+TrajectoryDecoder::TrajectoryDecoder(const uint8_t* data, size_t size)
+{
+    this->data = data;
+    this->size = size;
+
+    if(size < 5 || std::memcmp(data, TRAJECTORY_MAGIC, 4) != 0
+            || data[4] != TRAJECTORY_VERSION)
+    {
+        // not a trajectory, there is nothing to decode
+        this->size = 0;
+    }
+    offset = 5;
+}
+
+bool TrajectoryDecoder::Reject()
+{
+    size = 0;
+    chunkStep = chunkSteps;
+    return false;
+}
+
+bool TrajectoryDecoder::NextChunk()
+{
+    if(offset + 12 > size)
+    {
+        return false;
+    }
+    const uint8_t* p = data + offset;
+    const uint8_t* end = data + size;
+    const uint32_t steps = GetU32(p);
+    const uint32_t tokenCount = GetU32(p + 4);
+    const uint32_t payloadSize = GetU32(p + 8);
+    p += 12;
+
+    // a chunk starts with a keyframe and has at most one
+    // record per further step
+    if(steps == 0 || steps > uint32_t(INT32_MAX) || tokenCount < sizeof(State)
+            || tokenCount > sizeof(State) + (steps - 1) * MAX_DELTA_SIZE)
+    {
+        return Reject();
+    }
+
+    uint32_t freq[256], start[256];
+    uint8_t symbol[RANS_SCALE];
+    uint32_t acc = 0;
+    for(uint32_t s = 0; s < 256; s++)
+    {
+        if(!GetVarint(p, end, freq[s]) || freq[s] > RANS_SCALE - acc)
+        {
+            return Reject();
+        }
+        start[s] = acc;
+        std::memset(symbol + acc, int(s), freq[s]);
+        acc += freq[s];
+    }
+    if(acc != RANS_SCALE || payloadSize < 4 || payloadSize > size_t(end - p))
+    {
+        return Reject();
+    }
+
+    tokens.resize(tokenCount);
+    uint32_t x = GetU32(p);
+    const uint8_t* ptr = p + 4;
+    const uint8_t* payloadEnd = p + payloadSize;
+    for(uint32_t i = 0; i < tokenCount; i++)
+    {
+        const uint32_t slot = x & (RANS_SCALE - 1);
+        const uint8_t s = symbol[slot];
+        tokens[i] = s;
+        x = freq[s] * (x >> RANS_SCALE_BITS) + slot - start[s];
+        while(x < RANS_L)
+        {
+            if(ptr == payloadEnd)
+            {
+                return Reject();
+            }
+            x = (x << 8) | *ptr++;
+        }
+    }
+
+    offset = size_t(payloadEnd - data);
+    chunkSteps = int(steps);
+    tokenPos = 0;
+    chunkStep = 0;
+    return true;
+}
+
+bool TrajectoryDecoder::Next(State& state)
+{
+    if(chunkStep == chunkSteps && !NextChunk())
+    {
+        return false;
+    }
+
+    const uint8_t* p = tokens.data() + tokenPos;
+    const uint8_t* end = tokens.data() + tokens.size();
+    bool fieldsChanged = false;
+    if(chunkStep == 0)
+    {
+        // NextChunk guarantees the tokens of the keyframe
+        std::memcpy(current, p, sizeof(State));
+        p += sizeof(State);
+    }
+    else
+    {
+        uint32_t changed;
+        if(!GetVarint(p, end, changed) || changed > uint32_t(STATE_WORDS))
+        {
+            return Reject();
+        }
+        uint32_t idx = uint32_t(-1);
+        for(uint32_t c = 0; c < changed; c++)
+        {
+            uint32_t gap;
+            if(!GetVarint(p, end, gap) || gap >= uint32_t(STATE_WORDS) - (idx + 1) || p == end)
+            {
+                return Reject();
+            }
+            idx += gap + 1;
+            const uint8_t mask = *p++;
+            uint32_t diff = 0;
+            for(int b = 0; b < 4; b++)
+            {
+                if(mask & (1 << b))
+                {
+                    if(p == end)
+                    {
+                        return Reject();
+                    }
+                    diff |= uint32_t(*p++) << (8 * b);
+                }
+            }
+            current[idx] ^= diff;
+
+            // only the changed words need to be checked again
+            if(idx < uint32_t(PADDED_CELL_COUNT))
+            {
+                int item;
+                std::memcpy(&item, current + idx, 4);
+                if(!ValidCell(int(idx), item))
+                {
+                    return Reject();
+                }
+            }
+            else
+            {
+                fieldsChanged = true;
+            }
+        }
+    }
+    tokenPos = size_t(p - tokens.data());
+    chunkStep++;
+
+    std::memcpy(&state, current, sizeof(State));
+    if(chunkStep == 1 ? !ValidState(state) : fieldsChanged && !ValidFields(state))
+    {
+        return Reject();
+    }
+    return true;
+}
+
+}
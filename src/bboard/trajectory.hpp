@@ -0,0 +1,122 @@
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include <vector>
+#include <cstdint>
+#include <type_traits>
+
+#include "bboard.hpp"
+
+namespace bboard
+{
+
+static_assert (std::is_trivially_copyable<State>::value, "States are stored bytewise");
+static_assert (sizeof(State) % 4 == 0, "States are stored as 32-bit words");
+
+const int STATE_WORDS = sizeof(State) / 4;
+
+/**
+ * Stores a sequence of states compactly. The trajectory is split
+ * into chunks, every chunk starts with a keyframe (the raw state)
+ * followed by one delta record per step:
+ *
+ *   varint  amount of changed 32-bit words
+ *   per changed word:
+ *     varint  gap to the previous changed word
+ *     byte    mask of the non-zero bytes of (new XOR old)
+ *     bytes   the non-zero bytes
+ *
+ * The bytes of a chunk are entropy coded with a static rANS coder
+ * (frequency table stored in front of the chunk). Chunks can be
+ * decoded independently.
+ *
+ * @brief Delta + entropy coder for state sequences
+ */
+class TrajectoryEncoder
+{
+
+private:
+
+    int keyframeInterval;
+    int chunkSteps = 0;
+
+    uint32_t previous[STATE_WORDS];
+    std::vector<uint8_t> tokens;
+    std::vector<uint8_t> data;
+
+public:
+
+    /**
+     * @param keyframeInterval Amount of steps per chunk
+     */
+    TrajectoryEncoder(int keyframeInterval = 1024);
+
+    /**
+     * @brief Add Appends the next state of the trajectory
+     */
+    void Add(const State& state);
+
+    /**
+     * @brief Flush Encodes the current (incomplete) chunk
+     */
+    void Flush();
+
+    /**
+     * @brief Data Returns the encoded trajectory. Call Flush first,
+     * otherwise the last chunk is missing.
+     */
+    const std::vector<uint8_t>& Data() const;
+};
+
+/**
+ * Every chunk is validated before it is used (frequency table,
+ * sizes and bounds of the records) and so is every decoded state
+ * (board, agents and queues), decoding stops at the first invalid
+ * or truncated chunk.
+ *
+ * @brief Streaming decoder for trajectories created by the
+ * TrajectoryEncoder. Decodes one chunk at a time.
+ */
+class TrajectoryDecoder
+{
+
+private:
+
+    const uint8_t* data;
+    size_t size;
+    size_t offset = 0;
+
+    std::vector<uint8_t> tokens;
+    size_t tokenPos = 0;
+    int chunkSteps = 0;
+    int chunkStep = 0;
+
+    uint32_t current[STATE_WORDS];
+
+    bool NextChunk();
+
+    /**
+     * @brief Reject Stops decoding (invalid or truncated data)
+     * @return False
+     */
+    bool Reject();
+
+public:
+
+    /**
+     * @param data The encoded trajectory (has to outlive the decoder)
+     * @param size Size of the encoded trajectory in bytes
+     */
+    TrajectoryDecoder(const uint8_t* data, size_t size);
+
+    /**
+     * @brief Next Decodes the next state of the trajectory
+     * @return False if the end of the trajectory was reached or
+     * the data is invalid (state is then unspecified)
+     */
+    bool Next(State& state);
+};
+
+}
+
+#endif // TRAJECTORY_H
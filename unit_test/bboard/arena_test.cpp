@@ -0,0 +1,215 @@
+#include <memory>
+#include <random>
+#include <vector>
+#include <cstdint>
+
+#include "catch.hpp"
+#include "bboard.hpp"
+#include "arena.hpp"
+#include "batch.hpp"
+#include "hash.hpp"
+#include "jobs.hpp"
+
+using namespace bboard;
+
+TEST_CASE("Page Allocation", "[arena]")
+{
+    REQUIRE(NodeCount() >= 1);
+    REQUIRE(CurrentNode() >= 0);
+    REQUIRE(CurrentNode() < MAX_NUMA_NODES);
+
+    const MemoryStats before = GetMemoryStats();
+
+    const HugePages modes[] = {HugePages::NONE, HugePages::TRANSPARENT, HugePages::EXPLICIT};
+    for(HugePages mode : modes)
+    {
+        for(size_t bytes : {size_t(1), size_t(5000), HUGE_PAGE_SIZE + 100})
+        {
+            uint8_t* p = static_cast<uint8_t*>(AllocatePages(bytes, mode, true));
+            REQUIRE(p != nullptr);
+            REQUIRE(reinterpret_cast<uintptr_t>(p) % 64 == 0);
+            p[0] = 1;
+            p[bytes - 1] = 2;
+
+            const MemoryStats during = GetMemoryStats();
+            REQUIRE(during.allocations == before.allocations + 1);
+            size_t total = 0;
+            for(int i = 0; i < MAX_NUMA_NODES; i++)
+            {
+                total += during.bytes[i] - before.bytes[i];
+            }
+            REQUIRE(total == bytes);
+
+            FreePages(p);
+        }
+    }
+
+    const MemoryStats after = GetMemoryStats();
+    REQUIRE(after.allocations == before.allocations);
+    REQUIRE(after.hugeBytes == before.hugeBytes);
+    FreePages(nullptr);
+}
+
+TEST_CASE("Memory Arena", "[arena]")
+{
+    MemoryArena arena(4096, HugePages::NONE);
+    REQUIRE(arena.Used() == 0);
+    REQUIRE(arena.Reserved() == 0);
+
+    uint8_t* a = static_cast<uint8_t*>(arena.Allocate(10, 1));
+    uint8_t* b = static_cast<uint8_t*>(arena.Allocate(8, 8));
+    REQUIRE(b - a == 16);
+    REQUIRE(arena.Used() == 24);
+
+    // larger than a chunk
+    int* big = arena.Create<int>(5000);
+    REQUIRE(big[4999] == 0);
+    REQUIRE(reinterpret_cast<uintptr_t>(big) % alignof(int) == 0);
+    REQUIRE(arena.Reserved() >= 5000 * sizeof(int));
+    REQUIRE(arena.Used() > 5000 * sizeof(int));
+
+    const size_t reserved = arena.Reserved();
+    arena.Reset();
+    REQUIRE(arena.Used() == 0);
+    REQUIRE(arena.Allocate(10, 1) == a);
+    REQUIRE(arena.Reserved() == reserved);
+
+    // every worker gets its own arena
+    std::vector<MemoryArena*> arenas(size_t(Jobs().WorkerCount() + 1), nullptr);
+    Jobs().ParallelFor(1000, [&arenas](int)
+    {
+        MemoryArena& local = LocalArena();
+        local.Allocate(64, 64);
+        const int w = Jobs().CurrentWorker();
+        arenas[size_t(w == -1 ? Jobs().WorkerCount() : w)] = &local;
+    });
+    for(size_t i = 0; i < arenas.size(); i++)
+    {
+        for(size_t j = i + 1; j < arenas.size(); j++)
+        {
+            REQUIRE((arenas[i] == nullptr || arenas[i] != arenas[j]));
+        }
+    }
+}
+
+TEST_CASE("Page Allocator", "[arena]")
+{
+    const size_t allocations = GetMemoryStats().allocations;
+    {
+        std::vector<int, PageAllocator<int>> v;
+        for(int i = 0; i < 1000000; i++)
+        {
+            v.push_back(i);
+        }
+        REQUIRE(v[123456] == 123456);
+        REQUIRE(GetMemoryStats().allocations == allocations + 1);
+    }
+    REQUIRE(GetMemoryStats().allocations == allocations);
+}
+
+TEST_CASE("Batch Environment", "[arena]")
+{
+    BatchSettings settings;
+    settings.size = 50;
+    settings.shardSize = 8;
+    settings.seed = 7;
+    settings.maxSteps = 30;
+
+    BatchEnvironment batch(settings);
+    REQUIRE(batch.Size() == 50);
+
+    // same as a single state with the same moves
+    std::unique_ptr<State> copy = std::make_unique<State>();
+    *copy = batch[13];
+    REQUIRE(batch[13].timeStep == 0);
+    REQUIRE(HashState(batch[13]) != HashState(batch[14]));
+
+    std::vector<Move> moves(size_t(batch.Size() * AGENT_COUNT));
+    std::mt19937 rng(1);
+    int finished = 0;
+    bool tracking = true;
+    for(int t = 0; t < 40; t++)
+    {
+        for(Move& m : moves)
+        {
+            m = Move(rng() % 6);
+        }
+        for(int a = 0; a < AGENT_COUNT; a++)
+        {
+            if(batch[13].agents[a].dead) moves[size_t(13 * AGENT_COUNT + a)] = Move::IDLE;
+        }
+        batch.Step(moves.data());
+
+        tracking = tracking && !batch.Done(13);
+        if(tracking)
+        {
+            Step(copy.get(), &moves[13 * AGENT_COUNT]);
+            copy->timeStep++;
+            REQUIRE(HashState(*copy) == HashState(batch[13]));
+        }
+        for(int i = 0; i < batch.Size(); i++)
+        {
+            finished += batch.Done(i);
+            REQUIRE(batch[i].timeStep < settings.maxSteps);
+        }
+    }
+    // every game hits the step limit at least once
+    REQUIRE(finished >= batch.Size());
+
+    batch.ResetAll();
+    for(int i = 0; i < batch.Size(); i++)
+    {
+        REQUIRE(batch[i].timeStep == 0);
+        REQUIRE(!batch.Done(i));
+    }
+
+    BatchSettings fixed = settings;
+    fixed.autoReset = false;
+    BatchEnvironment manual(fixed);
+    std::fill(moves.begin(), moves.end(), Move::IDLE);
+    for(int t = 0; t < settings.maxSteps; t++)
+    {
+        manual.Step(moves.data());
+    }
+    REQUIRE(manual.Done(0));
+    REQUIRE(manual[0].timeStep == settings.maxSteps);
+    manual.Reset(0);
+    REQUIRE(manual[0].timeStep == 0);
+}
+
+TEST_CASE("Batch Board Generation", "[arena]")
+{
+    BatchSettings settings;
+    settings.size = 20;
+    settings.shardSize = 8;
+    settings.maxSteps = 5;
+    settings.generateBoards = true;
+    settings.board.inset = 1;
+    settings.board.clearance = 1;
+
+    BatchEnvironment batch(settings);
+    for(int i = 0; i < batch.Size(); i++)
+    {
+        REQUIRE(batch[i].agents[0].x == 1);
+        REQUIRE(batch[i].agents[0].y == 1);
+        REQUIRE(batch[i].board[1][0] == Item::PASSAGE);
+    }
+
+    // the curriculum changes, games pick it up on their next reset
+    BoardParams harder = settings.board;
+    harder.inset = 3;
+    batch.SetBoardParams(harder);
+
+    std::vector<Move> moves(size_t(batch.Size() * AGENT_COUNT), Move::IDLE);
+    for(int t = 0; t < settings.maxSteps; t++)
+    {
+        batch.Step(moves.data());
+    }
+    for(int i = 0; i < batch.Size(); i++)
+    {
+        REQUIRE(batch.Done(i));
+        REQUIRE(batch[i].timeStep == 0);
+        REQUIRE(batch[i].agents[2].x == BOARD_SIZE - 4);
+        REQUIRE(batch[i].agents[2].y == BOARD_SIZE - 4);
+    }
+}
@@ -0,0 +1,121 @@
+#include <random>
+
+#include "catch.hpp"
+#include "bboard.hpp"
+#include "belief.hpp"
+
+using namespace bboard;
+
+TEST_CASE("Fog State", "[belief]")
+{
+    std::unique_ptr<State> s = std::make_unique<State>();
+    std::unique_ptr<State> obs = std::make_unique<State>();
+    s->PutAgentsInCorners(0, 1, 2, 3);
+    s->PutItem(1, 1, Item::WOOD);
+    s->PutItem(9, 9, Item::WOOD);
+    s->PlantBomb(2, 2, 0, true);
+    s->PlantBomb(10, 9, 2, true);
+
+    FogState(*s, *obs, 0);
+
+    REQUIRE(obs->board[1][1] == Item::WOOD);
+    REQUIRE(obs->board[9][9] == Item::FOG);
+    REQUIRE(obs->board[4][4] == Item::PASSAGE);
+    REQUIRE(obs->board[5][4] == Item::FOG);
+
+    REQUIRE(obs->agents[0].x == 0);
+    REQUIRE(obs->agents[2].x == -1);
+    REQUIRE(obs->bombs.count == 1);
+    REQUIRE(BMB_ID(obs->bombs[0]) == 0);
+}
+
+TEST_CASE("Belief Tracking", "[belief]")
+{
+    std::unique_ptr<State> s = std::make_unique<State>();
+    std::unique_ptr<State> obs = std::make_unique<State>();
+    std::unique_ptr<BeliefState> b = std::make_unique<BeliefState>();
+
+    Move id = Move::IDLE;
+    Move m[4] = {id, id, id, id};
+
+    s->Kill(2, 3);
+    s->PutAgent(5, 0, 0);
+    s->PutAgent(7, 4, 1);
+    b->Reset(0);
+
+    SECTION("Remember Out Of View")
+    {
+        s->board[3][1] = Item::WOOD + 2;
+        FogState(*s, *obs, 0);
+        b->Update(*obs);
+
+        REQUIRE(b->state.board[3][1] == Item::WOOD + 2);
+        REQUIRE(b->state.board[10][10] == Item::FOG);
+
+        // walk away from the wood
+        m[0] = Move::RIGHT;
+        for(int i = 0; i < 4; i++)
+        {
+            Step(s.get(), m);
+            s->timeStep++;
+            FogState(*s, *obs, 0);
+            b->Update(*obs);
+        }
+        REQUIRE(obs->board[3][1] == Item::FOG);
+        REQUIRE(b->state.board[3][1] == Item::WOOD + 2);
+        REQUIRE(b->lastSeen[1] == 4);
+        REQUIRE(HasCell(b->seen, 1, 3));
+        REQUIRE(!HasCell(b->visible, 1, 3));
+    }
+    SECTION("Remembered Bombs Keep Ticking")
+    {
+        s->board[1][1] = Item::WOOD + 1;
+        s->PlantBomb(2, 1, 0, true);
+        FogState(*s, *obs, 0);
+        b->Update(*obs);
+
+        // run away, the bomb explodes out of view
+        m[0] = Move::RIGHT;
+        for(int i = 0; i < BOMB_LIFETIME; i++)
+        {
+            Step(s.get(), m);
+            s->timeStep++;
+            FogState(*s, *obs, 0);
+            b->Update(*obs);
+        }
+        REQUIRE(obs->board[1][2] == Item::FOG);
+        REQUIRE(b->state.bombs.count == 0);
+        REQUIRE(IS_FLAME(b->state.board[1][1]));
+        REQUIRE(IS_FLAME(b->state.board[1][2]));
+
+        for(int i = 0; i < FLAME_LIFETIME; i++)
+        {
+            Step(s.get(), m);
+            s->timeStep++;
+            FogState(*s, *obs, 0);
+            b->Update(*obs);
+        }
+        // the powerup of the wood is known
+        REQUIRE(b->state.board[1][1] == Item::EXTRABOMB);
+    }
+    SECTION("Determinized Sample")
+    {
+        FogState(*s, *obs, 0);
+        b->Update(*obs);
+
+        std::mt19937_64 rng(0x1337);
+        std::unique_ptr<State> sample = std::make_unique<State>();
+        b->Sample(*sample, rng);
+
+        for(int y = 0; y < BOARD_SIZE; y++)
+        {
+            for(int x = 0; x < BOARD_SIZE; x++)
+            {
+                REQUIRE(sample->board[y][x] != Item::FOG);
+            }
+        }
+        REQUIRE(sample->agents[0].x == 5);
+        REQUIRE(sample->board[4][7] == Item::AGENT1);
+        REQUIRE(sample->aliveAgents == 2);
+    }
+}
@@ -1,5 +1,9 @@
+#include <memory>
+
 #include "catch.hpp"
 #include "bboard.hpp"
+#include "bitboard.hpp"
+#include "generator.hpp"
 
 
 
@@ -7,3 +11,186 @@ TEST_CASE( "Board initialization", "[board creation]" )
 {
 
 }
+
+/**
+ * @brief Rigid Returns the rigid cells of the board
+ */
+bboard::BitBoard Rigid(const bboard::State& s)
+{
+    bboard::BitBoard rigid = 0;
+    for(int c = 0; c < bboard::CELL_COUNT; c++)
+    {
+        if(s[bboard::Cell(c)] == bboard::Item::RIGID)
+        {
+            rigid |= bboard::BitBoard(1) << c;
+        }
+    }
+    return rigid;
+}
+
+TEST_CASE("Bitboard Flood Fill", "[board creation]")
+{
+    using namespace bboard;
+
+    // a wall in column 5 with a gap in the last row
+    BitBoard wall = 0;
+    for(int y = 0; y < BOARD_SIZE - 1; y++)
+    {
+        wall |= CellBit(5, y);
+    }
+    const BitBoard open = BoardMask() & ~wall;
+    REQUIRE(HasCell(FloodFill(CellBit(0, 0), open), 10, 0));
+    REQUIRE(PopCount(FloodFill(CellBit(0, 0), open)) == CELL_COUNT - (BOARD_SIZE - 1));
+
+    // no wrap-around between rows
+    REQUIRE(Dilate(CellBit(10, 0)) == (CellBit(10, 0) | CellBit(9, 0) | CellBit(10, 1)));
+    REQUIRE(Dilate(CellBit(0, 1)) == (CellBit(0, 1) | CellBit(1, 1) | CellBit(0, 0) | CellBit(0, 2)));
+
+    const BitBoard closed = open & ~CellBit(5, BOARD_SIZE - 1);
+    REQUIRE(!HasCell(FloodFill(CellBit(0, 0), closed), 10, 0));
+}
+
+TEST_CASE("Board Generator", "[board creation]")
+{
+    using namespace bboard;
+    std::unique_ptr<State> s = std::make_unique<State>();
+    std::unique_ptr<State> t = std::make_unique<State>();
+
+    BoardParams params;
+
+    SECTION("Deterministic")
+    {
+        GenerateBoard(*s, params, 17);
+        GenerateBoard(*t, params, 17);
+        bool same = true;
+        for(int c = 0; c < CELL_COUNT; c++)
+        {
+            same = same && (*s)[Cell(c)] == (*t)[Cell(c)];
+        }
+        REQUIRE(same);
+
+        GenerateBoard(*t, params, 18);
+        bool different = false;
+        for(int c = 0; c < CELL_COUNT; c++)
+        {
+            different = different || (*s)[Cell(c)] != (*t)[Cell(c)];
+        }
+        REQUIRE(different);
+    }
+    SECTION("Densities")
+    {
+        params.rigid = 0.3f;
+        params.wood = 0.4f;
+        params.powerups = 1.0f;
+        params.connected = false;
+
+        int rigid = 0, wood = 0, cells = 0;
+        for(int seed = 0; seed < 200; seed++)
+        {
+            GenerateBoard(*s, params, uint64_t(seed));
+            for(int c = 0; c < CELL_COUNT; c++)
+            {
+                const int item = (*s)[Cell(c)];
+                rigid += item == Item::RIGID;
+                wood += IS_WOOD(item);
+                if(IS_WOOD(item))
+                {
+                    REQUIRE(WOOD_POWFLAG(item) != 0);
+                }
+                cells += item < Item::AGENT0;
+            }
+        }
+        REQUIRE(float(rigid) / cells == Approx(0.3f).margin(0.02f));
+        REQUIRE(float(wood) / cells == Approx(0.4f).margin(0.02f));
+
+        params.rigid = 0;
+        params.wood = 0;
+        GenerateBoard(*s, params, 3);
+        for(int c = 0; c < CELL_COUNT; c++)
+        {
+            REQUIRE(((*s)[Cell(c)] == Item::PASSAGE || (*s)[Cell(c)] >= Item::AGENT0));
+        }
+    }
+    SECTION("Starts")
+    {
+        params.inset = 1;
+        params.clearance = 2;
+        params.rigid = 0.5f;
+        params.wood = 0.5f;
+        // only the preset counts, the fields are informational
+        Rules rules = GetRules(RulePreset::FAST_BOMBS);
+        rules.bombStrength = 7;
+        GenerateBoard(*s, params, 5, rules);
+
+        REQUIRE(StartCell(params, 0) == ToCell(1, 1));
+        REQUIRE(StartCell(params, 2) == ToCell(9, 9));
+        for(int i = 0; i < AGENT_COUNT; i++)
+        {
+            const Cell c = StartCell(params, i);
+            REQUIRE(ToCell(s->agents[i].x, s->agents[i].y) == c);
+            REQUIRE((*s)[c] == Item::AGENT0 + i);
+            REQUIRE(s->agents[i].bombStrength == FastBombRules::BOMB_STRENGTH);
+
+            for(int d = 0; d < CELL_COUNT; d++)
+            {
+                const int distance = std::abs(CellX(c) - CellX(Cell(d))) + std::abs(CellY(c) - CellY(Cell(d)));
+                if(distance > 0 && distance <= params.clearance)
+                {
+                    REQUIRE((*s)[Cell(d)] == Item::PASSAGE);
+                }
+            }
+        }
+    }
+    SECTION("Connected Starts")
+    {
+        params.rigid = 0.7f;
+        params.wood = 0.1f;
+        for(int seed = 0; seed < 100; seed++)
+        {
+            params.symmetry = Symmetry(seed % 5);
+            GenerateBoard(*s, params, uint64_t(seed));
+            const BitBoard reached = FloodFill(CellBit(0, 0), BoardMask() & ~Rigid(*s));
+            for(int i = 0; i < AGENT_COUNT; i++)
+            {
+                REQUIRE(HasCell(reached, s->agents[i].x, s->agents[i].y));
+            }
+        }
+    }
+    SECTION("Symmetry")
+    {
+        const int n = BOARD_SIZE - 1;
+        params.rigid = 0.3f;
+        params.wood = 0.4f;
+        for(int seed = 0; seed < 20; seed++)
+        {
+            for(Symmetry sym : {Symmetry::MIRROR, Symmetry::POINT, Symmetry::ROTATION, Symmetry::FULL})
+            {
+                params.symmetry = sym;
+                GenerateBoard(*s, params, uint64_t(seed));
+                for(int y = 0; y < BOARD_SIZE; y++)
+                {
+                    for(int x = 0; x < BOARD_SIZE; x++)
+                    {
+                        const int item = s->board[y][x];
+                        if(item >= Item::AGENT0)
+                        {
+                            continue;
+                        }
+                        if(sym == Symmetry::MIRROR || sym == Symmetry::FULL)
+                        {
+                            REQUIRE(s->board[y][n - x] == item);
+                        }
+                        if(sym == Symmetry::POINT || sym == Symmetry::ROTATION)
+                        {
+                            REQUIRE(s->board[n - y][n - x] == item);
+                        }
+                        if(sym == Symmetry::ROTATION || sym == Symmetry::FULL)
+                        {
+                            REQUIRE(s->board[x][n - y] == item);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
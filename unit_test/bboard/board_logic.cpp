@@ -2,6 +2,7 @@
 
 #include "catch.hpp"
 #include "bboard.hpp"
+#include "agents.hpp"
 
 /**
  * @brief REQUIRE_AGENT Proxy REQUIRE-Assertion to test
@@ -424,6 +425,30 @@ TEST_CASE("Flame Mechanics", "[step function]")
         REQUIRE(IS_FLAME(s->board[6][5]));
         REQUIRE(!IS_FLAME(s->board[5][5]));
     }
+    SECTION("Flames Stop At The Border")
+    {
+        s->SpawnFlame(1, 10, 10);
+        for(int i = -1; i <= bboard::BOARD_SIZE; i++)
+        {
+            REQUIRE(s->board[-1][i] == bboard::Item::RIGID);
+            REQUIRE(s->board[bboard::BOARD_SIZE][i] == bboard::Item::RIGID);
+            REQUIRE(s->board[i][-1] == bboard::Item::RIGID);
+            REQUIRE(s->board[i][bboard::BOARD_SIZE] == bboard::Item::RIGID);
+        }
+        REQUIRE(IS_FLAME(s->board[10][0]));
+        REQUIRE(IS_FLAME(s->board[10][10]));
+        REQUIRE(IS_FLAME(s->board[0][1]));
+        REQUIRE(s->agents[2].dead);
+        REQUIRE(s->agents[3].dead);
+
+        SeveralSteps(bboard::FLAME_LIFETIME, s.get(), m);
+        for(int i = 0; i < bboard::BOARD_SIZE; i++)
+        {
+            REQUIRE(!IS_FLAME(s->board[10][i]));
+            REQUIRE(!IS_FLAME(s->board[i][1]));
+        }
+        REQUIRE(s->board[-1][1] == bboard::Item::RIGID);
+    }
 }
 
 TEST_CASE("Chained Explosions", "[step function]")
@@ -470,3 +495,199 @@ TEST_CASE("Chained Explosions", "[step function]")
 
 
 }
+
+TEST_CASE("Alive Mask", "[step function]")
+{
+    std::unique_ptr<bboard::State> s = std::make_unique<bboard::State>();
+    REQUIRE(s->aliveMask == bboard::ALL_ALIVE);
+
+    s->PutAgent(0, 0, 0);
+    s->PutAgent(2, 0, 2);
+    s->Kill(1, 3);
+    s->Kill(3);
+    REQUIRE(s->aliveMask == 0b0101);
+    REQUIRE(s->aliveAgents == 2);
+
+    // moves of dead agents are never looked at
+    bboard::Move m[4] = {bboard::Move::RIGHT, bboard::Move(77),
+                         bboard::Move::LEFT, bboard::Move(-3)};
+    bboard::Step(s.get(), m);
+    REQUIRE_AGENT(s.get(), 0, 0, 0);
+    REQUIRE_AGENT(s.get(), 2, 2, 0);
+
+    m[2] = bboard::Move::DOWN;
+    bboard::Step(s.get(), m);
+    REQUIRE_AGENT(s.get(), 0, 1, 0);
+    REQUIRE_AGENT(s.get(), 2, 2, 1);
+
+    // a single agent
+    s->Kill(2);
+    REQUIRE(s->aliveMask == 0b0001);
+    m[0] = bboard::Move::DOWN;
+    bboard::Step(s.get(), m);
+    REQUIRE_AGENT(s.get(), 0, 1, 1);
+
+    s->agents[0].dead = true;
+    s->agents[3].dead = false;
+    s->UpdateAlive();
+    REQUIRE(s->aliveMask == 0b1000);
+    REQUIRE(s->aliveAgents == 1);
+}
+
+TEST_CASE("Rule Presets", "[step function]")
+{
+    const bboard::Rules standard;
+    REQUIRE(bboard::GetRules(bboard::RulePreset::STANDARD).bombLifetime == standard.bombLifetime);
+    REQUIRE(bboard::GetRules(bboard::RulePreset::STANDARD).flameLifetime == bboard::FLAME_LIFETIME);
+
+    const bboard::Rules fast = bboard::GetRules(bboard::RulePreset::FAST_BOMBS);
+    REQUIRE(fast.preset == bboard::RulePreset::FAST_BOMBS);
+    REQUIRE(fast.bombLifetime == bboard::FastBombRules::BOMB_LIFETIME);
+
+    std::unique_ptr<bboard::State> s = std::make_unique<bboard::State>();
+    bboard::InitState(s.get(), 0, 1, 2, 3, 7, fast);
+    REQUIRE(s->agents[2].bombStrength == fast.bombStrength);
+
+    // edited fields do not disagree with the RuleSet
+    bboard::Rules edited = fast;
+    edited.bombStrength = 7;
+    bboard::InitState(s.get(), 0, 1, 2, 3, 7, edited);
+    REQUIRE(s->agents[2].bombStrength == bboard::FastBombRules::BOMB_STRENGTH);
+
+    bboard::Move id = bboard::Move::IDLE;
+    bboard::Move m[4] = {id, id, id, id};
+
+    SECTION("Bomb And Flame Lifetime")
+    {
+        *s = bboard::State();
+        s->PutAgentsInCorners(0, 1, 2, 3);
+        m[0] = bboard::Move::BOMB;
+        bboard::Step(s.get(), m, fast);
+        m[0] = id;
+        REQUIRE(BMB_TIME(s->bombs[0]) == fast.bombLifetime);
+
+        for(int i = 0; i < fast.bombLifetime - 1; i++)
+        {
+            bboard::Step(s.get(), m, fast);
+        }
+        REQUIRE(s->bombs.count == 1);
+        bboard::Step(s.get(), m, fast);
+        REQUIRE(s->bombs.count == 0);
+        REQUIRE(s->flames.count == 1);
+        REQUIRE(s->agents[0].dead);
+
+        for(int i = 0; i < fast.flameLifetime; i++)
+        {
+            REQUIRE(IS_FLAME(s->board[0][1]));
+            bboard::Step(s.get(), m, fast);
+        }
+        REQUIRE(s->flames.count == 0);
+        REQUIRE(!IS_FLAME(s->board[0][1]));
+    }
+    SECTION("Bomb Limit")
+    {
+        s->agents[0].maxBombCount = 10;
+        for(int i = 0; i < 10; i++)
+        {
+            s->PlantBomb<bboard::FastBombRules>(i, 5, 0);
+        }
+        REQUIRE(s->agents[0].bombCount == fast.maxBombs);
+        REQUIRE(s->bombs.count == fast.maxBombs);
+    }
+    SECTION("Environment")
+    {
+        agents::HarmlessAgent a[4];
+        bboard::Environment env;
+        env.SetRules(fast);
+        env.MakeGame({&a[0], &a[1], &a[2], &a[3]});
+        REQUIRE(env.GetRules().preset == bboard::RulePreset::FAST_BOMBS);
+        REQUIRE(env.GetState().agents[0].bombStrength == fast.bombStrength);
+        env.Step();
+        REQUIRE(env.GetState().aliveAgents == bboard::AGENT_COUNT);
+    }
+}
+
+/**
+ * @brief Counts the deltas it receives
+ */
+struct DeltaCountingAgent : agents::RandomAgent
+{
+    int deltas = 0;
+
+    void observe(const bboard::StepDelta&) override
+    {
+        deltas++;
+    }
+};
+
+TEST_CASE("Step Delta", "[step function]")
+{
+    DeltaCountingAgent a[4];
+    bboard::Environment env;
+    env.SetDeltas(true);
+    REQUIRE(env.GetDelta() != nullptr);
+
+    std::unique_ptr<bboard::State> before = std::make_unique<bboard::State>();
+    int steps = 0, changes = 0, exploded = 0, extinguished = 0;
+    for(int game = 0; game < 20; game++)
+    {
+        env.MakeGame({&a[0], &a[1], &a[2], &a[3]}, game);
+        while(!env.IsDone() && env.GetState().timeStep < 300)
+        {
+            *before = env.GetState();
+            env.Step();
+            steps++;
+
+            const bboard::State& after = env.GetState();
+            const bboard::StepDelta& d = *env.GetDelta();
+            changes += d.changeCount;
+            exploded += d.explodedCount;
+            extinguished += d.extinguishedCount;
+
+            // only cells that changed, the delta turns the previous
+            // board into the current one
+            for(int i = 0; i < d.changeCount; i++)
+            {
+                REQUIRE((*before)[d.changes[i].cell] != d.changes[i].item);
+            }
+            bboard::ApplyDelta(*before, d);
+            for(int y = 0; y < bboard::BOARD_SIZE; y++)
+            {
+                for(int x = 0; x < bboard::BOARD_SIZE; x++)
+                {
+                    REQUIRE(before->board[y][x] == after.board[y][x]);
+                }
+            }
+            for(int i = 0; i < bboard::AGENT_COUNT; i++)
+            {
+                REQUIRE(before->agents[i].dead == after.agents[i].dead);
+                if(!after.agents[i].dead)
+                {
+                    REQUIRE(before->agents[i].x == after.agents[i].x);
+                    REQUIRE(before->agents[i].y == after.agents[i].y);
+                }
+            }
+            REQUIRE(before->aliveMask == after.aliveMask);
+
+            // bombs and flames: survivors plus the new ones
+            REQUIRE(before->bombs.count - d.explodedCount + d.plantedCount == after.bombs.count);
+            for(int i = 0; i < d.plantedCount; i++)
+            {
+                REQUIRE(d.planted[i] == after.bombs[after.bombs.count - d.plantedCount + i]);
+            }
+            REQUIRE(before->flames.count - d.extinguishedCount + d.spawnedCount == after.flames.count);
+            for(int i = 0; i < d.spawnedCount; i++)
+            {
+                REQUIRE(d.spawned[i].cell == after.flames[after.flames.count - d.spawnedCount + i].cell);
+            }
+        }
+    }
+
+    REQUIRE(a[0].deltas == steps);
+    REQUIRE(changes > 0);
+    REQUIRE(exploded > 0);
+    REQUIRE(extinguished > 0);
+
+    env.SetDeltas(false);
+    REQUIRE(env.GetDelta() == nullptr);
+}
@@ -0,0 +1,110 @@
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "catch.hpp"
+#include "bboard.hpp"
+#include "jobs.hpp"
+#include "dataset.hpp"
+#include "serialization.hpp"
+
+using namespace bboard;
+
+/**
+ * @brief TestRecord Returns the payload of record i of thread t
+ */
+std::string TestRecord(int t, int i)
+{
+    // varying sizes, some larger than a block
+    const size_t size = i % 97 == 0 ? 9000 : size_t(1 + (i * 7 + t) % 300);
+    std::string s(size, char('a' + (t + i) % 26));
+    std::memcpy(&s[0], &i, std::min(size, sizeof(i)));
+    s[size - 1] = char(t);
+    return s;
+}
+
+TEST_CASE("Dataset Writer", "[dataset]")
+{
+    const int threads = 4, records = 3000;
+
+    DatasetSettings settings;
+    settings.prefix = "dataset_test";
+    settings.blockSize = 8192;
+    settings.writeSize = 4 * 8192;
+    settings.shardSize = 64 * 1024;
+    settings.maxMemory = 6 * 8192;
+
+    SECTION("Buffered") {}
+    SECTION("Direct")
+    {
+        settings.direct = true;
+        settings.sync = SyncPolicy::WRITE;
+    }
+
+    std::unique_ptr<State> s = std::make_unique<State>();
+    InitState(s.get(), 0, 1, 2, 3, 5);
+    const std::vector<uint8_t> serialized = Serialize(*s);
+
+    std::vector<std::string> shards;
+    {
+        DatasetWriter writer(settings);
+        Jobs().ParallelFor(threads, threads, [&writer](int t)
+        {
+            for(int i = 0; i < records; i++)
+            {
+                const std::string r = TestRecord(t, i);
+                writer.Append(r.data(), r.size());
+            }
+        });
+        writer.Append("", 0);
+
+        REQUIRE(writer.Flush());
+        const DatasetStats stats = writer.Stats();
+        REQUIRE(stats.records == size_t(threads * records));
+        REQUIRE(stats.writtenBytes % DATASET_ALIGNMENT == 0);
+        REQUIRE(stats.writtenBytes > stats.recordBytes);
+        REQUIRE(stats.shards > 1);
+
+        // appending after a flush continues the current shard
+        writer.Append(*s);
+
+        REQUIRE(writer.Close());
+        REQUIRE(writer.Close());
+        shards = writer.Shards();
+        REQUIRE(shards.size() == writer.Stats().shards);
+    }
+
+    // every record arrives exactly once, in order per thread
+    std::vector<int> next(threads, 0);
+    int states = 0;
+    for(const std::string& path : shards)
+    {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        REQUIRE(size_t(in.tellg()) <= settings.shardSize);
+        REQUIRE(size_t(in.tellg()) % DATASET_ALIGNMENT == 0);
+
+        REQUIRE(ReadRecords(path, [&](const uint8_t* data, size_t size)
+        {
+            if(std::vector<uint8_t>(data, data + size) == serialized)
+            {
+                states++;
+                return;
+            }
+            const int t = data[size - 1];
+            REQUIRE(t < threads);
+            REQUIRE(std::string(reinterpret_cast<const char*>(data), size) == TestRecord(t, next[t]));
+            next[t]++;
+        }));
+        std::remove(path.c_str());
+    }
+    REQUIRE(states == 1);
+    for(int t = 0; t < threads; t++)
+    {
+        REQUIRE(next[t] == records);
+    }
+
+    REQUIRE(!ReadRecords("missing_dataset.bin", [](const uint8_t*, size_t) {}));
+}
@@ -0,0 +1,131 @@
+#include <cstring>
+#include <sstream>
+#include <iostream>
+
+#include "catch.hpp"
+#include "bboard.hpp"
+#include "agents.hpp"
+#include "reference.hpp"
+#include "differential.hpp"
+
+using namespace bboard;
+
+/**
+ * @brief BuggyStep A broken step: planting a bomb also
+ * increases the bomb strength
+ */
+void BuggyStep(State* state, Move* moves)
+{
+    bool planted[AGENT_COUNT];
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        planted[i] = moves[i] == Move::BOMB && !state->agents[i].dead;
+    }
+    Step(state, moves);
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        if(planted[i]) state->agents[i].bombStrength++;
+    }
+}
+
+TEST_CASE("Reference Conversion", "[differential]")
+{
+    std::mt19937_64 rng(7);
+    std::unique_ptr<State> s = std::make_unique<State>();
+    std::unique_ptr<State> t = std::make_unique<State>();
+    reference::State ref;
+
+    for(int i = 0; i < 100; i++)
+    {
+        RandomDiffState(*s, rng);
+        REQUIRE(s->aliveAgents > 0);
+
+        reference::FromState(*s, ref);
+        REQUIRE(reference::Compare(*s, ref));
+        reference::ToState(ref, *t);
+        REQUIRE(std::memcmp(s.get(), t.get(), sizeof(State)) == 0);
+    }
+
+    ref.agents[2].bombStrength++;
+    std::string diff;
+    REQUIRE(!reference::Compare(*s, ref, &diff));
+    REQUIRE(diff.find("agent 2 bombStrength") != std::string::npos);
+}
+
+TEST_CASE("Step Matches Reference", "[differential]")
+{
+    DiffSettings settings;
+    settings.games = 2000;
+    settings.steps = 100;
+
+    DiffResult r = RunDifferential(settings);
+    if(r.mismatch)
+    {
+        PrintReproduction(r, std::cout);
+    }
+    REQUIRE(!r.mismatch);
+    REQUIRE(r.steps > 20000);
+}
+
+TEST_CASE("Replayed Games Match Reference", "[differential]")
+{
+    agents::SimpleAgent a[AGENT_COUNT] = {{1}, {2}, {3}, {4}};
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        a[i].id = i;
+    }
+
+    for(int game = 0; game < 10; game++)
+    {
+        DiffCase c;
+        c.initial = State();
+        InitState(&c.initial, 0, 1, 2, 3, game);
+
+        std::unique_ptr<State> s = std::make_unique<State>(c.initial);
+        for(int t = 0; t < 300 && s->aliveAgents > 1; t++)
+        {
+            MoveSet m;
+            for(int i = 0; i < AGENT_COUNT; i++)
+            {
+                m[i] = s->agents[i].dead ? Move::IDLE : a[i].act(s.get());
+            }
+            c.moves.push_back(m);
+            Step(s.get(), m.data());
+            s->timeStep++;
+        }
+
+        DiffResult r = CheckCase(c, &Step);
+        if(r.mismatch)
+        {
+            PrintReproduction(r, std::cout);
+        }
+        REQUIRE(!r.mismatch);
+    }
+}
+
+TEST_CASE("Minimized Reproduction", "[differential]")
+{
+    DiffSettings settings;
+    settings.step = &BuggyStep;
+    settings.games = 100;
+
+    DiffResult r = RunDifferential(settings);
+    REQUIRE(r.mismatch);
+
+    // a single bomb is enough to reproduce the bug
+    REQUIRE(r.reproduction.moves.size() == 1);
+    int active = 0;
+    for(Move m : r.reproduction.moves[0])
+    {
+        active += m != Move::IDLE;
+        REQUIRE((m == Move::IDLE || m == Move::BOMB));
+    }
+    REQUIRE(active == 1);
+    REQUIRE(r.diff.find("bombStrength") != std::string::npos);
+    REQUIRE(CheckLockstep(r.reproduction, &BuggyStep) == 0);
+    REQUIRE(CheckLockstep(r.reproduction, &Step) == -1);
+
+    std::ostringstream out;
+    PrintReproduction(r, out);
+    REQUIRE(out.str().find("Moves:") != std::string::npos);
+}
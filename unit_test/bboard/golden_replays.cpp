@@ -0,0 +1,30 @@
+#include "testing_utilities.hpp"
+
+// Golden replay corpus, generated by the hidden test case
+// "Generate Golden Replays" (replay_test.cpp). Format: see replay.hpp
+const char* const GOLDEN_REPLAYS = R"(
+# ouroboros: agents in a 2x2 block move in a cycle
+# chain:     bombs that detonate other bombs
+# deaths:    several agents die in the same step
+# endgame:   long games with two agents or fewer left
+# game:      regular simple agent games
+ouroboros-bomb 01000044001001450010015500100154001001202002000000000002ee00e00200000000f0000000001100ba001000e0d00c000000010000000000020000e0000000200020020e0000e00000ef100000178100008019810000400000 059gpkg9kp9gpkty7s08070t07070g0l0f0l090x0j090n0r030301020403020204050301010a0y0j0m09090l0n080f0c0e0z07090909090909090900 27088ca2a5555131
+ouroboros-ccw 010000440010014500100155001001540010010001001210000f0f2001000000f00001000000000000e200ba00010000d00c00000100000020f002110001000000001000000000000000100210000e00040200000402000004020000120800000c0000 pk9gkpg9pk9gzz7kp9p9m97rralqsklpg7tw2h213jeffkfj7flakeg7bwjjjnvm7j7ipijipii0o0i0o0i4 6f26f0502866239a
+ouroboros-cw 01000044001001450010015500100154001001000e10000000e02102000f000e00000e0011000000222000ba000ee011d00c0e1010010000100001100020020102e002000000000000e00012000000004a20000070a7030000 9gpkg9kp9gpkg9kpzzg7j7drmqsjfkqpdm7ree5vjb1aaaxc76acaosoki7ioucbcoiobs8k6moqcfu76g6w0b0l020l0s0l0e0j0s0f0g0z090j0l0e0k0a0q0s0l0m0h0g0d0g0r0p090v0a090s0n070f07070g0k0y0l0k0i b4e76385bc91789a
+chain-0 010000000122010a012104aa022003a00032020a00002f121be00f100300e32001002031210f00112010000001200010e00000010000000000100020200000e301e001000200000f00200d00000f1f00040200001308000048200000501308000010080000100800000005174101802303301004201009a0230900 04030402050d090c060c0i0u0i0c0u0i0i0i0a0a0m0t0x0f0f a5b5fa5836166c99
+chain-1 010000000033040a003002aa013204a00030013a000f00112b000100e00000f000000f00100300020000010100000022100010200e00220010000000000ee10110100e000000010001200d000030300c040200001208000010080000540105a74204004005014008334009a9420a00 ococ6iiu6coc6iiicuooc6cuoci0i0i0o0i0o0 7243d36cf25dac71
+chain-2 010000000110020a032004aa002203a00032040a0001000e0000200002000022000000010010f01000f0000e11ee000010001102e0000101e00000000000100e021000000000022110000d130101310c1308000010080000bc1d04a24305a04306a93207aa320800 02040301020204 3381834ff9c2860
+chain-3 010000910033038100110251003203a6001004000100102010f00201000012200101e20000000000000101110000000c000000000301e30e00303e200100e0b000002e00000a000100001001100d200004020000d5060672320264320260300791300870300881210900 asu0r0s0a0r0r0j080m0g0q0a0v0a0a0b070j0m0m0m0m0f0a0u0i0 30efb7e7ecf79d0b
+deaths-0 010000680120043a00300146012202780020010002010000000f0000001000e100000001e2202000be02e0000c0e01e10001000000e030001a00012010d000010e0000002e0000010022001000200e00040200009ed7050246220265220700 uzi1c460c0600000000000 5ccbf2f4d91cf0cb
+deaths-1 010000000010010a001001aa001001a00010010a010000100b01e101000e00010100002010000021000010001f100001000e000100120f00100100011202200e0f0000000001002000000d1010000e0c4b200000108100008004020000010000 renwphpjmdks7fwgd9qaplkaplbyr9pafi8l9krqygkqe9gg6lcd6ecw6miai2u5c1i3i1r1i36292t2a2j4zh73a373afax8l9g1i3i561i163i2c5o1o4c1c1i4i4c2o2c1i1c1c363c2o4o162o1o2i4i1c2i2i2o1i16361o263c261c2i2c2626163o1o363o5u2i463i4i46364o2c4c2o1i3o2i162i164o3i2c3c3o36363i2c2c3o4o1c1c5u16361i36161i5c4646361c1c5u26260o0i 6602c7b84b8185f4
+deaths-2 01000012003204140011012403200223013103000012212000a1bee0000f00d000200f0002020310e10030030000f100ee0000001000000000000000020000e01e00010000e2012100020020100200004e200000402000003081000080e50444400135330243400514110a00 i5i1u3i365c0c4c4o0o000 ec989c0848dc6f42
+deaths-3 01000011001101360021024202100232003003000010000e200a00000000010000102ee0d011b0000001000130000100e001100122000000000e12101000200000101001000000f0f0001000e002e200561208000010080000380247210511100900 67696iu0c0o0uucoo600000000ico0o000 e40ad05509986c23
+endgame-0 010000000010010a001001aa001001a00010010a000000010b2ee00010e000102200000100100101e0000f0001000200010020110000000001000e0000020001000100010f000002100e0d000000210cb90402000013080000080000 twin6dogcmoloa0l0m090miy6rctosoe6iu6coiciii6i0o060c0og6z67cri3i3c2o1o4o4o460o0i0i0c0oi6cc66ooccio66iii6i6cco6c6u6666iiiiuc66iiicc6ii6ccuc6oocouc6o6o6cc6occ66iii6ciu66666oooooooocc66ooiuuiciiiciic6ii66oiccicc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc66cc6 5f0884fec343c96d
+endgame-1 010000000021040a001001aa003103a00010010a20e000200b00100f01201f1000e01e000f20110200120202e000e2001110100100000100000e00002101e0e000020200000000e001001d001f10010c120800001008000038810000c0d5130800000002004003aa320400 6wo4u4o463o0c3c362o2i5c161c1u46464i4c5i36263i0c2o163000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000 18f83a077ccb4749
+endgame-2 010000000010010a001001aa001001a00010010a000020000b100000e010010020002000002e000000122000100100000000e00000010000e00000e01210000e00000e1f100200e002010d100000000c9e25810000800000 rmxmrubos0a0g090m0l0a0l0y07372p2r2b4g5p1p3j1f3q1v484a4q4j4p2j5r1n3r3j3v4q292r3g2f3k4p285h171d4d2s1s2y1k281133322432524j1l19391z474j494j3f5k3m392g3p281l4u2c1o3c4c0i0i0d4t5m3g34221122172a4a3a4r2x5r1o3e1k4q4f4j4j4h2j1a5g3r3g2a281p2817183w4k272l1r2l172q1p2q0r0d0z070m0m0s0k0m0k0d0q0f0e0r0f0q0r0z0707070a0k0k0m0j0e0p0d0r0r090z070m0m0l0g0r0m0s0a0s0k0r0k0l0e090e0q0d0d0r0r0z0707070m0s0s0q0p0m0m0r0r0z0k0l0f0k090r0f090e0a0d0g0z07070r0r0q0p0s0f0l0e0j0k00000m0k0m0z09070r0p0q0d0m0e0r070a0m0m0z0f0f0f080s0k0q0m0r0l0g0m0z0d0r0p0d090k0d080g070s0a080a0z070r0r0f0e090p0m0g0l0e0e0k0m080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d080d0 e157501915a99a0c
+endgame-3 010000000020010a002103aa001001a00030011a20e0f0110b22f1f1000022200000000f0000000e00e0e000000100000f00000000022f000200100001100e00f20000021f00100000001d010020020c110800001008000010080000100800006c0402000004020000120800001008000000010a310600 1255303030101010102010205010103030301020403020501010403010402020102010301050203030303010204040305030101040301020201040503010000000000000000000000000204020102030200000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000 ca1642fbc6f2e8a3
+game-0 010000000010010a001001aa001001a00010011ae0e020100b000101001f00102f00000100000000000e00000200000e00001000020f2010011000000000000e000002020000000002000d010000000c45200000402000005004020000010000 72x4r4b1s5j2s3e3q1f2s2p4p3p2i462u5i161i3c1i1i2i1c26464i2c3o3c2i4o1626262u5o1o162u16261o2i162o0u0i0i0c0i0c060c060c060c060c060i0c0u060606060o0o060o000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000 f50818413afe4bd3
+game-1 010000000010010a001001aa001001a00010010a000110000b1ee200000210011002e000001e000001000e1000010001000000101000000e1000001001000020000100102010000002000d10020e1f0cf726810000000000 vkrz4j1g2g3f3m5g1l1a3r2l1y2o393a2r1l2s1e4l1q5j481q4s2y2n3f2l1d472a2l1k273p5g1e1f4g2d1f2g1g3y1b195x19181a491s1f284w481m3p5m10300e0204040303010202040302434523213131213131344134442225313313341333343312511544020204040202020211 13a156878d7bee8c
+game-2 010000000010010a001001aa001001a00010010a0e1000000be02102000f000e00000e00110100002220e001000ee01100020e1010110100100001100020020102e002000000000000e00d120000000c4a200000709f0e0000 tkxw7mpnrd8jp9lgdrlkpd78zvdapts3rqfolqmg8mparszgp095r3f3sffxp9m9pkmjbkfekb9jgplskdmwm97mdmbemdmigck6jasdkx7eqogspc96ni86g080s0l0q0d0k0d0s0l0j0a0q0j0f0r0a0l0s0l0p0f0r0j0l090p0m0s0g0s0k0s0k0l0p080d0p080j090r0f0f0m0k0p080j0g080f0q0r0k0k070p0d0p0m0m080f0p0s0k0k0a0s0f0s0l0s0k0m090p0k0d0q0a0f0a0f0p0l0l090f080p0j0g0r080m0g070f0q090k0p0k0p0m0d0q0a0j0q0m0s0l0f0p090l0e0s0s0j0j0s0a0f0a0e0s0k0j0q090l0r0l0f0p070k0g0r080m0g070f0p0a0k0r0k0g0s0s0k0m080g090q0d0p080g090e0j08070p0l0g0k0q0d0m0q070f0q080q0t0p0p070v0a02040201010 ecf6fb60b0a96af8
+game-3 010000000010010a001001aa001001a00010010a000000000be020e2000000000002000110000100e100011e0000001000000e0000000001000001010001002000000e1012e2000002000d1010010f0ced17810000000000 rgz91m3e1h1j4f1c3c3u0606564c464i16262s3g1a2m4n5x1r1f3q2f3j3e482g1l2g1g1m3k3w5h1j1j4l2l482q4l2p183w2b171j2o372m4d2f272a5y181p454g2s1q2h1j1s3g38171e1h1g5e2q2t2q1w4k2m1l2g1n3e284l2b283l0f0p0f0q0d0f0z0a070j090909070j0d0h0v0708070h0103000000050y04040s e4147d956fea726c
+)";
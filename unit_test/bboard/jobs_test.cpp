@@ -0,0 +1,176 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <chrono>
+
+#include "catch.hpp"
+#include "jobs.hpp"
+
+using namespace bboard;
+
+TEST_CASE("Job System", "[jobs]")
+{
+    JobSettings settings;
+    settings.workers = 3;
+    settings.spinCount = 16;
+    JobSystem jobs(settings);
+    REQUIRE(jobs.WorkerCount() == 3);
+    REQUIRE(jobs.CurrentWorker() == -1);
+
+    SECTION("Task Groups")
+    {
+        std::atomic<int> sum(0);
+        TaskGroup group;
+        for(int i = 1; i <= 1000; i++)
+        {
+            jobs.Run(group, [&sum, i]()
+            {
+                sum += i;
+            });
+        }
+        jobs.Wait(group);
+        REQUIRE(group.Done());
+        REQUIRE(sum == 500500);
+    }
+
+    SECTION("Parallel For")
+    {
+        std::vector<int> hits(10000, 0);
+        jobs.ParallelFor(int(hits.size()), [&hits](int i)
+        {
+            hits[size_t(i)]++;
+        });
+        for(int h : hits)
+        {
+            REQUIRE(h == 1);
+        }
+
+        // width 1 runs on the caller
+        std::thread::id caller = std::this_thread::get_id();
+        bool sameThread = true;
+        jobs.ParallelFor(100, 1, [&](int)
+        {
+            sameThread &= std::this_thread::get_id() == caller;
+        });
+        REQUIRE(sameThread);
+    }
+
+    SECTION("Nested Parallelism")
+    {
+        // every level waits for the next one, more jobs than workers
+        std::atomic<int> leaves(0);
+        jobs.ParallelFor(16, [&](int)
+        {
+            jobs.ParallelFor(16, [&](int)
+            {
+                jobs.ParallelFor(4, [&](int)
+                {
+                    leaves++;
+                });
+            });
+        });
+        REQUIRE(leaves == 16 * 16 * 4);
+    }
+
+    SECTION("Wake Up After Parking")
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        std::atomic<int> done(0);
+        std::atomic<bool> worker(false);
+        TaskGroup group;
+        jobs.Run(group, [&]()
+        {
+            worker = jobs.CurrentWorker() != -1;
+            done++;
+        });
+        // give the parked workers time before helping
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        jobs.Wait(group);
+        REQUIRE(done == 1);
+        REQUIRE(worker);
+    }
+
+    SECTION("Concurrent Submitters")
+    {
+        std::atomic<int> count(0);
+        std::vector<std::thread> submitters;
+        for(int t = 0; t < 4; t++)
+        {
+            submitters.emplace_back([&]()
+            {
+                TaskGroup group;
+                for(int i = 0; i < 500; i++)
+                {
+                    jobs.Run(group, [&count]()
+                    {
+                        count++;
+                    });
+                }
+                jobs.Wait(group);
+            });
+        }
+        for(std::thread& t : submitters)
+        {
+            t.join();
+        }
+        REQUIRE(count == 2000);
+    }
+
+    SECTION("Waiters Only Help Their Group")
+    {
+        // keep all workers busy
+        std::atomic<bool> release(false);
+        std::atomic<int> started(0);
+        TaskGroup blockers;
+        for(int i = 0; i < jobs.WorkerCount(); i++)
+        {
+            jobs.Run(blockers, [&]()
+            {
+                started++;
+                while(!release)
+                {
+                    std::this_thread::yield();
+                }
+            });
+        }
+        while(started < jobs.WorkerCount())
+        {
+            std::this_thread::yield();
+        }
+
+        std::atomic<bool> unrelated(false);
+        TaskGroup other;
+        jobs.Run(other, [&unrelated]()
+        {
+            unrelated = true;
+        });
+
+        std::atomic<int> count(0);
+        jobs.ParallelFor(8, [&count](int)
+        {
+            count++;
+        });
+        REQUIRE(count == 8);
+        REQUIRE(!unrelated);
+
+        release = true;
+        jobs.Wait(blockers);
+        jobs.Wait(other);
+        REQUIRE(unrelated);
+    }
+}
+
+TEST_CASE("Pinned Workers", "[jobs]")
+{
+    JobSettings settings;
+    settings.workers = 2;
+    settings.pinThreads = true;
+    JobSystem jobs(settings);
+
+    std::atomic<int> count(0);
+    jobs.ParallelFor(64, [&count](int)
+    {
+        count++;
+    });
+    REQUIRE(count == 64);
+}
@@ -0,0 +1,82 @@
+#include "catch.hpp"
+#include "bboard.hpp"
+#include "agents.hpp"
+#include "league.hpp"
+
+using namespace bboard;
+using namespace agents;
+
+TEST_CASE("Opponent Pool", "[league]")
+{
+    OpponentPool pool;
+    std::mt19937_64 rng(7);
+    REQUIRE(pool.Sample(rng) == -1);
+
+    auto lazy = [](uint64_t) { return std::unique_ptr<Agent>(new LazyAgent()); };
+    const int easy = pool.Add("easy", lazy);
+    const int hard = pool.Add("hard", lazy);
+    REQUIRE(pool.Size() == 2);
+    REQUIRE(pool.WinRate(easy) == 0.5f);
+
+    for(int i = 0; i < 100; i++)
+    {
+        pool.Report(easy, 1.0f);
+        pool.Report(hard, 0.0f);
+    }
+    REQUIRE(pool.WinRate(easy) > 0.9f);
+    REQUIRE(pool.WinRate(hard) < 0.1f);
+
+    SECTION("Hard Opponents First")
+    {
+        int sampled[2] = {};
+        for(int i = 0; i < 1000; i++)
+        {
+            sampled[pool.Sample(rng)]++;
+        }
+        REQUIRE(sampled[hard] > 900);
+        REQUIRE(sampled[easy] > 0);
+    }
+    SECTION("Uniform")
+    {
+        pool.weighting = PFSPWeighting::UNIFORM;
+        REQUIRE(pool.Weight(easy) == pool.Weight(hard));
+    }
+    SECTION("Even Opponents First")
+    {
+        pool.weighting = PFSPWeighting::VARIANCE;
+        const int even = pool.Add("even", lazy);
+        for(int i = 0; i < 100; i++)
+        {
+            pool.Report(even, 0.5f);
+        }
+        REQUIRE(pool.Weight(even) > pool.Weight(easy));
+        REQUIRE(pool.Weight(even) > pool.Weight(hard));
+    }
+}
+
+TEST_CASE("League Games", "[league]")
+{
+    OpponentPool pool;
+    pool.Add("simple", [](uint64_t seed)
+    {
+        return std::unique_ptr<Agent>(new SimpleAgent(seed));
+    });
+    pool.Add("lazy", [](uint64_t)
+    {
+        return std::unique_ptr<Agent>(new LazyAgent());
+    });
+
+    LeagueSettings settings;
+    settings.games = 8;
+    settings.threads = 4;
+    settings.maxSteps = 100;
+
+    const float score = RunLeague([](uint64_t seed)
+    {
+        return std::unique_ptr<Agent>(new SimpleAgent(seed));
+    }, pool, settings);
+
+    REQUIRE(score >= 0.0f);
+    REQUIRE(score <= 1.0f);
+    REQUIRE(pool[0].games + pool[1].games == settings.games * (AGENT_COUNT - 1));
+}
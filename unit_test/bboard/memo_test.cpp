@@ -0,0 +1,121 @@
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+#include "bboard.hpp"
+#include "agents.hpp"
+
+using namespace bboard;
+using namespace agents;
+
+/**
+ * @brief Counts its act calls, moves depend on the observation only
+ */
+struct CountingAgent : Agent
+{
+    int calls = 0;
+
+    Move act(const State* state) override
+    {
+        calls++;
+        return Move((state->agents[id].x + state->agents[id].y) % 5);
+    }
+};
+
+TEST_CASE("Memo Cache", "[memo]")
+{
+    MemoCache cache(1 << 12);
+    REQUIRE(cache.Capacity() == (1 << 12) / sizeof(MemoEntry));
+
+    Move m;
+    REQUIRE(!cache.Probe(42, m));
+    cache.Store(42, Move::BOMB);
+    REQUIRE(cache.Probe(42, m));
+    REQUIRE(m == Move::BOMB);
+    REQUIRE(!cache.Probe(43, m));
+
+    const float policy[ACTION_COUNT] = {0.1f, 0.2f, 0.0f, 0.3f, 0.4f, 0.0f};
+    cache.Store(7, Move::RIGHT, policy);
+    float p[ACTION_COUNT];
+    REQUIRE(cache.Probe(7, m, p));
+    REQUIRE(m == Move::RIGHT);
+    for(int a = 0; a < ACTION_COUNT; a++)
+    {
+        REQUIRE(p[a] == Approx(policy[a]).margin(0.005));
+    }
+
+    cache.Clear();
+    REQUIRE(!cache.Probe(7, m));
+
+    SECTION("Concurrent Access")
+    {
+        std::vector<std::thread> threads;
+        for(int t = 0; t < 4; t++)
+        {
+            threads.emplace_back([&cache]()
+            {
+                Move r;
+                for(int i = 0; i < 100000; i++)
+                {
+                    const uint64_t key = uint64_t(i % 1000) * 0x9E3779B97F4A7C15ULL;
+                    cache.Store(key, Move(i % 1000 % 6));
+                    if(cache.Probe(key, r) && r != Move(i % 1000 % 6))
+                    {
+                        FAIL("Inconsistent entry");
+                    }
+                }
+            });
+        }
+        for(std::thread& t : threads)
+        {
+            t.join();
+        }
+    }
+}
+
+TEST_CASE("Memo Agent", "[memo]")
+{
+    std::unique_ptr<State> s = std::make_unique<State>();
+    s->PutAgentsInCorners(0, 1, 2, 3);
+
+    SECTION("Stateless Agent")
+    {
+        CountingAgent inner;
+        MemoAgent memo(&inner);
+        memo.id = 3;
+
+        const Move m = memo.act(s.get());
+        REQUIRE(memo.act(s.get()) == m);
+        REQUIRE(memo.act(s.get()) == m);
+        REQUIRE(inner.calls == 1);
+        REQUIRE(memo.HitRate() == Approx(2.0f / 3));
+
+        // different observation
+        s->PutAgent(9, 10, 3);
+        memo.act(s.get());
+        REQUIRE(inner.calls == 2);
+
+        memo.Invalidate();
+        memo.act(s.get());
+        REQUIRE(inner.calls == 3);
+    }
+    SECTION("Stateful Agent")
+    {
+        SimpleAgent inner;
+        MemoAgent memo(&inner);
+        memo.id = 0;
+
+        // the recent positions are part of the key
+        const uint64_t before = inner.MemoKey();
+        const Move m = memo.act(s.get());
+        REQUIRE(inner.recentPositions.count == 1);
+        REQUIRE(inner.MemoKey() != before);
+
+        // replaying keeps the history going on hits
+        inner.recentPositions.count = 0;
+        inner.recentPositions.index = 0;
+        REQUIRE(memo.act(s.get()) == m);
+        REQUIRE(memo.hits == 1);
+        REQUIRE(inner.recentPositions.count == 1);
+    }
+}
@@ -0,0 +1,74 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+#include "catch.hpp"
+#include "bboard.hpp"
+#include "agents.hpp"
+#include "opening_book.hpp"
+
+using namespace bboard;
+using namespace agents;
+
+TEST_CASE("Opening Book", "[search]")
+{
+    const std::string path = "opening_book_test.bin";
+
+    std::unique_ptr<State> s = std::make_unique<State>();
+    InitState(s.get(), 0, 1, 2, 3);
+
+    BookSettings settings;
+    settings.games = 4;
+    settings.plies = 3;
+    settings.searchTime = 5;
+    settings.threads = 2;
+
+    OpeningBookBuilder builder;
+    GenerateOpeningBook(*s, settings, builder);
+    // at least the start position of every agent
+    REQUIRE(builder.entries.size() >= AGENT_COUNT);
+    REQUIRE(builder.Save(path));
+
+    OpeningBook book;
+    REQUIRE(book.Open(path));
+    REQUIRE(book.Size() == builder.entries.size());
+
+    SECTION("Lookup")
+    {
+        for(const auto& kv : builder.entries)
+        {
+            const BookEntry* e = book.Find(kv.first);
+            REQUIRE(e != nullptr);
+            REQUIRE(e->move == kv.second.move);
+        }
+        REQUIRE(book.Find(BookKey(*s, 0) + 1) == nullptr);
+    }
+    SECTION("Agent Skips Search")
+    {
+        const BookEntry* e = book.Find(BookKey(*s, 0));
+        REQUIRE(e != nullptr);
+
+        ISMCTSAgent a;
+        a.id = 0;
+        a.timeBudget = 50;
+        a.book = &book;
+
+        auto t1 = std::chrono::steady_clock::now();
+        Move m = a.act(s.get());
+        std::chrono::duration<double, std::milli> t = std::chrono::steady_clock::now() - t1;
+
+        REQUIRE(int(m) == e->move);
+        REQUIRE(a.lastIterations == 0);
+        REQUIRE(t.count() < 5);
+    }
+    SECTION("Invalid Files")
+    {
+        REQUIRE(!book.Open("does_not_exist.bin"));
+        REQUIRE(book.Size() == 0);
+
+        std::ofstream(path, std::ios::binary) << "not a book";
+        REQUIRE(!book.Open(path));
+    }
+
+    std::remove(path.c_str());
+}
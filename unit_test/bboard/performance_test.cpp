@@ -1,6 +1,7 @@
 #include <cmath>
-#include <thread>
 #include <chrono>
+#include <random>
+#include <vector>
 #include <utility>
 #include <iostream>
 
@@ -8,7 +9,17 @@
 #include "testing_utilities.hpp"
 
 #include "bboard.hpp"
+#include "jobs.hpp"
+#include "batch.hpp"
+#include "dataset.hpp"
+#include "generator.hpp"
+#include "belief.hpp"
+#include "trajectory.hpp"
+#include "serialization.hpp"
+#include "differential.hpp"
+#include "replay.hpp"
 #include "agents.hpp"
+#include "value_learner.hpp"
 #include "colors.hpp"
 
 using bboard::FixedQueue;
@@ -60,20 +71,12 @@ TEST_CASE("Step Function", "[performance]")
         }
         else
         {
-            std::vector<std::thread> threads(THREAD_COUNT);
-
             std::chrono::duration<double, std::milli> total;
             auto t1 = std::chrono::high_resolution_clock::now();
-            for(uint i = 0; i < THREAD_COUNT; i++)
+            bboard::Jobs().ParallelFor(int(THREAD_COUNT), int(THREAD_COUNT), [times](int)
             {
-                threads[i] = std::thread(ProxyConcurrent, times);
-            }
-
-            // join all
-            for(uint i = 0; i < THREAD_COUNT; i++)
-            {
-                threads[i].join();
-            }
+                ProxyConcurrent(times);
+            });
 
             total = std::chrono::high_resolution_clock::now() - t1;
             t += total.count();
@@ -96,3 +99,438 @@ TEST_CASE("Step Function", "[performance]")
 
     REQUIRE(1);
 }
+
+TEST_CASE("Belief State Update", "[performance]")
+{
+    agents::HarmlessAgent a[4];
+    bboard::Environment env;
+    env.MakeGame({&a[0], &a[1], &a[2], &a[3]});
+
+    std::unique_ptr<bboard::State> obs = std::make_unique<bboard::State>();
+    std::unique_ptr<bboard::BeliefState> b = std::make_unique<bboard::BeliefState>();
+    b->Reset(0);
+
+    int times = 100000;
+    double tStep = 0, tFog = 0, tBelief = 0;
+    for(int i = 0; i < times; i++)
+    {
+        if(env.IsDone() || env.GetState().agents[0].dead)
+        {
+            env.MakeGame({&a[0], &a[1], &a[2], &a[3]});
+            b->Reset(0);
+        }
+        auto t0 = std::chrono::high_resolution_clock::now();
+        env.Step();
+        auto t1 = std::chrono::high_resolution_clock::now();
+        bboard::FogState(env.GetState(), *obs, 0);
+        auto t2 = std::chrono::high_resolution_clock::now();
+        b->Update(*obs);
+        auto t3 = std::chrono::high_resolution_clock::now();
+
+        tStep += std::chrono::duration<double, std::milli>(t1 - t0).count();
+        tFog += std::chrono::duration<double, std::milli>(t2 - t1).count();
+        tBelief += std::chrono::duration<double, std::milli>(t3 - t2).count();
+    }
+
+    std::string tst = "Test Results:";
+    std::cout << std::endl
+              << FGRN(tst) << std::endl
+              << "Belief updates (100ms):          ";
+    RecursiveCommas(std::cout, uint(std::floor(times/(tBelief/100.0))));
+    std::cout << std::endl
+              << "Fogged observations (100ms):     ";
+    RecursiveCommas(std::cout, uint(std::floor(times/(tFog/100.0))));
+    std::cout << std::endl
+              << "Environment steps (100ms):       ";
+    RecursiveCommas(std::cout, uint(std::floor(times/(tStep/100.0))));
+    std::cout << std::endl << std::endl;
+
+    REQUIRE(1);
+}
+
+TEST_CASE("Trajectory Decoding", "[performance]")
+{
+    agents::RandomAgent a[4];
+    bboard::Environment env;
+    env.MakeGame({&a[0], &a[1], &a[2], &a[3]});
+
+    int times = 100000;
+    bboard::TrajectoryEncoder enc;
+    for(int i = 0; i < times; i++)
+    {
+        if(env.IsDone())
+        {
+            env.MakeGame({&a[0], &a[1], &a[2], &a[3]});
+        }
+        enc.Add(env.GetState());
+        env.Step();
+    }
+    enc.Flush();
+    const std::vector<uint8_t>& data = enc.Data();
+
+    std::unique_ptr<bboard::State> s = std::make_unique<bboard::State>();
+    std::chrono::duration<double, std::milli> total;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    bboard::TrajectoryDecoder dec(data.data(), data.size());
+    while(dec.Next(*s)) {}
+    total = std::chrono::high_resolution_clock::now() - t1;
+
+    std::string tst = "Test Results:";
+    std::cout << std::endl
+              << FGRN(tst) << std::endl
+              << "Decoded states (100ms):          ";
+    RecursiveCommas(std::cout, uint(std::floor(times/(total.count()/100.0))));
+    std::cout << std::endl
+              << "Bytes per state:                 "
+              << double(data.size()) / times << " (raw " << sizeof(bboard::State) << ")"
+              << std::endl << std::endl;
+
+    REQUIRE(1);
+}
+
+TEST_CASE("Serialization Throughput", "[performance]")
+{
+    std::unique_ptr<bboard::State> s = std::make_unique<bboard::State>();
+    std::unique_ptr<bboard::State> d = std::make_unique<bboard::State>();
+    bboard::InitState(s.get(), 0, 1, 2, 3);
+    s->PlantBomb(0, 0, 0, false);
+    s->SpawnFlame(5, 5, 2);
+
+    int times = 100000;
+    uint8_t buffer[bboard::MAX_SERIALIZED_SIZE];
+    size_t size = 0;
+
+    std::chrono::duration<double, std::milli> tEnc, tDec;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for(int i = 0; i < times; i++)
+    {
+        s->timeStep = i;
+        size = bboard::Serialize(*s, buffer);
+    }
+    tEnc = std::chrono::high_resolution_clock::now() - t1;
+    t1 = std::chrono::high_resolution_clock::now();
+    for(int i = 0; i < times; i++)
+    {
+        bboard::Deserialize(buffer, size, *d);
+    }
+    tDec = std::chrono::high_resolution_clock::now() - t1;
+
+    std::string tst = "Test Results:";
+    std::cout << std::endl
+              << FGRN(tst) << std::endl
+              << "Serialized states (100ms):       ";
+    RecursiveCommas(std::cout, uint(std::floor(times/(tEnc.count()/100.0))));
+    std::cout << std::endl
+              << "Deserialized states (100ms):     ";
+    RecursiveCommas(std::cout, uint(std::floor(times/(tDec.count()/100.0))));
+    std::cout << std::endl
+              << "Bytes per state:                 " << size
+              << std::endl << std::endl;
+
+    REQUIRE(1);
+}
+
+TEST_CASE("Value Learner Updates", "[performance]")
+{
+    std::vector<agents::ValueSample> samples;
+    agents::GenerateValueSamples(2, samples, 200);
+
+    const int epochs = 20;
+    for(int hidden : {0, 16})
+    {
+        agents::ValueLearner v(20, hidden);
+
+        auto t1 = std::chrono::high_resolution_clock::now();
+        v.Train(samples, epochs, THREAD_COUNT);
+        std::chrono::duration<double, std::milli> t = std::chrono::high_resolution_clock::now() - t1;
+
+        std::string tst = "Test Results:";
+        std::cout << std::endl
+                  << FGRN(tst) << std::endl
+                  << "Hidden units:                    " << hidden << std::endl
+                  << "Threads:                         " << THREAD_COUNT << std::endl
+                  << "Updates (100ms):                 ";
+        RecursiveCommas(std::cout, uint(std::floor(samples.size() * epochs / (t.count() / 100.0))));
+        std::cout << std::endl << std::endl;
+    }
+
+    REQUIRE(1);
+}
+
+TEST_CASE("Differential Check", "[performance]")
+{
+    bboard::DiffSettings settings;
+    settings.games = 5000;
+    settings.steps = 100;
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    bboard::DiffResult r = bboard::RunDifferential(settings);
+    std::chrono::duration<double, std::milli> t = std::chrono::high_resolution_clock::now() - t1;
+
+    std::string tst = "Test Results:";
+    std::cout << std::endl
+              << FGRN(tst) << std::endl
+              << "Checked steps:                   ";
+    RecursiveCommas(std::cout, uint(r.steps));
+    std::cout << std::endl
+              << "Checked steps (100ms):           ";
+    RecursiveCommas(std::cout, uint(std::floor(r.steps / (t.count() / 100.0))));
+    std::cout << std::endl << std::endl;
+
+    REQUIRE(!r.mismatch);
+}
+
+/**
+ * @brief EndgameSteps Returns the steps per 100ms of random games
+ * in which only the first n agents are alive
+ */
+double EndgameSteps(int alive)
+{
+    const int games = 256, steps = 100;
+    std::vector<bboard::State> initial(games);
+    for(int g = 0; g < games; g++)
+    {
+        bboard::InitState(&initial[size_t(g)], 0, 1, 2, 3, g);
+        for(int i = alive; i < bboard::AGENT_COUNT; i++)
+        {
+            const bboard::AgentInfo& a = initial[size_t(g)].agents[i];
+            initial[size_t(g)].board[a.y][a.x] = bboard::Item::PASSAGE;
+            initial[size_t(g)].Kill(i);
+        }
+    }
+
+    std::mt19937 rng(0);
+    std::vector<bboard::Move> moves(size_t(steps * bboard::AGENT_COUNT));
+    for(bboard::Move& m : moves)
+    {
+        m = bboard::Move(rng() % 6);
+    }
+
+    std::unique_ptr<bboard::State> s = std::make_unique<bboard::State>();
+    long count = 0;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for(int g = 0; g < games; g++)
+    {
+        *s = initial[size_t(g)];
+        for(int t = 0; t < steps && s->aliveAgents > 0; t++, count++)
+        {
+            bboard::Move m[bboard::AGENT_COUNT];
+            for(int i = 0; i < bboard::AGENT_COUNT; i++)
+            {
+                m[i] = s->agents[i].dead ? bboard::Move::IDLE : moves[size_t(t * bboard::AGENT_COUNT + i)];
+            }
+            bboard::Step(s.get(), m);
+        }
+    }
+    std::chrono::duration<double, std::milli> t = std::chrono::high_resolution_clock::now() - t1;
+    return count / (t.count() / 100.0);
+}
+
+TEST_CASE("Endgame Step Function", "[performance]")
+{
+    std::string tst = "Test Results:";
+    std::cout << std::endl
+              << FGRN(tst) << std::endl;
+    for(int alive = bboard::AGENT_COUNT; alive >= 1; alive--)
+    {
+        std::cout << alive << " alive, steps (100ms):         ";
+        RecursiveCommas(std::cout, uint(std::floor(EndgameSteps(alive))));
+        std::cout << std::endl;
+    }
+    std::cout << std::endl;
+
+    REQUIRE(1);
+}
+
+TEST_CASE("Golden Replay Steps", "[performance]")
+{
+    std::vector<bboard::Replay> corpus;
+    REQUIRE(bboard::ParseReplays(GOLDEN_REPLAYS, corpus));
+
+    std::unique_ptr<bboard::State> s = std::make_unique<bboard::State>();
+    const int rounds = 200;
+    long steps = 0;
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for(int i = 0; i < rounds; i++)
+    {
+        for(const bboard::Replay& r : corpus)
+        {
+            bboard::PlayReplay(r, *s);
+            steps += long(r.moves.size());
+        }
+    }
+    std::chrono::duration<double, std::milli> t = std::chrono::high_resolution_clock::now() - t1;
+
+    std::string tst = "Test Results:";
+    std::cout << std::endl
+              << FGRN(tst) << std::endl
+              << "Replays:                         " << corpus.size() << std::endl
+              << "Steps (100ms):                   ";
+    RecursiveCommas(std::cout, uint(std::floor(steps / (t.count() / 100.0))));
+    std::cout << std::endl << std::endl;
+
+    REQUIRE(steps > 0);
+}
+
+TEST_CASE("Batch Environment Steps", "[performance]")
+{
+    bboard::BatchSettings settings;
+    settings.size = 1024;
+    bboard::BatchEnvironment batch(settings);
+
+    std::vector<bboard::Move> moves(size_t(batch.Size() * bboard::AGENT_COUNT));
+    std::mt19937 rng(0);
+    for(bboard::Move& m : moves)
+    {
+        m = bboard::Move(rng() % 6);
+    }
+
+    const int rounds = 100;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for(int i = 0; i < rounds; i++)
+    {
+        batch.Step(moves.data());
+    }
+    std::chrono::duration<double, std::milli> t = std::chrono::high_resolution_clock::now() - t1;
+
+    std::string tst = "Test Results:";
+    std::cout << std::endl
+              << FGRN(tst) << std::endl
+              << "Games:                           " << batch.Size() << std::endl
+              << "Steps (100ms):                   ";
+    RecursiveCommas(std::cout, uint(std::floor(rounds * batch.Size() / (t.count() / 100.0))));
+    std::cout << std::endl;
+    bboard::PrintMemoryStats(std::cout);
+    std::cout << std::endl;
+
+    REQUIRE(batch[0].timeStep > 0);
+}
+
+TEST_CASE("Dataset Writer Throughput", "[performance]")
+{
+    bboard::DatasetSettings settings;
+    settings.prefix = "dataset_perf";
+    settings.sync = bboard::SyncPolicy::NONE;
+
+    std::unique_ptr<bboard::State> s = std::make_unique<bboard::State>();
+    bboard::InitState(s.get(), 0, 1, 2, 3);
+    const int threads = std::max(1, int(THREAD_COUNT));
+    const int records = 200000;
+
+    bboard::DatasetWriter writer(settings);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    bboard::Jobs().ParallelFor(threads, threads, [&](int)
+    {
+        for(int i = 0; i < records; i++)
+        {
+            writer.Append(*s);
+        }
+    });
+    std::chrono::duration<double, std::milli> append = std::chrono::high_resolution_clock::now() - t1;
+    REQUIRE(writer.Close());
+    std::chrono::duration<double, std::milli> total = std::chrono::high_resolution_clock::now() - t1;
+
+    const bboard::DatasetStats stats = writer.Stats();
+    for(const std::string& path : writer.Shards())
+    {
+        std::remove(path.c_str());
+    }
+
+    std::string tst = "Test Results:";
+    std::cout << std::endl
+              << FGRN(tst) << std::endl
+              << "Threads:                         " << threads << std::endl
+              << "Appended records (100ms):        ";
+    RecursiveCommas(std::cout, uint(std::floor(stats.records / (append.count() / 100.0))));
+    std::cout << std::endl
+              << "Written MB/s:                    "
+              << uint(stats.writtenBytes / (total.count() / 1000.0) / (1 << 20)) << std::endl
+              << "Write calls:                     " << stats.writes << std::endl
+              << "Stalls:                          " << stats.stalls << std::endl << std::endl;
+
+    REQUIRE(stats.records == size_t(threads * records));
+}
+
+TEST_CASE("Playground Agent Decisions", "[performance]")
+{
+    // observations of playground agent games
+    agents::PlaygroundAgent a[4] = {agents::PlaygroundAgent(1), agents::PlaygroundAgent(2),
+                                    agents::PlaygroundAgent(3), agents::PlaygroundAgent(4)};
+    std::vector<bboard::State> states;
+    bboard::Environment env;
+    for(int game = 0; states.size() < 2000; game++)
+    {
+        env.MakeGame({&a[0], &a[1], &a[2], &a[3]}, game);
+        while(!env.IsDone() && env.GetState().timeStep < 800)
+        {
+            states.push_back(env.GetState());
+            env.Step();
+        }
+    }
+
+    int decisions = 0;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for(int round = 0; round < 100; round++)
+    {
+        for(const bboard::State& s : states)
+        {
+            for(int i = 0; i < bboard::AGENT_COUNT; i++)
+            {
+                if(!s.agents[i].dead)
+                {
+                    a[i].act(&s);
+                    decisions++;
+                }
+            }
+        }
+    }
+    std::chrono::duration<double, std::milli> t = std::chrono::high_resolution_clock::now() - t1;
+
+    std::string tst = "Test Results:";
+    std::cout << std::endl
+              << FGRN(tst) << std::endl
+              << "Decisions (100ms):               ";
+    RecursiveCommas(std::cout, uint(std::floor(decisions / (t.count() / 100.0))));
+    std::cout << std::endl << std::endl;
+
+    REQUIRE(decisions > 0);
+}
+
+TEST_CASE("Board Generation", "[performance]")
+{
+    std::unique_ptr<bboard::State> s = std::make_unique<bboard::State>();
+    const int times = 100000;
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for(int i = 0; i < times; i++)
+    {
+        *s = bboard::State();
+        bboard::InitState(s.get(), 0, 1, 2, 3, i);
+    }
+    std::chrono::duration<double, std::milli> tInit = std::chrono::high_resolution_clock::now() - t1;
+
+    bboard::BoardParams params;
+    params.rigid = 0.4f;
+    params.clearance = 1;
+    params.symmetry = bboard::Symmetry::ROTATION;
+    t1 = std::chrono::high_resolution_clock::now();
+    for(int i = 0; i < times; i++)
+    {
+        *s = bboard::State();
+        bboard::GenerateBoard(*s, params, uint64_t(i));
+    }
+    std::chrono::duration<double, std::milli> tGenerate = std::chrono::high_resolution_clock::now() - t1;
+
+    std::string tst = "Test Results:";
+    std::cout << std::endl
+              << FGRN(tst) << std::endl
+              << "InitState boards (100ms):        ";
+    RecursiveCommas(std::cout, uint(std::floor(times / (tInit.count() / 100.0))));
+    std::cout << std::endl
+              << "Generated boards (100ms):        ";
+    RecursiveCommas(std::cout, uint(std::floor(times / (tGenerate.count() / 100.0))));
+    std::cout << std::endl << std::endl;
+
+    REQUIRE(s->aliveAgents == bboard::AGENT_COUNT);
+}
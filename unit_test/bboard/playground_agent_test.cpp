@@ -0,0 +1,90 @@
+#include <memory>
+
+#include "catch.hpp"
+#include "bboard.hpp"
+#include "agents.hpp"
+
+using namespace bboard;
+using namespace agents;
+
+TEST_CASE("Playground Agent", "[playground]")
+{
+    std::unique_ptr<State> s = std::make_unique<State>();
+    PlaygroundAgent a(42);
+    a.id = 0;
+    s->PutAgent(5, 5, 0);
+
+    SECTION("Flee From Own Bomb")
+    {
+        s->Kill(1, 2, 3);
+        s->PlantBomb(5, 5, 0);
+
+        // all directions are unsafe, the first one that does not
+        // lock us in wins (right)
+        REQUIRE(a.act(s.get()) == Move::RIGHT);
+    }
+    SECTION("Flee From Bomb")
+    {
+        s->Kill(1, 2, 3);
+        s->PlantBomb(7, 5, 0, true);
+        for(int i = 0; i < 20; i++)
+        {
+            const Move m = a.act(s.get());
+            REQUIRE((m == Move::UP || m == Move::DOWN || m == Move::LEFT));
+        }
+    }
+    SECTION("Bomb Adjacent Enemy")
+    {
+        s->PutAgent(6, 5, 1);
+        s->Kill(2, 3);
+        REQUIRE(a.act(s.get()) == Move::BOMB);
+
+        // no ammo left
+        s->agents[0].bombCount = s->agents[0].maxBombCount;
+        REQUIRE(a.act(s.get()) != Move::BOMB);
+    }
+    SECTION("Collect Powerup")
+    {
+        s->Kill(1, 2, 3);
+        s->PutItem(5, 7, Item::EXTRABOMB);
+        REQUIRE(a.act(s.get()) == Move::DOWN);
+    }
+    SECTION("Bomb Wood")
+    {
+        s->Kill(1, 2, 3);
+        s->PutItem(6, 5, Item::WOOD);
+        REQUIRE(a.act(s.get()) == Move::BOMB);
+
+        s->agents[0].bombCount = s->agents[0].maxBombCount;
+        REQUIRE(a.act(s.get()) == Move::IDLE);
+    }
+    SECTION("Wander")
+    {
+        s->Kill(1, 2, 3);
+        for(int i = 0; i < 20; i++)
+        {
+            const Move m = a.act(s.get());
+            REQUIRE(m != Move::IDLE);
+            REQUIRE(m != Move::BOMB);
+        }
+        REQUIRE(a.recentPositions.count == PLAYGROUND_HISTORY);
+    }
+}
+
+TEST_CASE("Playground Agent Games", "[playground]")
+{
+    PlaygroundAgent a[4] = {PlaygroundAgent(1), PlaygroundAgent(2), PlaygroundAgent(3), PlaygroundAgent(4)};
+
+    int bombs = 0;
+    for(int game = 0; game < 10; game++)
+    {
+        Environment env;
+        env.MakeGame({&a[0], &a[1], &a[2], &a[3]}, game);
+        while(!env.IsDone() && env.GetState().timeStep < 800)
+        {
+            env.Step();
+            bombs += env.GetState().bombs.count;
+        }
+    }
+    REQUIRE(bombs > 0);
+}
@@ -0,0 +1,210 @@
+#include <iostream>
+
+#include "catch.hpp"
+#include "bboard.hpp"
+#include "agents.hpp"
+#include "hash.hpp"
+#include "replay.hpp"
+#include "differential.hpp"
+#include "testing_utilities.hpp"
+
+using namespace bboard;
+
+/**
+ * @brief RecordReplay Plays the given moves from the initial state,
+ * then continues with simple agents until the game is over
+ */
+Replay RecordReplay(const std::string& name, const State& initial,
+                    const std::vector<MoveSet>& scripted, int maxSteps, uint64_t seed)
+{
+    Replay r;
+    r.name = name;
+    r.initial = initial;
+    r.moves = scripted;
+
+    std::unique_ptr<State> s = std::make_unique<State>();
+    PlayReplay(r, *s);
+
+    agents::SimpleAgent a[AGENT_COUNT] = {{seed}, {seed + 1}, {seed + 2}, {seed + 3}};
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        a[i].id = i;
+    }
+    while(int(r.moves.size()) < maxSteps && s->aliveAgents > 1)
+    {
+        MoveSet m;
+        for(int i = 0; i < AGENT_COUNT; i++)
+        {
+            m[i] = s->agents[i].dead ? Move::IDLE : a[i].act(s.get());
+        }
+        r.moves.push_back(m);
+        Step(s.get(), m.data());
+        s->timeStep++;
+    }
+    r.finalHash = HashState(*s);
+    return r;
+}
+
+/**
+ * @brief OuroborosState Agents in a 2x2 block in the middle
+ */
+void OuroborosState(State& s, int seed)
+{
+    s = State();
+    InitState(&s, 0, 1, 2, 3, seed);
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        s.board[s.agents[i].y][s.agents[i].x] = Item::PASSAGE;
+    }
+    for(int y = 3; y < 7; y++)
+    {
+        for(int x = 3; x < 7; x++)
+        {
+            s.board[y][x] = Item::PASSAGE;
+        }
+    }
+    s.PutAgent(4, 4, 0);
+    s.PutAgent(5, 4, 1);
+    s.PutAgent(5, 5, 2);
+    s.PutAgent(4, 5, 3);
+}
+
+// Generates the corpus in golden_replays.cpp. Only rerun this if
+// the rules change on purpose, the hashes pin the current behaviour.
+TEST_CASE("Generate Golden Replays", "[.generate]")
+{
+    std::vector<Replay> corpus;
+    std::unique_ptr<State> s = std::make_unique<State>();
+
+    // ouroboros (clockwise, counter-clockwise, covered bomb). The
+    // moves depend on the block corner, the agents rotate each step
+    const Move cw[AGENT_COUNT] = {Move::RIGHT, Move::DOWN, Move::LEFT, Move::UP};
+    const Move ccw[AGENT_COUNT] = {Move::DOWN, Move::LEFT, Move::UP, Move::RIGHT};
+    auto rotation = [](const Move corner[AGENT_COUNT], int steps, int direction)
+    {
+        std::vector<MoveSet> moves(steps);
+        for(int t = 0; t < steps; t++)
+        {
+            for(int i = 0; i < AGENT_COUNT; i++)
+            {
+                moves[t][i] = corner[(i + direction * t + 4 * steps) % AGENT_COUNT];
+            }
+        }
+        return moves;
+    };
+    OuroborosState(*s, 11);
+    corpus.push_back(RecordReplay("ouroboros-cw", *s, rotation(cw, 8, 1), 400, 1));
+    OuroborosState(*s, 12);
+    corpus.push_back(RecordReplay("ouroboros-ccw", *s, rotation(ccw, 6, -1), 400, 5));
+
+    std::vector<MoveSet> bombFirst = rotation(cw, 6, 1);
+    bombFirst.insert(bombFirst.begin(), {Move::BOMB, Move::IDLE, Move::IDLE, Move::IDLE});
+    OuroborosState(*s, 13);
+    corpus.push_back(RecordReplay("ouroboros-bomb", *s, bombFirst, 400, 9));
+
+    // search random positions and simple agent games for the rarer features
+    int chains = 0, deaths = 0, endgames = 0, games = 0;
+    std::mt19937_64 rng(90);
+    for(uint64_t seed = 0; seed < 2000 && (chains < 4 || deaths < 4 || endgames < 4 || games < 4); seed++)
+    {
+        if(seed % 2 == 0)
+        {
+            RandomDiffState(*s, rng);
+        }
+        else
+        {
+            *s = State();
+            InitState(s.get(), 0, 1, 2, 3, int(seed));
+        }
+        Replay r = RecordReplay("", *s, {}, 800, seed * 4);
+        const ReplayFeatures f = AnalyzeReplay(r);
+
+        std::string* name = &r.name;
+        if(chains < 4 && f.chainExplosions >= 2)
+        {
+            *name = "chain-" + std::to_string(chains++);
+        }
+        else if(deaths < 4 && f.simultaneousDeaths >= 1)
+        {
+            *name = "deaths-" + std::to_string(deaths++);
+        }
+        else if(endgames < 4 && f.endgameSteps >= 200)
+        {
+            *name = "endgame-" + std::to_string(endgames++);
+        }
+        else if(games < 4 && seed % 2 == 1 && r.moves.size() >= 100)
+        {
+            *name = "game-" + std::to_string(games++);
+        }
+        if(!name->empty())
+        {
+            corpus.push_back(r);
+        }
+    }
+
+    for(const Replay& r : corpus)
+    {
+        std::cout << FormatReplay(r) << std::endl;
+    }
+}
+
+TEST_CASE("Replay Format", "[replay]")
+{
+    std::mt19937_64 rng(3);
+    Replay r;
+    RandomDiffState(r.initial, rng);
+    r.name = "test";
+    for(int i = 0; i < 6 * 6 * 6 * 6; i++)
+    {
+        r.moves.push_back({Move(i % 6), Move(i / 6 % 6), Move(i / 36 % 6), Move(i / 216)});
+    }
+    r.finalHash = 0xDEADBEEF12345678ULL;
+
+    Replay p;
+    REQUIRE(ParseReplay(FormatReplay(r), p));
+    REQUIRE(p.name == r.name);
+    REQUIRE(p.moves == r.moves);
+    REQUIRE(p.finalHash == r.finalHash);
+    REQUIRE(HashState(p.initial) == HashState(r.initial));
+
+    REQUIRE(!ParseReplay("broken", p));
+    REQUIRE(!ParseReplay("test 00 zz 0", p));
+}
+
+TEST_CASE("Golden Replays", "[replay]")
+{
+    std::vector<Replay> corpus;
+    REQUIRE(ParseReplays(GOLDEN_REPLAYS, corpus));
+    REQUIRE(corpus.size() >= 15);
+
+    ReplayFeatures total;
+    std::unique_ptr<State> s = std::make_unique<State>();
+    for(const Replay& r : corpus)
+    {
+        INFO(r.name);
+        REQUIRE(PlayReplay(r, *s) == r.finalHash);
+
+        // the reference has to agree on every single step
+        DiffCase c;
+        c.initial = r.initial;
+        c.moves = r.moves;
+        DiffResult d = CheckCase(c, &Step);
+        if(d.mismatch)
+        {
+            PrintReproduction(d, std::cout);
+        }
+        REQUIRE(!d.mismatch);
+
+        const ReplayFeatures f = AnalyzeReplay(r);
+        total.chainExplosions += f.chainExplosions;
+        total.ouroboros += f.ouroboros;
+        total.simultaneousDeaths += f.simultaneousDeaths;
+        total.endgameSteps += f.endgameSteps;
+    }
+
+    // the corpus covers the tricky parts of the mechanics
+    REQUIRE(total.chainExplosions >= 8);
+    REQUIRE(total.ouroboros >= 10);
+    REQUIRE(total.simultaneousDeaths >= 4);
+    REQUIRE(total.endgameSteps >= 800);
+}
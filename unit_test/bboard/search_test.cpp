@@ -0,0 +1,227 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "catch.hpp"
+#include "bboard.hpp"
+#include "agents.hpp"
+
+using namespace bboard;
+
+TEST_CASE("ISMCTS Agent", "[search]")
+{
+    std::unique_ptr<State> s = std::make_unique<State>();
+    agents::ISMCTSAgent a;
+    a.id = 0;
+    a.timeBudget = 30;
+
+    SECTION("Flee From Bomb")
+    {
+        s->Kill(2, 3);
+        s->PutAgent(0, 5, 0);
+        s->PutAgent(10, 5, 1);
+        s->PutItem(0, 4, Item::RIGID);
+        s->PutItem(0, 6, Item::RIGID);
+        s->PutItem(1, 4, Item::RIGID);
+        s->PutItem(1, 6, Item::RIGID);
+        s->PlantBomb(0, 5, 0, false);
+        SetBombTime(s->bombs[0], 3);
+        s->timeStep = 1;
+
+        // the only escape is to the right
+        Move m = a.act(s.get());
+        REQUIRE(m == Move::RIGHT);
+        REQUIRE(a.lastIterations > 0);
+    }
+    SECTION("Respect Time Budget")
+    {
+        s->PutAgentsInCorners(0, 1, 2, 3);
+        a.threads = 2;
+
+        auto t1 = std::chrono::steady_clock::now();
+        a.act(s.get());
+        std::chrono::duration<double, std::milli> t = std::chrono::steady_clock::now() - t1;
+
+        REQUIRE(t.count() < a.timeBudget + 20);
+        REQUIRE(a.lastIterations > 0);
+    }
+}
+
+TEST_CASE("Node Arena Recycling", "[search]")
+{
+    agents::NodeArena arena;
+    arena.Init(8);
+
+    arena.root = arena.Allocate(0, 0);
+    const int a = agents::AddChild(arena, arena.root, 1, 1);
+    const int b = agents::AddChild(arena, arena.root, 2, 2);
+    for(int i = 0; i < 5; i++)
+    {
+        agents::AddChild(arena, i % 2 == 0 ? a : b, 0, 10 + i);
+    }
+    REQUIRE(arena.Live() == 8);
+    REQUIRE(agents::AddChild(arena, a, 0, 20) == -1);
+
+    SECTION("Reroot")
+    {
+        // a has 3 children
+        arena.Reroot(a);
+        REQUIRE(arena.Live() == 4);
+        REQUIRE(agents::FindChild(arena, a, 0, 10) != -1);
+        for(int i = 0; i < 4; i++)
+        {
+            REQUIRE(agents::AddChild(arena, a, 1, 30 + i) != -1);
+        }
+        REQUIRE(arena.Live() == 8);
+        REQUIRE(agents::AddChild(arena, a, 1, 40) == -1);
+    }
+    SECTION("Collect Least Recently Visited")
+    {
+        arena.generation += 10;
+        arena[arena.root].lastVisit = arena.generation;
+        arena[b].lastVisit = arena.generation;
+
+        // a (and its subtree) is cut off, b's children are too old
+        REQUIRE(arena.Collect() == 6);
+        REQUIRE(arena.Live() == 2);
+        REQUIRE(agents::FindChild(arena, arena.root, 1, 1) == -1);
+        REQUIRE(agents::FindChild(arena, arena.root, 2, 2) == b);
+        REQUIRE(arena[b].firstChild == -1);
+    }
+}
+
+TEST_CASE("ISMCTS Memory Bound", "[search]")
+{
+    std::unique_ptr<State> s = std::make_unique<State>();
+    s->PutAgentsInCorners(0, 1, 2, 3);
+
+    agents::ISMCTSAgent a;
+    a.id = 0;
+    a.timeBudget = 2;
+    a.memoryBudget = 1 << 16;
+
+    Move moves[AGENT_COUNT] = {};
+    a.act(s.get());
+    const int capacity = int(a.arenas[0].nodes.capacity());
+    REQUIRE(capacity == agents::NodeArena::CapacityFor(a.memoryBudget));
+
+    for(int t = 1; t < 100 && !s->agents[0].dead; t++)
+    {
+        moves[0] = a.act(s.get());
+        Step(s.get(), moves);
+        s->timeStep++;
+
+        REQUIRE(a.arenas[0].nodes.capacity() == size_t(capacity));
+        REQUIRE(a.arenas[0].Live() <= capacity);
+        REQUIRE(a.arenas[0].root != -1);
+    }
+}
+
+TEST_CASE("Time Manager", "[search]")
+{
+    std::unique_ptr<State> s = std::make_unique<State>();
+    s->PutAgentsInCorners(0, 1, 2, 3);
+
+    agents::TimeManager tm;
+    const float quiet = agents::TimeManager::Criticality(*s, 0);
+
+    SECTION("Criticality")
+    {
+        REQUIRE(quiet == 0.0f);
+
+        s->PlantBomb(0, 0, 0);
+        SetBombTime(s->bombs[0], 1);
+        REQUIRE(agents::TimeManager::Criticality(*s, 0) == 1.0f);
+
+        s->bombs.count = 0;
+        s->PutAgent(0, 2, 1);
+        const float close = agents::TimeManager::Criticality(*s, 0);
+        REQUIRE(close > quiet);
+        REQUIRE(close < 1.0f);
+
+        // the agents plan on their observation, hidden enemies
+        // do not count
+        s->PutAgent(6, 0, 1);
+        State obs;
+        FogState(*s, obs, 0);
+        REQUIRE(agents::TimeManager::Criticality(*s, 0) > quiet);
+        REQUIRE(agents::TimeManager::Criticality(obs, 0) == quiet);
+    }
+    SECTION("Plan")
+    {
+        agents::SearchBudget b = tm.Plan(*s, 0);
+        REQUIRE(b.iterations == tm.maxIterations);
+        REQUIRE(b.milliseconds <= tm.stepDeadline - tm.safetyMargin);
+
+        tm.Record(100, 10.0);
+        REQUIRE(tm.costPerIteration == Approx(0.1));
+        tm.Record(100, 20.0);
+        REQUIRE(tm.costPerIteration == Approx(0.12));
+
+        b = tm.Plan(*s, 0);
+        REQUIRE(b.iterations == Approx(b.milliseconds / 0.12).margin(10));
+
+        s->PutAgent(1, 0, 1);
+        const agents::SearchBudget critical = tm.Plan(*s, 0);
+        REQUIRE(critical.milliseconds > b.milliseconds);
+        REQUIRE(critical.iterations > b.iterations);
+    }
+    SECTION("Search Agent")
+    {
+        tm.stepDeadline = 40;
+        tm.safetyMargin = 10;
+
+        agents::ISMCTSAgent a;
+        a.id = 0;
+        a.timeManager = &tm;
+
+        for(int t = 0; t < 3; t++)
+        {
+            s->timeStep = t;
+            auto t1 = std::chrono::steady_clock::now();
+            a.act(s.get());
+            std::chrono::duration<double, std::milli> d = std::chrono::steady_clock::now() - t1;
+
+            REQUIRE(d.count() < tm.stepDeadline);
+        }
+        REQUIRE(tm.samples == 3);
+        REQUIRE(tm.costPerIteration > 0);
+    }
+}
+
+TEST_CASE("ISMCTS Pondering", "[search]")
+{
+    std::unique_ptr<State> s = std::make_unique<State>();
+    s->PutAgentsInCorners(0, 1, 2, 3);
+
+    agents::ISMCTSAgent a;
+    a.id = 0;
+    a.timeBudget = 10;
+    a.ponder = true;
+
+    Move moves[AGENT_COUNT] = {};
+    moves[0] = a.act(s.get());
+    REQUIRE(a.pondering);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    Step(s.get(), moves);
+    s->timeStep++;
+    a.act(s.get());
+
+    // the pondered subtree of the real observation was kept
+    REQUIRE(a.lastPonderIterations > 0);
+    const agents::Node& root = a.arenas[0][a.arenas[0].root];
+    REQUIRE(root.visits > a.lastIterations);
+
+    // waiting on the shared pool never runs into the background search
+    const auto start = std::chrono::steady_clock::now();
+    std::atomic<int> sum(0);
+    Jobs().ParallelFor(64, [&sum](int i) { sum += i; });
+    REQUIRE(sum == 64 * 63 / 2);
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+
+    a.StopPondering();
+    REQUIRE(!a.pondering);
+    a.StartPondering();
+    // the destructor stops the remaining background search
+}
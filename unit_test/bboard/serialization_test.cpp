@@ -0,0 +1,84 @@
+#include <vector>
+
+#include "catch.hpp"
+#include "bboard.hpp"
+#include "agents.hpp"
+#include "hash.hpp"
+#include "serialization.hpp"
+
+using namespace bboard;
+
+void REQUIRE_EQUAL_STATES(const State& a, const State& b)
+{
+    REQUIRE(a.timeStep == b.timeStep);
+    REQUIRE(a.aliveAgents == b.aliveAgents);
+    REQUIRE(a.aliveMask == b.aliveMask);
+    REQUIRE(HashState(a) == HashState(b));
+    for(int y = 0; y < BOARD_SIZE; y++)
+    {
+        for(int x = 0; x < BOARD_SIZE; x++)
+        {
+            REQUIRE(a.board[y][x] == b.board[y][x]);
+        }
+    }
+}
+
+TEST_CASE("State Serialization", "[serialization]")
+{
+    std::unique_ptr<State> s = std::make_unique<State>();
+    std::unique_ptr<State> d = std::make_unique<State>();
+
+    SECTION("Initial State")
+    {
+        InitState(s.get(), 0, 1, 2, 3);
+        std::vector<uint8_t> bytes = Serialize(*s);
+
+        REQUIRE(bytes.size() < 100);
+        REQUIRE(Deserialize(bytes.data(), bytes.size(), *d));
+        REQUIRE_EQUAL_STATES(*s, *d);
+        REQUIRE(Serialize(*d) == bytes);
+    }
+    SECTION("Canonical Queues")
+    {
+        s->PutAgentsInCorners(0, 1, 2, 3);
+        s->bombs.index = 7;
+        s->PlantBomb(5, 5, 0, true);
+        s->SpawnFlame(2, 2, 1);
+        s->board[7][7] = Item::WOOD + 3;
+        s->agents[1].maxBombCount = 20;
+        s->agents[2].x = s->agents[2].y = -1;
+
+        std::vector<uint8_t> bytes = Serialize(*s);
+        REQUIRE(Deserialize(bytes.data(), bytes.size(), *d));
+        REQUIRE_EQUAL_STATES(*s, *d);
+        REQUIRE(d->bombs.index == 0);
+        REQUIRE(d->bombs[0] == s->bombs[0]);
+        REQUIRE(d->flames.count == 1);
+        REQUIRE(d->agents[1].maxBombCount == 20);
+        REQUIRE(d->agents[2].x == -1);
+        REQUIRE(Serialize(*d) == bytes);
+    }
+    SECTION("Whole Games")
+    {
+        agents::RandomAgent a[4];
+        Environment env;
+        env.MakeGame({&a[0], &a[1], &a[2], &a[3]});
+        for(int i = 0; i < 200 && !env.IsDone(); i++)
+        {
+            std::vector<uint8_t> bytes = Serialize(env.GetState());
+            REQUIRE(Deserialize(bytes.data(), bytes.size(), *d));
+            REQUIRE(HashState(env.GetState()) == HashState(*d));
+            REQUIRE(Serialize(*d) == bytes);
+            env.Step();
+        }
+    }
+    SECTION("Reject Invalid Data")
+    {
+        InitState(s.get(), 0, 1, 2, 3);
+        std::vector<uint8_t> bytes = Serialize(*s);
+
+        REQUIRE(!Deserialize(bytes.data(), bytes.size() - 1, *d));
+        bytes[0] = STATE_FORMAT_VERSION + 1;
+        REQUIRE(!Deserialize(bytes.data(), bytes.size(), *d));
+    }
+}
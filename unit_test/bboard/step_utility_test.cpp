@@ -60,6 +60,58 @@ TEST_CASE("Destination position filling", "[step utilities]")
     REQUIRE_POS(destPos, 3, 3, -1);
 }
 
+TEST_CASE("Cell Tables", "[step utilities]")
+{
+    using namespace bboard;
+
+    for(int y = 0; y < BOARD_SIZE; y++)
+    {
+        for(int x = 0; x < BOARD_SIZE; x++)
+        {
+            const Cell c = ToCell(x, y);
+            REQUIRE(CellX(c) == x);
+            REQUIRE(CellY(c) == y);
+            REQUIRE(ToCell(ToPosition(c)) == c);
+            REQUIRE(BMB_CELL(x + (y << 4)) == c);
+
+            for(int m = 0; m <= int(Move::BOMB); m++)
+            {
+                const Position p = util::DesiredPosition(x, y, Move(m));
+                REQUIRE(Neighbor(c, Move(m)) == ToCell(p));
+            }
+        }
+    }
+    REQUIRE(ToCell(Position{-1, 3}) == NO_CELL);
+    REQUIRE(ToCell(Position{3, BOARD_SIZE}) == NO_CELL);
+
+    // same results as the position based functions
+    std::unique_ptr<State> s = std::make_unique<State>();
+    s->PutAgent(0, 0, 0);
+    s->PutAgent(1, 0, 1);
+    s->PutAgent(2, 0, 2);
+    s->PutAgent(3, 0, 3);
+    Move m[AGENT_COUNT] = {Move::RIGHT, Move::LEFT, Move::RIGHT, Move::UP};
+
+    Position destPos[AGENT_COUNT];
+    Cell destCells[AGENT_COUNT];
+    util::FillDestPos(s.get(), m, destPos);
+    util::FillDestCells(s.get(), m, destCells);
+    util::FixSwitchMove(s.get(), destPos);
+    util::FixSwitchMove(s.get(), destCells);
+
+    int dependency[2][AGENT_COUNT] = {{-1, -1, -1, -1}, {-1, -1, -1, -1}};
+    int roots[2][AGENT_COUNT] = {{-1, -1, -1, -1}, {-1, -1, -1, -1}};
+    REQUIRE(util::ResolveDependencies(s.get(), destPos, dependency[0], roots[0])
+            == util::ResolveDependencies(s.get(), destCells, dependency[1], roots[1]));
+    for(int i = 0; i < AGENT_COUNT; i++)
+    {
+        REQUIRE(ToCell(destPos[i]) == destCells[i]);
+        REQUIRE(dependency[0][i] == dependency[1][i]);
+        REQUIRE(roots[0][i] == roots[1][i]);
+        REQUIRE(util::HasDPCollision(*s, destPos, i) == util::HasDPCollision(*s, destCells, i));
+    }
+}
+
 TEST_CASE("Fix Switch Position", "[step utilities]")
 {
     std::unique_ptr<bboard::State> sx = std::make_unique<bboard::State>();
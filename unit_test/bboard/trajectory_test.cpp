@@ -0,0 +1,160 @@
+#include <random>
+#include <vector>
+#include <cstring>
+
+#include "catch.hpp"
+#include "bboard.hpp"
+#include "agents.hpp"
+#include "trajectory.hpp"
+
+using namespace bboard;
+
+/**
+ * @brief RecordGame Plays a game with random agents and returns
+ * all visited states
+ */
+std::vector<State> RecordGame(int steps)
+{
+    agents::RandomAgent a[4];
+    Environment env;
+    env.MakeGame({&a[0], &a[1], &a[2], &a[3]});
+
+    std::vector<State> states;
+    for(int i = 0; i < steps; i++)
+    {
+        states.push_back(env.GetState());
+        if(env.IsDone())
+        {
+            env.MakeGame({&a[0], &a[1], &a[2], &a[3]});
+            continue;
+        }
+        env.Step();
+    }
+    return states;
+}
+
+TEST_CASE("Trajectory Codec", "[trajectory]")
+{
+    std::vector<State> states = RecordGame(1500);
+
+    TrajectoryEncoder enc(256);
+    for(const State& s : states)
+    {
+        enc.Add(s);
+    }
+    enc.Flush();
+
+    const std::vector<uint8_t>& data = enc.Data();
+    REQUIRE(data.size() * 20 < states.size() * sizeof(State));
+
+    std::unique_ptr<State> s = std::make_unique<State>();
+    TrajectoryDecoder dec(data.data(), data.size());
+    for(const State& expected : states)
+    {
+        REQUIRE(dec.Next(*s));
+        REQUIRE(std::memcmp(&expected, s.get(), sizeof(State)) == 0);
+    }
+    REQUIRE(!dec.Next(*s));
+
+    SECTION("Reject Invalid Data")
+    {
+        uint8_t garbage[16] = {};
+        TrajectoryDecoder invalid(garbage, sizeof(garbage));
+        REQUIRE(!invalid.Next(*s));
+    }
+    SECTION("Reject Corrupted Frequencies")
+    {
+        // changes the frequency of symbol 0, the table does not
+        // sum up anymore
+        std::vector<uint8_t> corrupted = data;
+        corrupted[5 + 12] ^= 0x01;
+        TrajectoryDecoder invalid(corrupted.data(), corrupted.size());
+        REQUIRE(!invalid.Next(*s));
+    }
+    SECTION("Reject Corrupted Header")
+    {
+        const uint32_t huge = 0xFFFFFFFF;
+        for(int field = 0; field < 3; field++)
+        {
+            std::vector<uint8_t> corrupted = data;
+            std::memcpy(corrupted.data() + 5 + 4 * field, &huge, 4);
+            TrajectoryDecoder invalid(corrupted.data(), corrupted.size());
+            REQUIRE(!invalid.Next(*s));
+        }
+    }
+    SECTION("Reject Invalid States")
+    {
+        // well-formed chunks that decode to unusable states
+        for(int k = 0; k < 5; k++)
+        {
+            std::unique_ptr<State> bad = std::make_unique<State>(states[100]);
+            switch(k)
+            {
+                case 0: bad->bombs.count = MAX_BOMBS + 1; break;
+                case 1: bad->flames.index = -1; break;
+                case 2: bad->agents[1].x = BOARD_SIZE; break;
+                case 3: bad->board[3][4] = 12345; break;
+                default: bad->board.cells[0] = Item::PASSAGE; break;
+            }
+
+            TrajectoryEncoder badEnc(4);
+            badEnc.Add(states[100]);
+            badEnc.Add(*bad);
+            badEnc.Flush();
+            TrajectoryDecoder badDec(badEnc.Data().data(), badEnc.Data().size());
+            REQUIRE(badDec.Next(*s));
+            REQUIRE(!badDec.Next(*s));
+            REQUIRE(!badDec.Next(*s));
+
+            // as a keyframe
+            TrajectoryEncoder keyEnc(4);
+            keyEnc.Add(*bad);
+            keyEnc.Flush();
+            TrajectoryDecoder keyDec(keyEnc.Data().data(), keyEnc.Data().size());
+            REQUIRE(!keyDec.Next(*s));
+        }
+    }
+    SECTION("Truncated Data")
+    {
+        for(size_t cut = 5; cut < data.size(); cut += data.size() / 97)
+        {
+            TrajectoryDecoder truncated(data.data(), cut);
+            size_t count = 0;
+            while(truncated.Next(*s))
+            {
+                REQUIRE(count < states.size());
+                REQUIRE(std::memcmp(&states[count], s.get(), sizeof(State)) == 0);
+                count++;
+            }
+            // only complete chunks are decoded
+            REQUIRE(count % 256 == 0);
+        }
+
+        TrajectoryDecoder truncated(data.data(), data.size() - 1);
+        size_t count = 0;
+        while(truncated.Next(*s))
+        {
+            count++;
+        }
+        REQUIRE(count == states.size() / 256 * 256);
+    }
+    SECTION("Corrupted Data")
+    {
+        std::mt19937 rng(7);
+        for(int i = 0; i < 50; i++)
+        {
+            std::vector<uint8_t> corrupted = data;
+            for(int k = 0; k < 4; k++)
+            {
+                corrupted[5 + rng() % (corrupted.size() - 5)] ^= uint8_t(1 + rng() % 255);
+            }
+            TrajectoryDecoder decoder(corrupted.data(), corrupted.size());
+            size_t count = 0;
+            while(decoder.Next(*s) && count <= states.size())
+            {
+                count++;
+            }
+            REQUIRE(count <= states.size());
+        }
+    }
+}
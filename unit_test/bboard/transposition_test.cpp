@@ -0,0 +1,106 @@
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+#include "bboard.hpp"
+#include "agents.hpp"
+#include "transposition.hpp"
+
+using namespace agents;
+
+TEST_CASE("Transposition Table", "[search]")
+{
+    TranspositionTable table(1 << 20);
+    REQUIRE(table.Capacity() == (1 << 20) / 64 * TT_CLUSTER_SIZE);
+
+    TTData d;
+    SECTION("Store And Probe")
+    {
+        REQUIRE(!table.Probe(0x1337, d));
+
+        d.visits = 100;
+        d.value = -0.5f;
+        d.move = 5;
+        d.depth = 3;
+        table.Store(0x1337, d);
+
+        TTData r;
+        REQUIRE(table.Probe(0x1337, r));
+        REQUIRE(r.visits == 100);
+        REQUIRE(r.value == Approx(-0.5f).epsilon(0.001));
+        REQUIRE(r.move == 5);
+        REQUIRE(r.depth == 3);
+        REQUIRE(!table.Probe(0x1338, r));
+
+        table.Clear();
+        REQUIRE(!table.Probe(0x1337, r));
+    }
+    SECTION("Replace Old And Rarely Visited")
+    {
+        const uint64_t stride = table.Capacity() / TT_CLUSTER_SIZE;
+        for(int i = 0; i < TT_CLUSTER_SIZE; i++)
+        {
+            d.visits = 10 + i;
+            table.Store(7 + i * stride, d);
+        }
+        // same cluster, the entry with 10 visits has to go
+        d.visits = 1;
+        table.Store(7 + TT_CLUSTER_SIZE * stride, d);
+        REQUIRE(!table.Probe(7, d));
+        REQUIRE(table.Probe(7 + stride, d));
+
+        // entries of older searches are replaced first
+        table.NewSearch();
+        d.visits = 1;
+        table.Store(7 + stride, d);
+        table.Store(7 + (TT_CLUSTER_SIZE + 1) * stride, d);
+        REQUIRE(table.Probe(7 + stride, d));
+        REQUIRE(table.Probe(7 + (TT_CLUSTER_SIZE + 1) * stride, d));
+    }
+    SECTION("Concurrent Access")
+    {
+        std::vector<std::thread> threads;
+        for(int t = 0; t < 4; t++)
+        {
+            threads.emplace_back([&table, t]()
+            {
+                TTData w, r;
+                for(int i = 0; i < 100000; i++)
+                {
+                    const uint64_t key = uint64_t(i % 4096) * 0x9E3779B97F4A7C15ULL;
+                    w.visits = i % 4096;
+                    w.move = t;
+                    table.Store(key, w);
+                    // never returns data that belongs to another key
+                    if(table.Probe(key, r) && r.visits != int(i % 4096))
+                    {
+                        FAIL("Inconsistent entry");
+                    }
+                }
+            });
+        }
+        for(std::thread& t : threads)
+        {
+            t.join();
+        }
+        REQUIRE(table.Usage() > 0);
+    }
+}
+
+TEST_CASE("ISMCTS With Shared Table", "[search]")
+{
+    std::unique_ptr<bboard::State> s = std::make_unique<bboard::State>();
+    s->PutAgentsInCorners(0, 1, 2, 3);
+
+    TranspositionTable table(1 << 22);
+    ISMCTSAgent a;
+    a.id = 0;
+    a.threads = 2;
+    a.timeBudget = 20;
+    a.table = &table;
+    a.act(s.get());
+
+    TTData d;
+    REQUIRE(table.Probe(a.historyKey, d));
+    REQUIRE(d.visits > 0);
+}
@@ -0,0 +1,105 @@
+#include <cstdio>
+
+#include "catch.hpp"
+#include "bboard.hpp"
+#include "agents.hpp"
+#include "hash.hpp"
+#include "tuner.hpp"
+
+using namespace bboard;
+using namespace agents;
+
+TEST_CASE("Simple Agent Parameters", "[tuning]")
+{
+    SimpleAgentParams p;
+    float v[SimpleAgentParams::COUNT];
+    p.ToVector(v);
+
+    SimpleAgentParams q;
+    q.chaseRadius = 0;
+    q.FromVector(v);
+    REQUIRE(q.bombEnemyDistance == 2);
+    REQUIRE(q.bombWoodDistance == 1);
+    REQUIRE(q.chaseRadius == 7);
+    REQUIRE(q.moveChoices == 2);
+    REQUIRE(q.historyLength == 4);
+
+    // out of range values are clamped
+    for(float& x : v) x = 2.0f;
+    q.FromVector(v);
+    REQUIRE(q.moveChoices == MOVE_COUNT);
+    REQUIRE(q.historyLength == SIMPLE_MAX_HISTORY);
+
+    // short history
+    std::unique_ptr<State> s = std::make_unique<State>();
+    s->PutAgentsInCorners(0, 1, 2, 3);
+    SimpleAgent a(42);
+    a.id = 0;
+    a.params.historyLength = 1;
+    a.act(s.get());
+    a.act(s.get());
+    REQUIRE(a.recentPositions.count == 1);
+}
+
+TEST_CASE("Seeded Games", "[tuning]")
+{
+    SimpleAgentParams p;
+    for(int seed = 0; seed < 4; seed++)
+    {
+        REQUIRE(PlaySimpleAgentGame(p, seed, 200) == PlaySimpleAgentGame(p, seed, 200));
+    }
+
+    std::unique_ptr<State> a = std::make_unique<State>();
+    std::unique_ptr<State> b = std::make_unique<State>();
+    InitState(a.get(), 0, 1, 2, 3, 1);
+    InitState(b.get(), 0, 1, 2, 3, 2);
+    REQUIRE(HashState(*a) != HashState(*b));
+}
+
+TEST_CASE("ES Tuner", "[tuning]")
+{
+    const std::string path = "tuner_test.txt";
+
+    // noisy quadratic with the optimum at 0.7
+    GameFitness f = [](const std::vector<float>& x, int seed)
+    {
+        float r = -0.01f * float(seed % 7);
+        for(float v : x)
+        {
+            r -= (v - 0.7f) * (v - 0.7f);
+        }
+        return r;
+    };
+
+    TunerSettings settings;
+    settings.population = 16;
+    settings.games = 4;
+    settings.sigma = 0.1f;
+    settings.learningRate = 1.0f;
+    settings.threads = 4;
+    settings.checkpoint = path;
+
+    ESTuner tuner(std::vector<float>(3, 0.2f), settings, f);
+    for(int g = 0; g < 60; g++)
+    {
+        tuner.Step();
+    }
+    for(float v : tuner.mean)
+    {
+        REQUIRE(v == Approx(0.7f).margin(0.1));
+    }
+    REQUIRE(tuner.bestFitness > -0.1f);
+
+    // continue from the checkpoint
+    ESTuner resumed(std::vector<float>(3, 0.0f), settings, f);
+    REQUIRE(resumed.Load(path));
+    REQUIRE(resumed.generation == 60);
+    for(int d = 0; d < 3; d++)
+    {
+        REQUIRE(resumed.mean[d] == Approx(tuner.mean[d]).margin(1e-4));
+    }
+
+    ESTuner other(std::vector<float>(2, 0.0f), settings, f);
+    REQUIRE(!other.Load(path));
+    std::remove(path.c_str());
+}
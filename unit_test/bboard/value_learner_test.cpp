@@ -0,0 +1,103 @@
+#include <algorithm>
+
+#include "catch.hpp"
+#include "bboard.hpp"
+#include "agents.hpp"
+#include "value_learner.hpp"
+
+using namespace bboard;
+using namespace agents;
+
+TEST_CASE("Feature Extraction", "[learning]")
+{
+    std::unique_ptr<State> s = std::make_unique<State>();
+    InitState(s.get(), 0, 1, 2, 3);
+
+    FeatureVector f, g;
+    ExtractFeatures(*s, 0, f);
+    ExtractFeatures(*s, 0, g);
+    REQUIRE(f.count > 25);
+    REQUIRE(f.count <= MAX_FEATURES);
+    REQUIRE(std::equal(f.index, f.index + f.count, g.index));
+
+    // a bomb changes the danger feature
+    s->PlantBomb(0, 0, 0);
+    ExtractFeatures(*s, 0, g);
+    REQUIRE(!std::equal(f.index, f.index + f.count, g.index));
+
+    s->Kill(0);
+    ExtractFeatures(*s, 0, g);
+    REQUIRE(g.count == 2);
+}
+
+TEST_CASE("Value Learner", "[learning]")
+{
+    std::unique_ptr<State> s = std::make_unique<State>();
+    s->PutAgentsInCorners(0, 1, 2, 3);
+
+    // safe positions are good, positions next to a bomb are bad
+    std::vector<ValueSample> samples;
+    for(int x = 2; x < 9; x++)
+    {
+        ValueSample sample;
+        s->PutAgent(x, 5, 0);
+        ExtractFeatures(*s, 0, sample.features);
+        sample.target = 0.8f;
+        samples.push_back(sample);
+
+        s->PlantBomb(x, 4, 1, true);
+        SetBombTime(s->bombs[0], 1);
+        ExtractFeatures(*s, 0, sample.features);
+        sample.target = -0.8f;
+        samples.push_back(sample);
+        s->board[4][x] = Item::PASSAGE;
+        s->bombs.count = 0;
+        s->agents[1].bombCount = 0;
+    }
+
+    for(int hidden : {0, 16})
+    {
+        ValueLearner v(16, hidden, 0.2f);
+        const float before = v.Train(samples, 1, 1);
+        const float after = v.Train(samples, 50, 4);
+        REQUIRE(after < before);
+        REQUIRE(after < 0.05f);
+
+        s->PutAgent(5, 5, 0);
+        REQUIRE(v.Evaluate(*s, 0) > 0.5f);
+        s->PlantBomb(5, 4, 1, true);
+        SetBombTime(s->bombs[0], 1);
+        REQUIRE(v.Evaluate(*s, 0) < -0.5f);
+        s->board[4][5] = Item::PASSAGE;
+        s->bombs.count = 0;
+        s->agents[1].bombCount = 0;
+    }
+}
+
+TEST_CASE("Value Samples", "[learning]")
+{
+    std::vector<ValueSample> samples;
+    GenerateValueSamples(1, samples, 50);
+    REQUIRE(samples.size() >= 50);
+    for(const ValueSample& s : samples)
+    {
+        REQUIRE(s.target >= -1.0f);
+        REQUIRE(s.target <= 1.0f);
+        REQUIRE(s.features.count > 0);
+    }
+    // reproducible, different seeds play different games
+    auto equal = [](const std::vector<ValueSample>& a, const std::vector<ValueSample>& b)
+    {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(),
+                [](const ValueSample& x, const ValueSample& y)
+        {
+            return x.target == y.target && x.features.count == y.features.count
+                    && std::equal(x.features.index, x.features.index + x.features.count, y.features.index);
+        });
+    };
+    std::vector<ValueSample> same, other;
+    GenerateValueSamples(1, same, 50);
+    GenerateValueSamples(1, other, 50, 7);
+    REQUIRE(equal(samples, same));
+    REQUIRE(!equal(samples, other));
+}
@@ -49,4 +49,10 @@ type_name()
 #endif
 }
 
+/**
+ * @brief GOLDEN_REPLAYS The checked-in replay corpus (see replay.hpp
+ * for the format and golden_replays.cpp for the data)
+ */
+extern const char* const GOLDEN_REPLAYS;
+
 #endif // TESTING_UTILITIES_HPP